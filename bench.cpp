@@ -0,0 +1,281 @@
+/**
+ * @file bench.cpp
+ * @author Yiding Li
+ * @brief Benchmarks of every Int operation over operand sizes from 64 bits to millions of bits, with
+ *      random and adversarial inputs. Reports ns/op, allocations/op and bytes/op as CSV or JSON.
+ * @version 0.1
+ * @date 2023-12-28
+ *
+ * Build with   g++ -std=c++20 -O2 bench.cpp -o bench
+ * Run as       ./bench [--json] [--max-bits N] [--min-time SECONDS] [--filter OP]
+ *
+ * Exits with status 1 if a 64-bit row of an operation in ALLOCATION_FREE_OPS allocated.
+ */
+#include "bigint.hpp"
+#include "test_support.hpp"
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <set>
+
+/**
+ * @brief A stream buffer that drops what is written to it, so that operator<< can be measured without
+ *      the allocations of a string stream.
+ */
+class NullBuffer : public std::streambuf
+{
+protected:
+    int overflow(int a_chr) override { return a_chr; }
+    std::streamsize xsputn(const char *, std::streamsize a_len) override { return a_len; }
+};
+
+/**
+ * @brief Operations that must not touch the heap on word-sized operands. to_str is not among them, as its
+ *      result is longer than the buffer inside a string.
+ */
+const std::set<string> ALLOCATION_FREE_OPS = {"copy", "compare", "add", "sub", "mul",
+                                              "div", "parse", "write_decimal", "operator<<"};
+
+/**
+ * @brief Options from the command line.
+ */
+struct BenchOptions
+{
+    bool json = false;
+    size_t max_bits = 1 << 22;
+    double min_time = 0.2;
+    string filter;
+};
+
+/**
+ * @brief One measured row of the report.
+ */
+struct BenchResult
+{
+    string op;
+    string input;
+    size_t bits;
+    double ns_per_op;
+    double allocs_per_op;
+    double bytes_per_op;
+    size_t iterations;
+};
+
+/**
+ * @brief Run an operation repeatedly until one round takes at least a_min_time seconds, growing the
+ *      number of iterations between rounds. One untimed call first warms the caches and scratch buffers.
+ *
+ * @param a_op The name of the operation
+ * @param a_input The name of the input kind
+ * @param a_bits The operand size in bits
+ * @param a_min_time The shortest time to measure, in seconds
+ * @param a_body The operation
+ * @return The measurement
+ */
+BenchResult measure(const string &a_op, const string &a_input, size_t a_bits, double a_min_time,
+                    const std::function<void()> &a_body)
+{
+    a_body();
+    size_t iterations = 1;
+    while (true)
+    {
+        size_t allocs = g_allocs;
+        size_t bytes = g_alloc_bytes;
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < iterations; i++)
+        {
+            a_body();
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (seconds >= a_min_time || iterations >= ((size_t)1 << 30))
+        {
+            return {a_op, a_input, a_bits, seconds * 1e9 / iterations,
+                    (double)(g_allocs - allocs) / iterations, (double)(g_alloc_bytes - bytes) / iterations,
+                    iterations};
+        }
+        // Aim a little past the minimum time, so that most sizes take two or three rounds.
+        double scale = seconds > 0 ? a_min_time * 1.2 / seconds : 16;
+        iterations = (size_t)(iterations * std::min(16.0, std::max(2.0, scale)));
+    }
+}
+
+/**
+ * @brief Make an operand of the given size.
+ *
+ * @param a_rng The random generator
+ * @param a_bits The number of bits, a multiple of 64
+ * @param a_input "random" for random limbs with the top bit set, "ones" for all bits set, which makes
+ *      every carry and borrow run the full length, or "sparse" for 2^(bits - 1) + 1
+ * @return The operand
+ */
+Int make_bench_operand(std::mt19937_64 &a_rng, size_t a_bits, const string &a_input)
+{
+    if (a_input == "sparse")
+    {
+        vector<limb_t> limbs(a_bits / LIMB_BITS, 0);
+        limbs.front() = 1;
+        limbs.back() |= (limb_t)1 << (LIMB_BITS - 1);
+        return Int::from_limbs(true, limbs);
+    }
+    return make_operand(a_rng, a_bits / LIMB_BITS, a_input == "ones");
+}
+
+/**
+ * @brief Parse the command line.
+ *
+ * @param a_argc The number of arguments
+ * @param a_argv The arguments
+ * @return The options
+ * @throw domain_error on an unknown argument
+ */
+BenchOptions parse_options(int a_argc, char **a_argv)
+{
+    BenchOptions options;
+    for (int i = 1; i < a_argc; i++)
+    {
+        string arg = a_argv[i];
+        bool has_value = i + 1 < a_argc;
+        if (arg == "--json")
+        {
+            options.json = true;
+        }
+        else if (arg == "--max-bits" && has_value)
+        {
+            options.max_bits = std::stoull(a_argv[++i]);
+        }
+        else if (arg == "--min-time" && has_value)
+        {
+            options.min_time = std::stod(a_argv[++i]);
+        }
+        else if (arg == "--filter" && has_value)
+        {
+            options.filter = a_argv[++i];
+        }
+        else
+        {
+            throw domain_error("Unknown argument " + arg +
+                               "; expected --json, --max-bits N, --min-time SECONDS or --filter OP");
+        }
+    }
+    return options;
+}
+
+/**
+ * @brief Print the results as CSV, one row per measurement.
+ */
+void print_csv(const vector<BenchResult> &a_results)
+{
+    cout << "op,input,bits,ns_per_op,allocs_per_op,bytes_per_op,iterations\n";
+    for (const BenchResult &result : a_results)
+    {
+        cout << result.op << ',' << result.input << ',' << result.bits << ',' << result.ns_per_op << ','
+             << result.allocs_per_op << ',' << result.bytes_per_op << ',' << result.iterations << '\n';
+    }
+}
+
+/**
+ * @brief Print the results as a JSON array of objects.
+ */
+void print_json(const vector<BenchResult> &a_results)
+{
+    cout << "[\n";
+    for (size_t i = 0; i < a_results.size(); i++)
+    {
+        const BenchResult &result = a_results[i];
+        cout << "  {\"op\": \"" << result.op << "\", \"input\": \"" << result.input << "\", \"bits\": " << result.bits
+             << ", \"ns_per_op\": " << result.ns_per_op << ", \"allocs_per_op\": " << result.allocs_per_op
+             << ", \"bytes_per_op\": " << result.bytes_per_op << ", \"iterations\": " << result.iterations << "}"
+             << (i + 1 < a_results.size() ? ",\n" : "\n");
+    }
+    cout << "]\n";
+}
+
+int main(int argc, char **argv)
+{
+    BenchOptions options;
+    try
+    {
+        options = parse_options(argc, argv);
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << e.what() << "\n";
+        return 2;
+    }
+
+    std::mt19937_64 rng(20231228);
+    vector<BenchResult> results;
+    auto run = [&](const string &a_op, const string &a_input, size_t a_bits, const std::function<void()> &a_body)
+    {
+        if (!options.filter.empty() && a_op != options.filter)
+        {
+            return;
+        }
+        results.push_back(measure(a_op, a_input, a_bits, options.min_time, a_body));
+        // Progress goes to stderr, so that stdout holds only the report.
+        std::cerr << a_op << ' ' << a_input << ' ' << a_bits << ": " << results.back().ns_per_op << " ns/op\n";
+    };
+
+    for (size_t bits = 64; bits <= options.max_bits; bits *= 4)
+    {
+        for (const char *input : {"random", "ones", "sparse"})
+        {
+            Int a = make_bench_operand(rng, bits, input);
+            Int b = make_bench_operand(rng, bits, input);
+            Int r = a;
+            string text = a.to_str();
+
+            run("copy", input, bits, [&]() { r = a; });
+            run("compare", input, bits, [&]() { volatile bool less = a < b; (void)less; });
+            run("add", input, bits, [&]() { r = a + b; });
+            run("sub", input, bits, [&]() { r = a - b; });
+            run("mul", input, bits, [&]() { r = a * b; });
+            run("to_str", input, bits, [&]() { text = a.to_str(); });
+            // Streaming goes through the same splits as to_str, into a sink that only counts the digits.
+            size_t streamed = 0;
+            DecimalSink sink([&streamed](const char *, size_t a_len) { streamed += a_len; });
+            run("write_decimal", input, bits, [&]() { write_decimal(a, sink); });
+            // Short values are converted on the stack, so the rows at 64 bits should show no allocations.
+            NullBuffer null_buffer;
+            ostream null_stream(&null_buffer);
+            run("operator<<", input, bits, [&]() { null_stream << a; });
+            run("parse", input, bits, [&]() { r = Int(text); });
+
+            // Divide a 2n-bit number by an n-bit one, the size where the quotient is as long as the divisor.
+            Int dividend = a * b + a;
+            run("div", input, bits, [&]() { r = dividend / b; });
+        }
+
+        // Equal operands make a comparison read every limb, and a divisor just above a power of two
+        // makes the quotient estimates of schoolbook division need corrections most often.
+        Int a = make_bench_operand(rng, bits, "random");
+        Int b = a;
+        run("compare", "equal", bits, [&]() { volatile bool less = a < b; (void)less; });
+        Int divisor = make_bench_operand(rng, bits, "sparse");
+        Int dividend = make_bench_operand(rng, bits * 2, "ones");
+        Int r = a;
+        run("div", "near_power", bits, [&]() { r = dividend / divisor; });
+    }
+
+    if (options.json)
+    {
+        print_json(results);
+    }
+    else
+    {
+        print_csv(results);
+    }
+
+    // Word-sized operands fit in the inline limbs of an Int, so any allocation there is a regression.
+    int status = 0;
+    for (const BenchResult &result : results)
+    {
+        if (result.bits == LIMB_BITS && ALLOCATION_FREE_OPS.count(result.op) && result.allocs_per_op > 0)
+        {
+            std::cerr << "REGRESSION: " << result.op << ' ' << result.input << ' ' << result.bits << " makes "
+                      << result.allocs_per_op << " allocations/op\n";
+            status = 1;
+        }
+    }
+    return status;
+}
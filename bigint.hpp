@@ -10,9 +10,44 @@
 #include <cstdint>
 #include <vector>
 #include <algorithm>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <exception>
+#include <memory_resource>
+#include <span>
+#include <atomic>
+#include <chrono>
+#include <bit>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <system_error>
+#include <cerrno>
+#include <functional>
+#include <optional>
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+#if __has_include(<format>)
+#include <format>
+#endif
+#if __has_include(<unistd.h>)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#if __has_include(<sys/mman.h>)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
 using std::cout;
 using std::domain_error;
+using std::int64_t;
 using std::int8_t;
+using std::invalid_argument;
+using std::uint64_t;
 using std::ostream;
 using std::out_of_range;
 using std::reverse;
@@ -22,804 +57,8703 @@ using std::to_string;
 using std::vector;
 
 /**
- * @brief Convert a character to an integer.
- *
- * @param a A character
- * @return int8_t 
- * @throw domain_error if the input is out of the range (48, 57)
+ * @brief A single machine word of an Int's magnitude. Limbs are stored least-significant first.
  */
-int8_t char_to_int(const char &a)
-{
-    if (a < 48 || a > 57)
-    {
-        throw domain_error("Cannot cast, character out of range");
-    }
-    else
-    {
-        return a - 48;
-    }
-}
+using limb_t = uint64_t;
 
 /**
- * @brief Convert a integer to a single digit.
+ * @brief Double-width limb, used to hold the full product or carry of two limbs.
+ */
+using dlimb_t = unsigned __int128;
+
+/**
+ * @brief Number of bits in a limb.
+ */
+const size_t LIMB_BITS = sizeof(limb_t) * 8;
+
+/**
+ * @brief Add two limb arrays of the same length with 128-bit arithmetic, for any target.
  *
- * @param a A integer that can be converted to a single digit.
- * @return double
- * @throw domain_error if the input is out of range (0, 9)
+ * @param a_r The output, which may alias either operand
+ * @param a_opr_1 The first operand
+ * @param a_opr_2 The second operand
+ * @param a_len The length of all three arrays
+ * @return The carry out of the most significant limb
  */
-char dig_to_char(const int8_t &a)
+limb_t add_n_generic(limb_t *a_r, const limb_t *a_opr_1, const limb_t *a_opr_2, size_t a_len)
 {
-    if (a > 9)
+    limb_t carry = 0;
+    for (size_t i = 0; i < a_len; i++)
     {
-        string error_msg = "Cannot cast, integer " + to_string(unsigned(a)) + " out of range";
-        throw domain_error(error_msg);
-    }
-    else
-    {
-        return (char)a + 48;
+        dlimb_t sum = (dlimb_t)a_opr_1[i] + a_opr_2[i] + carry;
+        a_r[i] = (limb_t)sum;
+        carry = (limb_t)(sum >> LIMB_BITS);
     }
+    return carry;
 }
 
 /**
- * @brief Raise 2 to the power of a large base, then return the value. Fails if the result cannot be represented.
+ * @brief Subtract two limb arrays of the same length, for any target.
  *
- * @param a_pow The power to be raised to
- * @return int64_t
+ * @param a_r The output, which may alias either operand
+ * @param a_opr_1 The minuend
+ * @param a_opr_2 The subtrahend
+ * @param a_len The length of all three arrays
+ * @return The borrow out of the most significant limb
  */
-int64_t int64_t_pow_2(int64_t a_pow)
+limb_t sub_n_generic(limb_t *a_r, const limb_t *a_opr_1, const limb_t *a_opr_2, size_t a_len)
 {
-    if (a_pow < 1)
-    {
-        return 1;
-    }
-    else
+    limb_t borrow = 0;
+    for (size_t i = 0; i < a_len; i++)
     {
-        return (2 * int64_t_pow_2(a_pow - 1));
+        dlimb_t diff = (dlimb_t)a_opr_1[i] - a_opr_2[i] - borrow;
+        a_r[i] = (limb_t)diff;
+        borrow = (limb_t)(diff >> LIMB_BITS) & 1;
     }
+    return borrow;
 }
 
 /**
- * @brief Sum two strings of digits, then return the result.
+ * @brief Compare two limb arrays of the same length from the top, for any target.
  *
- * @param a_s1 the first operand
- * @param a_s2 the second operand
- * @return string
- * @throw domain_error if either input contains non-numeric characters
+ * @param a_opr_1 The first operand
+ * @param a_opr_2 The second operand
+ * @param a_len The length of both arrays
+ * @return -1, 0 or 1 if the first operand is smaller than, equal to or greater than the second
  */
-string sum_strs(const string &a_s1, const string &a_s2)
+int cmp_n_generic(const limb_t *a_opr_1, const limb_t *a_opr_2, size_t a_len)
 {
-    string longer_str = (a_s1.length() > a_s2.length()) ? a_s1 : a_s2;
-    string shorter_str = (a_s1.length() > a_s2.length()) ? a_s2 : a_s1;
-    vector<char> result;
-
-    size_t len_dif = longer_str.length() - shorter_str.length();
-    bool carry = false;
-
-    for (size_t i = longer_str.length(); i-- > 0;)
+    for (size_t i = a_len; i-- > 0;)
     {
-        char longer_chr = longer_str[i];
-        char shorter_chr = (i >= len_dif) ? shorter_str[i - len_dif] : '0';
-
-        int8_t longer_dig = char_to_int(longer_chr);
-        int8_t shorter_dig = char_to_int(shorter_chr);
-        int8_t sum_of_digs = (int8_t)(longer_dig + shorter_dig + ((carry) ? 1 : 0)); // there is a warning "conversion from 'int' to 'int8_t' {aka 'signed char'} may change value ".
-        // I don't know why.
-        if (sum_of_digs >= 10)
+        if (a_opr_1[i] != a_opr_2[i])
         {
-            result.push_back(dig_to_char(sum_of_digs - 10));
-            carry = true;
+            return (a_opr_1[i] > a_opr_2[i]) ? 1 : -1;
         }
-        else
-        {
-            result.push_back(dig_to_char(sum_of_digs));
-            carry = false;
-        }
-    }
-    if (carry)
-    {
-        result.push_back('1');
     }
-    reverse(result.begin(), result.end());
-    string result_string(result.begin(), result.end());
-
-    return result_string;
+    return 0;
 }
 
 /**
- * @brief Convert a vector of bools (0s and 1s) to a string of decimal digits.
+ * @brief Add one limb of many independent numbers at once, for the structure-of-arrays layout of IntBatch.
+ *      Lane i computes a_r[i] = a_opr_1[i] + a_opr_2[i] + a_carry[i] and leaves its carry in a_carry[i].
  *
- * @param a_bools
- * @return double
- * @todo Performance can be improved.
+ * @param a_r The output lanes, which may alias either operand
+ * @param a_opr_1 The first operand lanes
+ * @param a_opr_2 The second operand lanes
+ * @param a_carry The carry of each lane, 0 or 1, updated in place
+ * @param a_len The number of lanes
  */
-string bin_to_string(vector<bool> a_bools)
+void add_lanes_generic(limb_t *a_r, const limb_t *a_opr_1, const limb_t *a_opr_2, limb_t *a_carry, size_t a_len)
 {
-    string result;
-    size_t int64_t_len = (sizeof(int64_t) * 8) - 2;
-    int64_t accu = 0;
-    bool deposited = false;
-
-    for (size_t i = a_bools.size(); i-- > 0;)
-    {
-        size_t current_significance = a_bools.size() - i - 1;
-        // This piece of code is the main bottleneck of converting from binary to decimal string.
-        // cout << "## iteration start!\n" <<
-        //     "    at this point, accu = " << accu << ", i = " << i << ", sig = " << current_significance << ",\n" <<
-        //     "    and the numerals has" << ((deposited)? " " : " not ") <<"been released.\n";
-        if (current_significance <= int64_t_len)
-        {
-            // // Guards against overflow
-            if (a_bools[i] == true)
-            {
-                accu = accu + int64_t_pow_2((int64_t)current_significance);
-            }
-        }
-        else
-        {
-            if (!deposited)
-            {
-                // cout << accu;
-                result = to_string(accu);
-                // cout << "deposit!\n";
-                deposited = true;
-            }
-            if (a_bools[i] == true)
-            {
-                // cout << "    significance " << current_significance << " exceeds " << int64_t_len << ". Add the number " <<
-                //     int64_t_pow_2(2, (int64_t_len)) << "to the string for " << int64_t_pow_2(2, current_significance - int64_t_len ) <<" times.\n";
-                for (size_t ii = 0; ii < unsigned(int64_t_pow_2((long)current_significance - (long)int64_t_len)); ii++)
-                {
-                    // cout << "   -- add " << to_string(int64_t_pow_2(2, (int64_t_len))) << " to " << result << " yields:";
-
-                    result = sum_strs(result, to_string(int64_t_pow_2((int64_t)int64_t_len)));
-                    // cout << result << ".\n";
-                }
-            }
-        }
-    }
-    if (!deposited)
+    for (size_t i = 0; i < a_len; i++)
     {
-        result = to_string(accu);
+        limb_t sum = a_opr_1[i] + a_opr_2[i];
+        limb_t carry = (sum < a_opr_1[i]) ? 1 : 0;
+        a_r[i] = sum + a_carry[i];
+        a_carry[i] = carry | ((a_r[i] < sum) ? 1 : 0);
     }
-    return result;
 }
 
 /**
- * @brief Check of the divisor can divide the divident, if their least significant
- *      digits are matched to the same index.
+ * @brief Subtract one limb of many independent numbers at once. Lane i computes
+ *      a_r[i] = a_opr_1[i] - a_opr_2[i] - a_borrow[i] and leaves its borrow in a_borrow[i].
  *
- * @param a_dvd The dividend
- * @param a_dvs The divisor
- * @param a_dvd_offet The offset from which the divisor divides
- * @return If the divisor can divide the divident starting at the offset
+ * @param a_r The output lanes, which may alias either operand
+ * @param a_opr_1 The minuend lanes
+ * @param a_opr_2 The subtrahend lanes
+ * @param a_borrow The borrow of each lane, 0 or 1, updated in place
+ * @param a_len The number of lanes
  */
-bool can_divide(const vector<bool> &a_dvd,
-                const vector<bool> &a_dvs,
-                const size_t &a_dvd_offset)
+void sub_lanes_generic(limb_t *a_r, const limb_t *a_opr_1, const limb_t *a_opr_2, limb_t *a_borrow, size_t a_len)
 {
-    if (a_dvd_offset >= 1 && a_dvd[a_dvd_offset - 1] == 1)
+    for (size_t i = 0; i < a_len; i++)
     {
-
-        return true;
+        limb_t diff = a_opr_1[i] - a_opr_2[i];
+        limb_t borrow = (a_opr_1[i] < a_opr_2[i]) ? 1 : 0;
+        a_r[i] = diff - a_borrow[i];
+        a_borrow[i] = borrow | ((diff < a_borrow[i]) ? 1 : 0);
     }
+}
 
-    for (size_t i = 0; i < a_dvs.size(); i++)
+/**
+ * @brief Compare one limb of many independent numbers at once, from the most significant limb down.
+ *      Lanes whose result is still 0 take -1, 0 or 1 from this limb; the others keep theirs.
+ *
+ * @param a_result The result of each lane so far, updated in place
+ * @param a_opr_1 The first operand lanes
+ * @param a_opr_2 The second operand lanes
+ * @param a_len The number of lanes
+ * @param a_is_signed If the limbs are the signed top limbs of two's complement numbers
+ */
+void cmp_lanes_generic(int64_t *a_result, const limb_t *a_opr_1, const limb_t *a_opr_2, size_t a_len, bool a_is_signed)
+{
+    limb_t flip = a_is_signed ? (limb_t)1 << (LIMB_BITS - 1) : 0;
+    for (size_t i = 0; i < a_len; i++)
     {
-
-        if (a_dvd[i + a_dvd_offset] > a_dvs[i])
-        {
-            return true;
-        }
-        else if (a_dvd[i + a_dvd_offset] < a_dvs[i])
+        limb_t lhs = a_opr_1[i] ^ flip;
+        limb_t rhs = a_opr_2[i] ^ flip;
+        if (a_result[i] == 0)
         {
-            return false;
+            a_result[i] = (lhs > rhs) - (lhs < rhs);
         }
     }
-    return true;
 }
 
+#if defined(__x86_64__)
 /**
- * @brief Given two vectors of boolean values, check if the first one is bigger than the second.
- * @param a_opr_1 The first argument
- * @param a_opr_2 The second argument
- * @return If the first value is bigger than the second
+ * @brief The unsigned long long that the carry intrinsics write, allowed to alias a limb_t, which is
+ *      unsigned long on some platforms. Writing the results through it keeps them going straight to
+ *      memory, where copying them out of a local makes GCC pass every limb through the stack.
  */
+typedef unsigned long long __attribute__((may_alias)) limb_alias_t;
 
-bool is_the_first_bigger(
-    const vector<bool> &a_opr_1,
-    const vector<bool> &a_opr_2)
+/**
+ * @brief add_n_generic with the carry kept in the flags, through adc. Every x86-64 processor has it.
+ */
+limb_t add_n_x86(limb_t *a_r, const limb_t *a_opr_1, const limb_t *a_opr_2, size_t a_len)
 {
-    vector<bool> opr_1 = a_opr_1;
-    vector<bool> opr_2 = a_opr_2;
-
-    while (!opr_1.empty() && opr_1[opr_1.size() - 1] == 0)
+    unsigned char carry = 0;
+    size_t i = 0;
+    for (; i + 4 <= a_len; i += 4)
     {
-        opr_1.pop_back();
+        carry = _addcarry_u64(carry, a_opr_1[i], a_opr_2[i], (limb_alias_t *)&a_r[i]);
+        carry = _addcarry_u64(carry, a_opr_1[i + 1], a_opr_2[i + 1], (limb_alias_t *)&a_r[i + 1]);
+        carry = _addcarry_u64(carry, a_opr_1[i + 2], a_opr_2[i + 2], (limb_alias_t *)&a_r[i + 2]);
+        carry = _addcarry_u64(carry, a_opr_1[i + 3], a_opr_2[i + 3], (limb_alias_t *)&a_r[i + 3]);
     }
-    while (!opr_2.empty() && opr_2[opr_2.size() - 1] == 0)
+    for (; i < a_len; i++)
     {
-        opr_2.pop_back();
+        carry = _addcarry_u64(carry, a_opr_1[i], a_opr_2[i], (limb_alias_t *)&a_r[i]);
     }
+    return carry;
+}
 
-    if (a_opr_1.size() != a_opr_2.size())
+/**
+ * @brief sub_n_generic with the borrow kept in the flags, through sbb.
+ */
+limb_t sub_n_x86(limb_t *a_r, const limb_t *a_opr_1, const limb_t *a_opr_2, size_t a_len)
+{
+    unsigned char borrow = 0;
+    size_t i = 0;
+    for (; i + 4 <= a_len; i += 4)
     {
-        return a_opr_1.size() > a_opr_2.size();
+        borrow = _subborrow_u64(borrow, a_opr_1[i], a_opr_2[i], (limb_alias_t *)&a_r[i]);
+        borrow = _subborrow_u64(borrow, a_opr_1[i + 1], a_opr_2[i + 1], (limb_alias_t *)&a_r[i + 1]);
+        borrow = _subborrow_u64(borrow, a_opr_1[i + 2], a_opr_2[i + 2], (limb_alias_t *)&a_r[i + 2]);
+        borrow = _subborrow_u64(borrow, a_opr_1[i + 3], a_opr_2[i + 3], (limb_alias_t *)&a_r[i + 3]);
     }
-    else
+    for (; i < a_len; i++)
     {
-        for (size_t i = 0; i < a_opr_1.size(); i++)
-        {
-            if (a_opr_1[i] > a_opr_2[i])
-            {
-                return true;
-            }
-            else if (a_opr_1[i] < a_opr_2[i])
-            {
-                return false;
-            }
-        }
+        borrow = _subborrow_u64(borrow, a_opr_1[i], a_opr_2[i], (limb_alias_t *)&a_r[i]);
     }
-    return false;
+    return borrow;
 }
 
 /**
- * @brief Subtract two boolean vectors. Subtract the smaller one from the larger one, then return the result.
- *
- * @param a_opt_1 The first operand
- * @param a_opt_2 The second operand
- * @return The result of subtraction
+ * @brief cmp_n_generic that skips equal limbs four at a time with AVX2, then settles the first
+ *      difference with a scalar comparison.
  */
-vector<bool> sub_bool_vectors(const vector<bool> &a_opr_1,
-                              const vector<bool> &a_opr_2,
-                              size_t offset = 0)
+__attribute__((target("avx2")))
+int cmp_n_avx2(const limb_t *a_opr_1, const limb_t *a_opr_2, size_t a_len)
 {
-
-    bool opr_1_is_bigger = is_the_first_bigger(a_opr_1, a_opr_2);
-    vector<bool> opr_longer = (opr_1_is_bigger) ? a_opr_1 : a_opr_2;
-    vector<bool> opr_shorter = (opr_1_is_bigger) ? a_opr_2 : a_opr_1;
-
-    size_t len_opt_1 = opr_longer.size();
-    size_t len_opt_2 = opr_shorter.size();
-
-    size_t len_dif = len_opt_1 - len_opt_2;
-
-    bool borrow = false;
-
-    if (len_dif < offset)
-    {
-        throw out_of_range("Offset greater than length");
-    }
-
-    for (size_t i = opr_longer.size() - offset; i-- > 0;)
+    size_t i = a_len;
+    for (; i >= 4; i -= 4)
     {
-        size_t i_opr_1 = i;
-        size_t i_opr_2 = i - len_dif + offset;
-
-        size_t i_opr_2_c = ((i + offset) >= len_dif) ? opr_shorter[i_opr_2] : 0;
-
-        bool set_opr_1;
-        if (opr_longer[i_opr_1] == 1 && i_opr_2_c == 1)
+        __m256i block_1 = _mm256_loadu_si256((const __m256i *)(a_opr_1 + i - 4));
+        __m256i block_2 = _mm256_loadu_si256((const __m256i *)(a_opr_2 + i - 4));
+        int equal = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(block_1, block_2)));
+        if (equal != 0xF)
         {
-
-            if (borrow)
-            {
-                set_opr_1 = 1;
-                borrow = true;
-            }
-            else
-            {
-                set_opr_1 = 0;
-                borrow = false;
-            }
-        }
-        else if (opr_longer[i_opr_1] == 1 && i_opr_2_c == 0)
-        {
-            if (borrow)
-            {
-                set_opr_1 = 0;
-                borrow = false;
-            }
-            else
-            {
-                set_opr_1 = 1;
-                borrow = false;
-            }
-        }
-        else if (opr_longer[i_opr_1] == 0 && i_opr_2_c == 1)
-        {
-            if (borrow)
-            {
-                set_opr_1 = 0;
-                borrow = true;
-            }
-            else
-            {
-                set_opr_1 = 1;
-                borrow = true;
-            }
-        }
-        else
-        {
-            if (borrow)
-            {
-                set_opr_1 = 1;
-                borrow = true;
-            }
-            else
-            {
-                set_opr_1 = 0;
-                borrow = false;
-            }
+            size_t top = i - 4 + (size_t)(31 - __builtin_clz(~equal & 0xF));
+            return (a_opr_1[top] > a_opr_2[top]) ? 1 : -1;
         }
-        opr_longer[i_opr_1] = set_opr_1;
     }
-    return opr_longer;
+    return cmp_n_generic(a_opr_1, a_opr_2, i);
 }
 
 /**
- * @brief Check if a bool vector contains only "zero"s.
- *
- * @param a_vec The vector to be checked
- * @return If the vector contains only "zero"s
+ * @brief Return the lanes of a_opr_1 that are greater than those of a_opr_2, as unsigned numbers, as masks.
  */
-bool is_zero_vector(const vector<bool> &a_vec)
+__attribute__((target("avx2")))
+__m256i cmpgt_epu64(__m256i a_opr_1, __m256i a_opr_2)
 {
-    for (bool bol : a_vec)
-    {
-        if (bol == true)
-        {
-            return false;
-        }
-    }
-    return true;
+    __m256i flip = _mm256_set1_epi64x((long long)((limb_t)1 << (LIMB_BITS - 1)));
+    return _mm256_cmpgt_epi64(_mm256_xor_si256(a_opr_1, flip), _mm256_xor_si256(a_opr_2, flip));
 }
 
 /**
- * @brief Auxillary function. Divide two values then return the result, as well as the remainder, through its arguments
- *
- * @param a_dvd The dividend
- * @param a_dvs The divisor
- * @param result The vector that accepts the result
- * @param rem The vector that accepts the remainder
+ * @brief add_lanes_generic four lanes at a time with AVX2.
  */
-void div_bool_vectors_bare(const vector<bool> &a_dvd, const vector<bool> &a_dvs, vector<bool> &result, vector<bool> &rem)
+__attribute__((target("avx2")))
+void add_lanes_avx2(limb_t *a_r, const limb_t *a_opr_1, const limb_t *a_opr_2, limb_t *a_carry, size_t a_len)
 {
-    if (!is_the_first_bigger(a_dvd, a_dvs))
+    size_t i = 0;
+    for (; i + 4 <= a_len; i += 4)
     {
-        result = vector<bool>();
-        rem = a_dvd;
+        __m256i opr_1 = _mm256_loadu_si256((const __m256i *)(a_opr_1 + i));
+        __m256i opr_2 = _mm256_loadu_si256((const __m256i *)(a_opr_2 + i));
+        __m256i carry = _mm256_loadu_si256((const __m256i *)(a_carry + i));
+        __m256i sum = _mm256_add_epi64(opr_1, opr_2);
+        __m256i carry_1 = cmpgt_epu64(opr_1, sum);
+        __m256i result = _mm256_add_epi64(sum, carry);
+        __m256i carry_2 = cmpgt_epu64(sum, result);
+        _mm256_storeu_si256((__m256i *)(a_r + i), result);
+        _mm256_storeu_si256((__m256i *)(a_carry + i), _mm256_srli_epi64(_mm256_or_si256(carry_1, carry_2), 63));
     }
-    if (is_zero_vector(a_dvs))
+    add_lanes_generic(a_r + i, a_opr_1 + i, a_opr_2 + i, a_carry + i, a_len - i);
+}
+
+/**
+ * @brief sub_lanes_generic four lanes at a time with AVX2.
+ */
+__attribute__((target("avx2")))
+void sub_lanes_avx2(limb_t *a_r, const limb_t *a_opr_1, const limb_t *a_opr_2, limb_t *a_borrow, size_t a_len)
+{
+    size_t i = 0;
+    for (; i + 4 <= a_len; i += 4)
     {
-        throw domain_error("Cannot divide by zero");
+        __m256i opr_1 = _mm256_loadu_si256((const __m256i *)(a_opr_1 + i));
+        __m256i opr_2 = _mm256_loadu_si256((const __m256i *)(a_opr_2 + i));
+        __m256i borrow = _mm256_loadu_si256((const __m256i *)(a_borrow + i));
+        __m256i diff = _mm256_sub_epi64(opr_1, opr_2);
+        __m256i borrow_1 = cmpgt_epu64(opr_2, opr_1);
+        __m256i result = _mm256_sub_epi64(diff, borrow);
+        __m256i borrow_2 = cmpgt_epu64(borrow, diff);
+        _mm256_storeu_si256((__m256i *)(a_r + i), result);
+        _mm256_storeu_si256((__m256i *)(a_borrow + i), _mm256_srli_epi64(_mm256_or_si256(borrow_1, borrow_2), 63));
     }
+    sub_lanes_generic(a_r + i, a_opr_1 + i, a_opr_2 + i, a_borrow + i, a_len - i);
+}
 
-    vector<bool> dvd_copy = a_dvd;
-
-    size_t len_dvd = a_dvd.size();
-    size_t len_dvs = a_dvs.size();
-
-    size_t len_dif = len_dvd - len_dvs;
-
-    for (size_t i = 0; i < len_dif + 1; i++)
+/**
+ * @brief cmp_lanes_generic four lanes at a time with AVX2.
+ */
+__attribute__((target("avx2")))
+void cmp_lanes_avx2(int64_t *a_result, const limb_t *a_opr_1, const limb_t *a_opr_2, size_t a_len, bool a_is_signed)
+{
+    __m256i flip = _mm256_set1_epi64x(a_is_signed ? 0 : (long long)((limb_t)1 << (LIMB_BITS - 1)));
+    __m256i one = _mm256_set1_epi64x(1);
+    size_t i = 0;
+    for (; i + 4 <= a_len; i += 4)
     {
-        if (can_divide(
-                dvd_copy, a_dvs, i))
-        {
-            vector<bool> tmp = sub_bool_vectors(dvd_copy, a_dvs, len_dvd - (i + len_dvs));
-            dvd_copy = tmp;
-            result.push_back(1);
-        }
-        else
-        {
-            result.push_back(0);
-        }
+        __m256i lhs = _mm256_xor_si256(_mm256_loadu_si256((const __m256i *)(a_opr_1 + i)), flip);
+        __m256i rhs = _mm256_xor_si256(_mm256_loadu_si256((const __m256i *)(a_opr_2 + i)), flip);
+        __m256i result = _mm256_loadu_si256((const __m256i *)(a_result + i));
+        // Greater gives 1 and less gives the all-ones mask, which is -1.
+        __m256i order = _mm256_or_si256(_mm256_and_si256(_mm256_cmpgt_epi64(lhs, rhs), one), _mm256_cmpgt_epi64(rhs, lhs));
+        __m256i undecided = _mm256_cmpeq_epi64(result, _mm256_setzero_si256());
+        _mm256_storeu_si256((__m256i *)(a_result + i), _mm256_blendv_epi8(result, order, undecided));
     }
-    rem = dvd_copy;
+    cmp_lanes_generic(a_result + i, a_opr_1 + i, a_opr_2 + i, a_len - i, a_is_signed);
 }
+#endif
 
 /**
- * @brief Divide two vectors of bools.
- *
- * @param a_dvd The dividend
- * @param a_dvs the divisor
- * @return The result of the division, truncated.
+ * @brief The word-level kernels that add_limbs, sub_limbs, cmp_limbs and IntBatch run on, chosen for the processor
+ *      when the program starts. They may be replaced at run time, for example with the generic ones
+ *      for testing.
  */
-vector<bool> div_bool_vectors(const vector<bool> &a_dvd, const vector<bool> &a_dvs)
+struct LimbKernels
 {
-    vector<bool> result;
-    vector<bool> rem;
-    div_bool_vectors_bare(a_dvd, a_dvs, result, rem);
-    return result;
-}
+    limb_t (*add_n)(limb_t *, const limb_t *, const limb_t *, size_t);
+    limb_t (*sub_n)(limb_t *, const limb_t *, const limb_t *, size_t);
+    int (*cmp_n)(const limb_t *, const limb_t *, size_t);
+    void (*add_lanes)(limb_t *, const limb_t *, const limb_t *, limb_t *, size_t);
+    void (*sub_lanes)(limb_t *, const limb_t *, const limb_t *, limb_t *, size_t);
+    void (*cmp_lanes)(int64_t *, const limb_t *, const limb_t *, size_t, bool);
+    const char *name;
+};
+
+/**
+ * @brief The kernels that work on any target.
+ */
+const LimbKernels GENERIC_LIMB_KERNELS = {add_n_generic, sub_n_generic, cmp_n_generic,
+                                          add_lanes_generic, sub_lanes_generic, cmp_lanes_generic, "generic"};
 
 /**
- * @brief Shift the given bool vector by 1 to the left
+ * @brief Pick the fastest kernels the processor supports, checking CPUID for the optional extensions.
  *
- * @param a_dvd The given bool vector
+ * @return The kernels
  */
-void lsh_bool_vector(vector<bool> &a_dvd)
+LimbKernels select_limb_kernels()
 {
-    a_dvd.push_back(0);
+#if defined(__x86_64__)
+    LimbKernels kernels = {add_n_x86, sub_n_x86, cmp_n_generic,
+                           add_lanes_generic, sub_lanes_generic, cmp_lanes_generic, "x86-64"};
+    if (__builtin_cpu_supports("avx2"))
+    {
+        kernels.cmp_n = cmp_n_avx2;
+        kernels.add_lanes = add_lanes_avx2;
+        kernels.sub_lanes = sub_lanes_avx2;
+        kernels.cmp_lanes = cmp_lanes_avx2;
+        kernels.name = "x86-64+avx2";
+    }
+    return kernels;
+#else
+    return GENERIC_LIMB_KERNELS;
+#endif
 }
 
+LimbKernels limb_kernels = select_limb_kernels();
+
 /**
- * @brief Add two bool vectors, then return the result.
+ * @brief Add two limb arrays, the first no shorter than the second. The result has the length of the first.
+ *
+ * @param a_r The output, which may alias either operand
  * @param a_opr_1 The first operand
+ * @param a_len_1 The length of the first operand
  * @param a_opr_2 The second operand
- * @return The result of addition
+ * @param a_len_2 The length of the second operand, no greater than a_len_1
+ * @return The carry out of the most significant limb
  */
-vector<bool> add_bool_vectors(const vector<bool> &a_opr_1, const vector<bool> &a_opr_2)
+limb_t add_limbs(limb_t *a_r,
+                 const limb_t *a_opr_1, size_t a_len_1,
+                 const limb_t *a_opr_2, size_t a_len_2)
 {
-
-    vector<bool> result;
-
-    bool opr_1_is_bigger = is_the_first_bigger(a_opr_1, a_opr_2);
-
-    vector<bool> opr_longer = (opr_1_is_bigger) ? a_opr_1 : a_opr_2;
-    vector<bool> opr_shorter = (opr_1_is_bigger) ? a_opr_2 : a_opr_1;
-    size_t len_dif = opr_longer.size() - opr_shorter.size();
-    bool carry = false;
-
-    for (size_t i = opr_longer.size(); i-- > 0;)
+    limb_t carry = limb_kernels.add_n(a_r, a_opr_1, a_opr_2, a_len_2);
+    size_t i = a_len_2;
+    for (; carry != 0 && i < a_len_1; i++)
     {
-        bool opt_longer_bol = opr_longer[i];
-        bool opt_shorter_bol = (i >= len_dif) ? opr_shorter[i - len_dif] : 0;
-        if (opt_longer_bol == 1 && opt_shorter_bol == 1)
-        {
-            if (carry)
-            {
-                result.push_back(1);
-            }
-            else
-            {
-                result.push_back(0);
-            }
-            carry = true;
-        }
-        else if ((opt_longer_bol == 1 && opt_shorter_bol == 0) || (opt_longer_bol == 0 && opt_shorter_bol == 1))
-        {
-            if (carry)
-            {
-                result.push_back(0);
-                carry = true;
-            }
-            else
-            {
-                result.push_back(1);
-                carry = false;
-            }
-        }
-        else
-        {
-            if (carry)
-            {
-                result.push_back(1);
-            }
-            else
-            {
-                result.push_back(0);
-            }
-            carry = false;
-        }
+        a_r[i] = a_opr_1[i] + 1;
+        carry = (a_r[i] == 0) ? 1 : 0;
     }
-    if (carry)
+    if (a_r != a_opr_1)
     {
-        result.push_back(1);
+        std::copy(a_opr_1 + i, a_opr_1 + a_len_1, a_r + i);
     }
-    reverse(result.begin(), result.end());
-    return result;
+    return carry;
 }
 
 /**
- * @brief Multiply two bool vectors, then return the result.
+ * @brief Subtract the second limb array from the first, which must be no shorter. The result has the length of the first.
  *
- * @param a_mnd The number to be multiplied
- * @param a_mer The multiplier
- * @return The result of multiplication
+ * @param a_r The output, which may alias either operand
+ * @param a_opr_1 The minuend
+ * @param a_len_1 The length of the minuend
+ * @param a_opr_2 The subtrahend
+ * @param a_len_2 The length of the subtrahend, no greater than a_len_1
+ * @return The borrow out of the most significant limb
  */
-vector<bool> mul_bool_vectors(const vector<bool> &a_mnd, const vector<bool> &a_mer)
+limb_t sub_limbs(limb_t *a_r,
+                 const limb_t *a_opr_1, size_t a_len_1,
+                 const limb_t *a_opr_2, size_t a_len_2)
 {
-
-    vector<bool> result = {0};
-    vector<bool> addrant = a_mnd;
-
-    for (size_t i = 0; i < a_mer.size(); i++)
+    limb_t borrow = limb_kernels.sub_n(a_r, a_opr_1, a_opr_2, a_len_2);
+    size_t i = a_len_2;
+    for (; borrow != 0 && i < a_len_1; i++)
     {
-
-        if (a_mer[a_mer.size() - i - 1])
-        {
-            result = add_bool_vectors(result, addrant);
-            ;
-        };
-        lsh_bool_vector(addrant);
+        limb_t lhs = a_opr_1[i];
+        a_r[i] = lhs - 1;
+        borrow = (lhs == 0) ? 1 : 0;
     }
-    return result;
+    if (a_r != a_opr_1)
+    {
+        std::copy(a_opr_1 + i, a_opr_1 + a_len_1, a_r + i);
+    }
+    return borrow;
 }
 
 /**
- * @brief Arbitrary-length integer. Its length is technically limited to the smaller of int64_t and size_t, though this limitation is unlikely to come up.
- *      The largest number it can contain is 2^4294967296.
- */
-class Int
-{
-public:
-    Int(const Int &);
-    Int(const string &);
-    Int(const bool &, const vector<bool> &);
-
-    bool is_positive = true;
-    vector<bool> bools;
-
-    Int operator=(const Int &);
-
-    friend ostream &operator<<(const ostream &, const Int &);
-    Int operator-() const;
-    Int operator+(const Int &) const;
-    void operator+=(const Int &);
-    Int operator-(const Int &a_that) const;
-    void operator-=(const Int &a_that);
-    Int operator*(const Int &a_that) const;
-    void operator*=(const Int &a_that);
-    Int operator/(const Int &a_that) const;
-    void operator/=(const Int &a_that);
-    bool operator==(const Int &a_that) const;
-    bool operator!=(const Int &a_that) const;
-    bool operator>(const Int &a_that) const;
-    bool operator<(const Int &a_that) const;
-    bool operator>=(const Int &a_that) const;
-    bool operator<=(const Int &a_that) const;
-    string to_str() const;
-    string to_str_bools() const;
-
-private:
-    void consume_str_to_bools(const string &);
-};
-
-/**
- * @brief Return a binary string representaiton of this integer.
+ * @brief Compare two limb arrays without leading zero limbs.
  *
- * @return A binary string representation of this integer.
+ * @param a_opr_1 The first operand
+ * @param a_len_1 The length of the first operand
+ * @param a_opr_2 The second operand
+ * @param a_len_2 The length of the second operand
+ * @return -1, 0 or 1 if the first operand is smaller than, equal to or greater than the second
  */
-string Int::to_str_bools() const
+int cmp_limbs(const limb_t *a_opr_1, size_t a_len_1,
+              const limb_t *a_opr_2, size_t a_len_2)
 {
-    if (is_zero_vector(this->bools)) return "0";
-    string result;
-    bool is_1_met = false;
-    result += (this->is_positive ? "" : "-");
-    for (const bool &bol : this->bools)
+    if (a_len_1 != a_len_2)
     {
-        if (bol || is_1_met)
-        {
-            result += (bol) ? '1' : '0';
-            is_1_met = true;
-        }
+        return (a_len_1 > a_len_2) ? 1 : -1;
     }
-
-    return result;
+    return limb_kernels.cmp_n(a_opr_1, a_opr_2, a_len_1);
 }
 
 /**
- * @brief Return a string representation of this integer.
- *
- * @return A string representation of this integer.
+ * @brief Low-level functions on spans of limbs, least significant first, in the manner of GMP's mpn layer.
+ *      They check nothing: lengths must satisfy the conditions given, and the output may alias an input
+ *      only where it starts at the same limb.
  */
-string Int::to_str() const
+namespace mpn
 {
-    if (is_zero_vector(this->bools)) return "0";
-    return (this->is_positive ? "" : "-") + bin_to_string(this->bools);
-}
-
 /**
- * @brief Constructor from a string of digits.
+ * @brief Add two spans of the same length.
  *
- * @param a_in a string to construct from
- * @throw domain_error if the input contains non-digit characters.
+ * @param a_r The output, as long as the operands
+ * @param a_opr_1 The first operand
+ * @param a_opr_2 The second operand
+ * @return The carry out of the most significant limb
+ */
+limb_t add_n(std::span<limb_t> a_r, std::span<const limb_t> a_opr_1, std::span<const limb_t> a_opr_2)
+{
+    return limb_kernels.add_n(a_r.data(), a_opr_1.data(), a_opr_2.data(), a_opr_1.size());
+}
+
+/**
+ * @brief Add two spans, the first no shorter than the second.
+ *
+ * @param a_r The output, as long as the first operand
+ * @param a_opr_1 The first operand
+ * @param a_opr_2 The second operand
+ * @return The carry out of the most significant limb
+ */
+limb_t add(std::span<limb_t> a_r, std::span<const limb_t> a_opr_1, std::span<const limb_t> a_opr_2)
+{
+    return add_limbs(a_r.data(), a_opr_1.data(), a_opr_1.size(), a_opr_2.data(), a_opr_2.size());
+}
+
+/**
+ * @brief Subtract two spans of the same length.
+ *
+ * @param a_r The output, as long as the operands
+ * @param a_opr_1 The minuend
+ * @param a_opr_2 The subtrahend
+ * @return The borrow out of the most significant limb
+ */
+limb_t sub_n(std::span<limb_t> a_r, std::span<const limb_t> a_opr_1, std::span<const limb_t> a_opr_2)
+{
+    return limb_kernels.sub_n(a_r.data(), a_opr_1.data(), a_opr_2.data(), a_opr_1.size());
+}
+
+/**
+ * @brief Subtract two spans, the minuend no shorter than the subtrahend.
+ *
+ * @param a_r The output, as long as the minuend
+ * @param a_opr_1 The minuend
+ * @param a_opr_2 The subtrahend
+ * @return The borrow out of the most significant limb
+ */
+limb_t sub(std::span<limb_t> a_r, std::span<const limb_t> a_opr_1, std::span<const limb_t> a_opr_2)
+{
+    return sub_limbs(a_r.data(), a_opr_1.data(), a_opr_1.size(), a_opr_2.data(), a_opr_2.size());
+}
+
+/**
+ * @brief Compare two spans of the same length.
+ *
+ * @param a_opr_1 The first operand
+ * @param a_opr_2 The second operand
+ * @return -1, 0 or 1 if the first operand is smaller than, equal to or greater than the second
+ */
+int cmp_n(std::span<const limb_t> a_opr_1, std::span<const limb_t> a_opr_2)
+{
+    return limb_kernels.cmp_n(a_opr_1.data(), a_opr_2.data(), a_opr_1.size());
+}
+
+/**
+ * @brief Compare two spans without leading zero limbs.
+ *
+ * @param a_opr_1 The first operand
+ * @param a_opr_2 The second operand
+ * @return -1, 0 or 1 if the first operand is smaller than, equal to or greater than the second
+ */
+int cmp(std::span<const limb_t> a_opr_1, std::span<const limb_t> a_opr_2)
+{
+    return cmp_limbs(a_opr_1.data(), a_opr_1.size(), a_opr_2.data(), a_opr_2.size());
+}
+}
+
+/**
+ * @brief Shift a limb array left by fewer than 64 bits.
+ *
+ * @param a_r The output, of the same length, which may alias the input or overlap it at a higher address
+ * @param a_opr The limb array
+ * @param a_len The length of the limb array
+ * @param a_shift The number of bits, less than 64
+ * @return The bits shifted out of the most significant limb
+ */
+limb_t lsh_limbs(limb_t *a_r, const limb_t *a_opr, size_t a_len, unsigned a_shift)
+{
+    if (a_shift == 0)
+    {
+        std::copy_backward(a_opr, a_opr + a_len, a_r + a_len);
+        return 0;
+    }
+    limb_t out = 0;
+    for (size_t i = a_len; i-- > 0;)
+    {
+        limb_t limb = a_opr[i];
+        if (i + 1 == a_len)
+        {
+            out = limb >> (LIMB_BITS - a_shift);
+        }
+        a_r[i] = (limb << a_shift) | ((i > 0) ? a_opr[i - 1] >> (LIMB_BITS - a_shift) : 0);
+    }
+    return out;
+}
+
+/**
+ * @brief Shift a limb array right by fewer than 64 bits.
+ *
+ * @param a_r The output, of the same length, which may alias the input or overlap it at a lower address
+ * @param a_opr The limb array
+ * @param a_len The length of the limb array
+ * @param a_shift The number of bits, less than 64
+ * @return The bits shifted out of the least significant limb, in the top of the returned limb
+ */
+limb_t rsh_limbs(limb_t *a_r, const limb_t *a_opr, size_t a_len, unsigned a_shift)
+{
+    if (a_shift == 0)
+    {
+        std::copy(a_opr, a_opr + a_len, a_r);
+        return 0;
+    }
+    limb_t out = (a_len > 0) ? a_opr[0] << (LIMB_BITS - a_shift) : 0;
+    for (size_t i = 0; i < a_len; i++)
+    {
+        a_r[i] = (a_opr[i] >> a_shift) | ((i + 1 < a_len) ? a_opr[i + 1] << (LIMB_BITS - a_shift) : 0);
+    }
+    return out;
+}
+
+/**
+ * @brief Multiply a limb array by a single limb and add the product to the output.
+ *
+ * @param a_r The output, which is accumulated into
+ * @param a_opr The limb array
+ * @param a_len The length of the limb array
+ * @param a_mer The single-limb multiplier
+ * @return The carry out of the most significant limb
+ */
+limb_t addmul_1_limbs(limb_t *a_r, const limb_t *a_opr, size_t a_len, limb_t a_mer)
+{
+    limb_t carry = 0;
+    for (size_t i = 0; i < a_len; i++)
+    {
+        dlimb_t prod = (dlimb_t)a_opr[i] * a_mer + a_r[i] + carry;
+        a_r[i] = (limb_t)prod;
+        carry = (limb_t)(prod >> LIMB_BITS);
+    }
+    return carry;
+}
+
+/**
+ * @brief Multiply two limb arrays with the schoolbook method.
+ *
+ * @param a_r The output of a_len_1 + a_len_2 limbs, which must not alias either operand
+ * @param a_mnd The number to be multiplied
+ * @param a_len_1 The length of the number to be multiplied
+ * @param a_mer The multiplier
+ * @param a_len_2 The length of the multiplier
+ */
+void mul_limbs_schoolbook(limb_t *a_r,
+                          const limb_t *a_mnd, size_t a_len_1,
+                          const limb_t *a_mer, size_t a_len_2)
+{
+    std::fill(a_r, a_r + a_len_1 + a_len_2, 0);
+    for (size_t i = 0; i < a_len_2; i++)
+    {
+        a_r[i + a_len_1] = addmul_1_limbs(a_r + i, a_mnd, a_len_1, a_mer[i]);
+    }
+}
+
+/**
+ * @brief Square a limb array with the schoolbook method. Each cross product a_i * a_j with i < j is
+ *      computed once and the sum doubled with a shift, then the squares a_i^2 are added on the diagonal,
+ *      which takes about half the limb products of a general multiplication.
+ *
+ * @param a_r The output of 2 * a_len limbs, which must not alias the operand
+ * @param a_opr The number to be squared
+ * @param a_len The length of the number
+ */
+void sqr_limbs_schoolbook(limb_t *a_r, const limb_t *a_opr, size_t a_len)
+{
+    std::fill(a_r, a_r + 2 * a_len, 0);
+    for (size_t i = 0; i + 1 < a_len; i++)
+    {
+        a_r[i + a_len] = addmul_1_limbs(a_r + 2 * i + 1, a_opr + i + 1, a_len - i - 1, a_opr[i]);
+    }
+    lsh_limbs(a_r, a_r, 2 * a_len, 1);
+    limb_t carry = 0;
+    for (size_t i = 0; i < a_len; i++)
+    {
+        dlimb_t square = (dlimb_t)a_opr[i] * a_opr[i];
+        dlimb_t low = (dlimb_t)a_r[2 * i] + (limb_t)square + carry;
+        a_r[2 * i] = (limb_t)low;
+        dlimb_t high = (dlimb_t)a_r[2 * i + 1] + (limb_t)(square >> LIMB_BITS) + (limb_t)(low >> LIMB_BITS);
+        a_r[2 * i + 1] = (limb_t)high;
+        carry = (limb_t)(high >> LIMB_BITS);
+    }
+}
+
+/**
+ * @brief Multiply a limb array by a single limb.
+ *
+ * @param a_r The output, of the same length, which may alias the input
+ * @param a_opr The limb array
+ * @param a_len The length of the limb array
+ * @param a_mer The single-limb multiplier
+ * @return The carry out of the most significant limb
+ */
+limb_t mul_1_limbs(limb_t *a_r, const limb_t *a_opr, size_t a_len, limb_t a_mer)
+{
+    limb_t carry = 0;
+    for (size_t i = 0; i < a_len; i++)
+    {
+        dlimb_t prod = (dlimb_t)a_opr[i] * a_mer + carry;
+        a_r[i] = (limb_t)prod;
+        carry = (limb_t)(prod >> LIMB_BITS);
+    }
+    return carry;
+}
+
+/**
+ * @brief A single-limb divisor with a precomputed reciprocal, so that each step of a division by it takes
+ *      two multiplications instead of a 128-by-64-bit division, which compilers turn into a slow library
+ *      call (Moller and Granlund, "Improved division by invariant integers", 2011).
+ */
+class LimbDivisor
+{
+public:
+    explicit LimbDivisor(limb_t);
+
+    // The divisor shifted left until its top bit is set
+    limb_t normalized;
+    // The number of bits of that shift
+    unsigned shift;
+    // floor((2^128 - 1) / normalized) - 2^64
+    limb_t reciprocal;
+
+    /**
+     * @brief Divide a_high * 2^64 + a_low by the normalized divisor, for a_high below it.
+     */
+    limb_t div_2by1(limb_t a_high, limb_t a_low, limb_t &a_rem) const
+    {
+        dlimb_t q = (dlimb_t)reciprocal * a_high + (((dlimb_t)(a_high + 1) << LIMB_BITS) | a_low);
+        limb_t q_high = (limb_t)(q >> LIMB_BITS);
+        limb_t rem = a_low - q_high * normalized;
+        // The estimate is at most one too large or one too small.
+        if (rem > (limb_t)q)
+        {
+            q_high--;
+            rem += normalized;
+        }
+        if (rem >= normalized)
+        {
+            q_high++;
+            rem -= normalized;
+        }
+        a_rem = rem;
+        return q_high;
+    }
+};
+
+/**
+ * @brief Precompute the reciprocal of a divisor.
+ *
+ * @param a_dvs The divisor, not zero
+ */
+LimbDivisor::LimbDivisor(limb_t a_dvs)
+{
+    shift = (unsigned)__builtin_clzll(a_dvs);
+    normalized = a_dvs << shift;
+    reciprocal = (limb_t)((((dlimb_t)~normalized << LIMB_BITS) | ~(limb_t)0) / normalized);
+}
+
+/**
+ * @brief Divide a limb array by a single limb whose reciprocal is precomputed.
+ *
+ * @param a_q The quotient, which has the length of the dividend and may alias it
+ * @param a_dvd The dividend
+ * @param a_len The length of the dividend
+ * @param a_dvs The divisor
+ * @return The remainder
+ */
+limb_t div_1_limbs(limb_t *a_q, const limb_t *a_dvd, size_t a_len, const LimbDivisor &a_dvs)
+{
+    if (a_len == 0)
+    {
+        return 0;
+    }
+    unsigned shift = a_dvs.shift;
+    // The dividend is shifted along with the divisor as it is read, from the top down.
+    limb_t rem = (shift == 0) ? 0 : a_dvd[a_len - 1] >> (LIMB_BITS - shift);
+    for (size_t i = a_len; i-- > 0;)
+    {
+        limb_t low = (shift == 0) ? a_dvd[i] : (a_dvd[i] << shift) | ((i > 0) ? a_dvd[i - 1] >> (LIMB_BITS - shift) : 0);
+        a_q[i] = a_dvs.div_2by1(rem, low, rem);
+    }
+    return rem >> shift;
+}
+
+/**
+ * @brief Divide a limb array by a single limb.
+ *
+ * @param a_q The quotient, which has the length of the dividend and may alias it
+ * @param a_dvd The dividend
+ * @param a_len The length of the dividend
+ * @param a_dvs The single-limb divisor, not zero
+ * @return The remainder
+ */
+limb_t div_1_limbs(limb_t *a_q, const limb_t *a_dvd, size_t a_len, limb_t a_dvs)
+{
+    return div_1_limbs(a_q, a_dvd, a_len, LimbDivisor(a_dvs));
+}
+
+/**
+ * @brief Return the remainder of a limb array divided by a single limb whose reciprocal is precomputed.
+ *
+ * @param a_dvd The dividend
+ * @param a_len The length of the dividend
+ * @param a_dvs The divisor
+ * @return The remainder
+ */
+limb_t mod_1_limbs(const limb_t *a_dvd, size_t a_len, const LimbDivisor &a_dvs)
+{
+    if (a_len == 0)
+    {
+        return 0;
+    }
+    unsigned shift = a_dvs.shift;
+    limb_t rem = (shift == 0) ? 0 : a_dvd[a_len - 1] >> (LIMB_BITS - shift);
+    for (size_t i = a_len; i-- > 0;)
+    {
+        limb_t low = (shift == 0) ? a_dvd[i] : (a_dvd[i] << shift) | ((i > 0) ? a_dvd[i - 1] >> (LIMB_BITS - shift) : 0);
+        a_dvs.div_2by1(rem, low, rem);
+    }
+    return rem >> shift;
+}
+
+/**
+ * @brief Divide two limb arrays with Knuth's Algorithm D (TAOCP vol. 2, 4.3.1), given the divisor already
+ *      normalized and the reciprocal of its top limb. Each quotient limb is estimated with
+ *      LimbDivisor::div_2by1 rather than a 128-bit hardware division, and a divisor used many times, as by
+ *      Divider, is prepared only once.
+ *
+ * @param a_q The quotient, of a_len_1 - a_len_2 + 1 limbs
+ * @param a_rem The remainder, of a_len_2 limbs
+ * @param a_dvd The dividend
+ * @param a_len_1 The length of the dividend, no less than a_len_2
+ * @param a_dvs The divisor shifted left by a_shift bits, so that its top bit is set
+ * @param a_len_2 The length of the divisor, at least 2
+ * @param a_shift The number of bits the divisor was shifted by
+ * @param a_top The reciprocal of the top limb of the shifted divisor
+ */
+void div_limbs_preinv(limb_t *a_q, limb_t *a_rem,
+                      const limb_t *a_dvd, size_t a_len_1,
+                      const limb_t *a_dvs, size_t a_len_2,
+                      unsigned a_shift, const LimbDivisor &a_top)
+{
+    // Per-thread buffer, so that dividing small numbers does not allocate.
+    static thread_local vector<limb_t> dvd;
+    dvd.resize(a_len_1 + 1);
+    unsigned shift = a_shift;
+    dvd[a_len_1] = (shift == 0) ? 0 : a_dvd[a_len_1 - 1] >> (LIMB_BITS - shift);
+    for (size_t i = a_len_1; i-- > 1;)
+    {
+        dvd[i] = (shift == 0) ? a_dvd[i] : (a_dvd[i] << shift) | (a_dvd[i - 1] >> (LIMB_BITS - shift));
+    }
+    dvd[0] = a_dvd[0] << shift;
+
+    limb_t dvs_top = a_dvs[a_len_2 - 1];
+    limb_t dvs_next = a_dvs[a_len_2 - 2];
+    for (size_t j = a_len_1 - a_len_2 + 1; j-- > 0;)
+    {
+        limb_t high = dvd[j + a_len_2];
+        limb_t low = dvd[j + a_len_2 - 1];
+        limb_t q_hat;
+        limb_t r_hat;
+        bool r_hat_overflow = false;
+        if (high >= dvs_top)
+        {
+            // The estimate would not fit in a limb. Start from the largest limb, for which
+            // r_hat = high * 2^64 + low - (2^64 - 1) * dvs_top = low + dvs_top.
+            q_hat = ~(limb_t)0;
+            r_hat = low + dvs_top;
+            r_hat_overflow = r_hat < dvs_top;
+        }
+        else
+        {
+            q_hat = a_top.div_2by1(high, low, r_hat);
+        }
+        while (!r_hat_overflow &&
+               (dlimb_t)q_hat * dvs_next > (((dlimb_t)r_hat << LIMB_BITS) | dvd[j + a_len_2 - 2]))
+        {
+            q_hat--;
+            r_hat += dvs_top;
+            r_hat_overflow = r_hat < dvs_top;
+        }
+
+        // Multiply and subtract.
+        limb_t carry = 0;
+        limb_t borrow = 0;
+        for (size_t i = 0; i < a_len_2; i++)
+        {
+            dlimb_t prod = (dlimb_t)q_hat * a_dvs[i] + carry;
+            carry = (limb_t)(prod >> LIMB_BITS);
+            limb_t prod_lo = (limb_t)prod;
+            limb_t lhs = dvd[i + j];
+            limb_t diff = lhs - prod_lo;
+            limb_t borrow_out = (lhs < prod_lo) ? 1 : 0;
+            borrow_out += (diff < borrow) ? 1 : 0;
+            dvd[i + j] = diff - borrow;
+            borrow = borrow_out;
+        }
+        limb_t top = dvd[j + a_len_2];
+        bool went_negative = top < carry || (top - carry) < borrow;
+        dvd[j + a_len_2] = top - carry - borrow;
+
+        // The estimate was one too large. Add the divisor back.
+        if (went_negative)
+        {
+            q_hat--;
+            limb_t add_carry = add_limbs(dvd.data() + j, dvd.data() + j, a_len_2, a_dvs, a_len_2);
+            dvd[j + a_len_2] += add_carry;
+        }
+        a_q[j] = q_hat;
+    }
+
+    for (size_t i = 0; i < a_len_2; i++)
+    {
+        a_rem[i] = (shift == 0) ? dvd[i] : (dvd[i] >> shift) | (dvd[i + 1] << (LIMB_BITS - shift));
+    }
+}
+
+/**
+ * @brief Divide two limb arrays with Knuth's Algorithm D (TAOCP vol. 2, 4.3.1).
+ *
+ * @param a_q The quotient, of a_len_1 - a_len_2 + 1 limbs
+ * @param a_rem The remainder, of a_len_2 limbs
+ * @param a_dvd The dividend
+ * @param a_len_1 The length of the dividend, no less than a_len_2
+ * @param a_dvs The divisor, whose most significant limb is not zero
+ * @param a_len_2 The length of the divisor
+ */
+void div_limbs(limb_t *a_q, limb_t *a_rem,
+               const limb_t *a_dvd, size_t a_len_1,
+               const limb_t *a_dvs, size_t a_len_2)
+{
+    if (a_len_2 == 1)
+    {
+        a_rem[0] = div_1_limbs(a_q, a_dvd, a_len_1, a_dvs[0]);
+        return;
+    }
+
+    // Normalize so that the top bit of the divisor is set, which keeps the quotient estimate off by at most 2.
+    unsigned shift = (unsigned)__builtin_clzll(a_dvs[a_len_2 - 1]);
+    static thread_local vector<limb_t> dvs;
+    dvs.resize(a_len_2);
+    for (size_t i = a_len_2; i-- > 1;)
+    {
+        dvs[i] = (shift == 0) ? a_dvs[i] : (a_dvs[i] << shift) | (a_dvs[i - 1] >> (LIMB_BITS - shift));
+    }
+    dvs[0] = a_dvs[0] << shift;
+    div_limbs_preinv(a_q, a_rem, a_dvd, a_len_1, dvs.data(), a_len_2, shift, LimbDivisor(dvs[a_len_2 - 1]));
+}
+
+/**
+ * @brief Remove the leading zero limbs of a limb vector.
+ *
+ * @param a_vec The vector to be trimmed
+ */
+template <typename Allocator>
+void trim_limb_vector(vector<limb_t, Allocator> &a_vec)
+{
+    while (!a_vec.empty() && a_vec.back() == 0)
+    {
+        a_vec.pop_back();
+    }
+}
+
+/**
+ * @brief Check if a limb vector contains only "zero"s.
+ *
+ * @param a_vec The vector to be checked
+ * @return If the vector contains only "zero"s
+ */
+bool is_zero_vector(const vector<limb_t> &a_vec)
+{
+    for (limb_t limb : a_vec)
+    {
+        if (limb != 0)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Given two trimmed limb vectors, check if the first one is bigger than the second.
+ * @param a_opr_1 The first argument
+ * @param a_opr_2 The second argument
+ * @return If the first value is bigger than the second
+ */
+bool is_the_first_bigger(
+    const vector<limb_t> &a_opr_1,
+    const vector<limb_t> &a_opr_2)
+{
+    return cmp_limbs(a_opr_1.data(), a_opr_1.size(), a_opr_2.data(), a_opr_2.size()) > 0;
+}
+
+/**
+ * @brief Add two limb vectors, then return the result.
+ * @param a_opr_1 The first operand
+ * @param a_opr_2 The second operand
+ * @return The result of addition
+ */
+vector<limb_t> add_limb_vectors(const vector<limb_t> &a_opr_1, const vector<limb_t> &a_opr_2)
+{
+    const vector<limb_t> &opr_longer = (a_opr_1.size() >= a_opr_2.size()) ? a_opr_1 : a_opr_2;
+    const vector<limb_t> &opr_shorter = (a_opr_1.size() >= a_opr_2.size()) ? a_opr_2 : a_opr_1;
+
+    vector<limb_t> result(opr_longer.size() + 1);
+    result[opr_longer.size()] = add_limbs(result.data(),
+                                          opr_longer.data(), opr_longer.size(),
+                                          opr_shorter.data(), opr_shorter.size());
+    trim_limb_vector(result);
+    return result;
+}
+
+/**
+ * @brief Subtract two trimmed limb vectors. Subtract the smaller one from the larger one, then return the result.
+ *
+ * @param a_opr_1 The first operand
+ * @param a_opr_2 The second operand
+ * @return The result of subtraction
+ */
+vector<limb_t> sub_limb_vectors(const vector<limb_t> &a_opr_1, const vector<limb_t> &a_opr_2)
+{
+    bool opr_1_is_bigger = is_the_first_bigger(a_opr_1, a_opr_2);
+    const vector<limb_t> &opr_longer = (opr_1_is_bigger) ? a_opr_1 : a_opr_2;
+    const vector<limb_t> &opr_shorter = (opr_1_is_bigger) ? a_opr_2 : a_opr_1;
+
+    vector<limb_t> result(opr_longer.size());
+    sub_limbs(result.data(),
+              opr_longer.data(), opr_longer.size(),
+              opr_shorter.data(), opr_shorter.size());
+    trim_limb_vector(result);
+    return result;
+}
+
+/*
+ * Instrumentation. Compiling with -DBIGINT_INSTRUMENT makes the arithmetic and conversion entry points
+ * count their calls, time, allocations, operand sizes and algorithm tiers in per-thread counters, which
+ * instrument_snapshot() merges and instrument_dump() prints. Without it the probes compile to nothing.
+ */
+#if defined(BIGINT_INSTRUMENT)
+/**
+ * @brief The operations that BIGINT_INSTRUMENT counts. ToStr covers every conversion to text and Parse
+ *      every conversion from it.
+ */
+enum class InstrumentOp
+{
+    Add,
+    Sub,
+    Mul,
+    Div,
+    ToStr,
+    Parse,
+    Count,
+};
+
+/**
+ * @brief The algorithm tier an operation ran at the top level: Basecase is the schoolbook method of
+ *      each operation, and DivideAndConquer is Burnikel-Ziegler division or the recursive conversions.
+ */
+enum class InstrumentTier
+{
+    Basecase,
+    Karatsuba,
+    Toom3,
+    Ntt,
+    DivideAndConquer,
+    Count,
+};
+
+const char *const INSTRUMENT_OP_NAMES[] = {"add", "sub", "mul", "div", "to_str", "parse"};
+const char *const INSTRUMENT_TIER_NAMES[] = {"basecase", "karatsuba", "toom3", "ntt", "divide_and_conquer"};
+
+/**
+ * @brief The number of buckets of the operand size histogram. Bucket b counts operands of
+ *      [2^(b-1), 2^b) limbs, bucket 0 empty ones, and the last bucket everything above.
+ */
+const size_t INSTRUMENT_SIZE_BUCKETS = 32;
+
+/**
+ * @brief The totals of one operation.
+ */
+struct InstrumentStats
+{
+    uint64_t calls = 0;
+    uint64_t nanoseconds = 0;
+    uint64_t bytes = 0;
+    uint64_t sizes[INSTRUMENT_SIZE_BUCKETS] = {};
+    uint64_t tiers[(size_t)InstrumentTier::Count] = {};
+};
+
+/**
+ * @brief The totals of every operation, over every thread.
+ */
+struct InstrumentSnapshot
+{
+    InstrumentStats ops[(size_t)InstrumentOp::Count];
+
+    const InstrumentStats &operator[](InstrumentOp a_op) const { return ops[(size_t)a_op]; }
+};
+
+/**
+ * @brief The counters of one thread. Only the owning thread writes them, with relaxed atomic stores
+ *      that cost as much as plain ones, so that snapshots may read them from other threads.
+ */
+struct InstrumentCounters
+{
+    struct Op
+    {
+        std::atomic<uint64_t> calls{0};
+        std::atomic<uint64_t> nanoseconds{0};
+        std::atomic<uint64_t> bytes{0};
+        std::atomic<uint64_t> sizes[INSTRUMENT_SIZE_BUCKETS] = {};
+        std::atomic<uint64_t> tiers[(size_t)InstrumentTier::Count] = {};
+    };
+
+    Op ops[(size_t)InstrumentOp::Count];
+    // Bytes this thread has allocated so far, and the tier of the innermost running operation, or
+    // InstrumentTier::Count if none has been chosen yet. Only the owning thread reads these.
+    uint64_t bytes_allocated = 0;
+    InstrumentTier tier = InstrumentTier::Count;
+
+    static void bump(std::atomic<uint64_t> &a_counter, uint64_t a_value)
+    {
+        a_counter.store(a_counter.load(std::memory_order_relaxed) + a_value, std::memory_order_relaxed);
+    }
+
+    void add_to(InstrumentSnapshot &a_snapshot) const
+    {
+        for (size_t i = 0; i < (size_t)InstrumentOp::Count; i++)
+        {
+            InstrumentStats &stats = a_snapshot.ops[i];
+            stats.calls += ops[i].calls.load(std::memory_order_relaxed);
+            stats.nanoseconds += ops[i].nanoseconds.load(std::memory_order_relaxed);
+            stats.bytes += ops[i].bytes.load(std::memory_order_relaxed);
+            for (size_t b = 0; b < INSTRUMENT_SIZE_BUCKETS; b++)
+            {
+                stats.sizes[b] += ops[i].sizes[b].load(std::memory_order_relaxed);
+            }
+            for (size_t t = 0; t < (size_t)InstrumentTier::Count; t++)
+            {
+                stats.tiers[t] += ops[i].tiers[t].load(std::memory_order_relaxed);
+            }
+        }
+    }
+};
+
+/**
+ * @brief The counters of every live thread, and the totals of the threads that have exited.
+ */
+struct InstrumentRegistry
+{
+    std::mutex mutex;
+    vector<const InstrumentCounters *> live;
+    InstrumentSnapshot retired;
+    InstrumentSnapshot baseline;
+};
+
+InstrumentRegistry &instrument_registry()
+{
+    static InstrumentRegistry registry;
+    return registry;
+}
+
+/**
+ * @brief Owns the counters of a thread, registering them on the thread's first operation and folding
+ *      them into the retired totals when the thread exits.
+ */
+class InstrumentThread
+{
+public:
+    InstrumentThread()
+    {
+        InstrumentRegistry &registry = instrument_registry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        registry.live.push_back(&counters);
+    }
+    ~InstrumentThread()
+    {
+        InstrumentRegistry &registry = instrument_registry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        counters.add_to(registry.retired);
+        registry.live.erase(std::find(registry.live.begin(), registry.live.end(), &counters));
+    }
+
+    InstrumentCounters counters;
+};
+
+InstrumentCounters &instrument_counters()
+{
+    static thread_local InstrumentThread thread;
+    return thread.counters;
+}
+
+/**
+ * @brief Note that the running operation allocated memory.
+ *
+ * @param a_bytes The number of bytes
+ */
+void instrument_alloc(size_t a_bytes)
+{
+    instrument_counters().bytes_allocated += a_bytes;
+}
+
+/**
+ * @brief Note the algorithm of the running operation. Only the first tier chosen counts, which is the
+ *      top-level one, since recursion and helper calls come after it.
+ *
+ * @param a_tier The tier
+ */
+void instrument_tier(InstrumentTier a_tier)
+{
+    InstrumentCounters &counters = instrument_counters();
+    if (counters.tier == InstrumentTier::Count)
+    {
+        counters.tier = a_tier;
+    }
+}
+
+/**
+ * @brief Measures one operation from construction to destruction: its time, the bytes allocated
+ *      meanwhile and its tier. Operations nested in it are counted on their own as well.
+ */
+class InstrumentProbe
+{
+public:
+    InstrumentProbe(InstrumentOp a_op, size_t a_limbs)
+        : op(a_op), size(a_limbs), bytes(instrument_counters().bytes_allocated),
+          outer_tier(instrument_counters().tier), start(std::chrono::steady_clock::now())
+    {
+        instrument_counters().tier = InstrumentTier::Count;
+    }
+    InstrumentProbe(const InstrumentProbe &) = delete;
+    InstrumentProbe &operator=(const InstrumentProbe &) = delete;
+    ~InstrumentProbe()
+    {
+        uint64_t nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                   std::chrono::steady_clock::now() - start)
+                                   .count();
+        InstrumentCounters &counters = instrument_counters();
+        InstrumentCounters::Op &stats = counters.ops[(size_t)op];
+        InstrumentCounters::bump(stats.calls, 1);
+        InstrumentCounters::bump(stats.nanoseconds, nanoseconds);
+        InstrumentCounters::bump(stats.bytes, counters.bytes_allocated - bytes);
+        InstrumentCounters::bump(stats.sizes[std::min<size_t>(std::bit_width(size), INSTRUMENT_SIZE_BUCKETS - 1)], 1);
+        InstrumentTier tier = (counters.tier == InstrumentTier::Count) ? InstrumentTier::Basecase : counters.tier;
+        InstrumentCounters::bump(stats.tiers[(size_t)tier], 1);
+        counters.tier = outer_tier;
+    }
+
+private:
+    InstrumentOp op;
+    size_t size;
+    uint64_t bytes;
+    InstrumentTier outer_tier;
+    std::chrono::steady_clock::time_point start;
+};
+
+/**
+ * @brief Return the totals of every thread since the program started or since instrument_reset.
+ *
+ * @return The totals
+ */
+InstrumentSnapshot instrument_snapshot()
+{
+    InstrumentRegistry &registry = instrument_registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    InstrumentSnapshot result = registry.retired;
+    for (const InstrumentCounters *counters : registry.live)
+    {
+        counters->add_to(result);
+    }
+    // Subtract the baseline rather than clearing the counters, which other threads may be writing.
+    for (size_t i = 0; i < (size_t)InstrumentOp::Count; i++)
+    {
+        InstrumentStats &stats = result.ops[i];
+        const InstrumentStats &base = registry.baseline.ops[i];
+        stats.calls -= base.calls;
+        stats.nanoseconds -= base.nanoseconds;
+        stats.bytes -= base.bytes;
+        for (size_t b = 0; b < INSTRUMENT_SIZE_BUCKETS; b++)
+        {
+            stats.sizes[b] -= base.sizes[b];
+        }
+        for (size_t t = 0; t < (size_t)InstrumentTier::Count; t++)
+        {
+            stats.tiers[t] -= base.tiers[t];
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Start counting from zero again.
+ */
+void instrument_reset()
+{
+    InstrumentSnapshot current = instrument_snapshot();
+    InstrumentRegistry &registry = instrument_registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    for (size_t i = 0; i < (size_t)InstrumentOp::Count; i++)
+    {
+        InstrumentStats &base = registry.baseline.ops[i];
+        const InstrumentStats &stats = current.ops[i];
+        base.calls += stats.calls;
+        base.nanoseconds += stats.nanoseconds;
+        base.bytes += stats.bytes;
+        for (size_t b = 0; b < INSTRUMENT_SIZE_BUCKETS; b++)
+        {
+            base.sizes[b] += stats.sizes[b];
+        }
+        for (size_t t = 0; t < (size_t)InstrumentTier::Count; t++)
+        {
+            base.tiers[t] += stats.tiers[t];
+        }
+    }
+}
+
+/**
+ * @brief Print a snapshot, one line per operation that ran: its calls, time, bytes allocated, tiers
+ *      and the nonzero buckets of its size histogram, keyed by the upper bound in limbs.
+ *
+ * @param a_os The stream
+ * @param a_snapshot The snapshot
+ */
+void instrument_dump(ostream &a_os, const InstrumentSnapshot &a_snapshot)
+{
+    for (size_t i = 0; i < (size_t)InstrumentOp::Count; i++)
+    {
+        const InstrumentStats &stats = a_snapshot.ops[i];
+        if (stats.calls == 0)
+        {
+            continue;
+        }
+        a_os << INSTRUMENT_OP_NAMES[i] << ": calls=" << stats.calls << " ns=" << stats.nanoseconds
+             << " ns/call=" << stats.nanoseconds / stats.calls << " bytes=" << stats.bytes << " tiers={";
+        const char *separator = "";
+        for (size_t t = 0; t < (size_t)InstrumentTier::Count; t++)
+        {
+            if (stats.tiers[t] != 0)
+            {
+                a_os << separator << INSTRUMENT_TIER_NAMES[t] << ':' << stats.tiers[t];
+                separator = ",";
+            }
+        }
+        a_os << "} limbs={";
+        separator = "";
+        for (size_t b = 0; b < INSTRUMENT_SIZE_BUCKETS; b++)
+        {
+            if (stats.sizes[b] != 0)
+            {
+                a_os << separator << '<' << ((size_t)1 << b) << ':' << stats.sizes[b];
+                separator = ",";
+            }
+        }
+        a_os << "}\n";
+    }
+}
+
+/**
+ * @brief Print the current totals of every thread.
+ *
+ * @param a_os The stream
+ */
+void instrument_dump(ostream &a_os)
+{
+    instrument_dump(a_os, instrument_snapshot());
+}
+
+#define BIGINT_PROBE(op, limbs) InstrumentProbe bigint_probe(op, limbs)
+#define BIGINT_TIER(tier) instrument_tier(InstrumentTier::tier)
+#define BIGINT_ALLOC(bytes) instrument_alloc(bytes)
+#else
+#define BIGINT_PROBE(op, limbs) ((void)0)
+#define BIGINT_TIER(tier) ((void)0)
+#define BIGINT_ALLOC(bytes) ((void)0)
+#endif
+
+/**
+ * @brief A per-thread stack of memory for the temporaries of the multiplication and conversion kernels,
+ *      in the manner of a bump allocator. Memory is taken from the end of the current chunk and handed
+ *      back all at once when the enclosing ScratchFrame ends, so deallocation does nothing. The chunks
+ *      are kept for reuse, so once a thread has reached its peak working size the kernels stop calling
+ *      malloc. Use it through ScratchFrame.
+ */
+class ScratchArena : public std::pmr::memory_resource
+{
+public:
+    struct Mark
+    {
+        size_t chunk;
+        size_t used;
+    };
+
+    ScratchArena() = default;
+    ScratchArena(const ScratchArena &) = delete;
+    ScratchArena &operator=(const ScratchArena &) = delete;
+    ~ScratchArena();
+
+    Mark mark() const { return {current, used}; }
+    void rewind(const Mark &a_mark)
+    {
+        current = a_mark.chunk;
+        used = a_mark.used;
+    }
+
+private:
+    struct Chunk
+    {
+        std::byte *data;
+        size_t size;
+    };
+
+    vector<Chunk> chunks;
+    size_t current = 0;
+    size_t used = 0;
+
+    void *do_allocate(size_t, size_t) override;
+    void do_deallocate(void *, size_t, size_t) override {}
+    bool do_is_equal(const std::pmr::memory_resource &a_that) const noexcept override { return this == &a_that; }
+};
+
+/**
+ * @brief The size of the first chunk of a scratch arena. Later chunks double in size.
+ */
+const size_t SCRATCH_CHUNK_BYTES = 64 * 1024;
+
+ScratchArena::~ScratchArena()
+{
+    for (const Chunk &chunk : chunks)
+    {
+        ::operator delete(chunk.data);
+    }
+}
+
+/**
+ * @brief Take memory from the current chunk, moving on to the next chunk, or a new one, if it does not fit.
+ */
+void *ScratchArena::do_allocate(size_t a_bytes, size_t a_align)
+{
+    while (true)
+    {
+        if (current < chunks.size())
+        {
+            uintptr_t base = (uintptr_t)chunks[current].data;
+            size_t offset = ((base + used + a_align - 1) & ~(uintptr_t)(a_align - 1)) - base;
+            if (offset + a_bytes <= chunks[current].size)
+            {
+                used = offset + a_bytes;
+                return chunks[current].data + offset;
+            }
+            if (current + 1 < chunks.size())
+            {
+                current++;
+                used = 0;
+                continue;
+            }
+        }
+        size_t size = std::max(a_bytes + a_align, chunks.empty() ? SCRATCH_CHUNK_BYTES : 2 * chunks.back().size);
+        chunks.push_back({static_cast<std::byte *>(::operator new(size)), size});
+        BIGINT_ALLOC(size);
+        current = chunks.size() - 1;
+        used = 0;
+    }
+}
+
+/**
+ * @brief Return the scratch arena of the calling thread.
+ */
+ScratchArena &scratch_arena()
+{
+    static thread_local ScratchArena arena;
+    return arena;
+}
+
+/**
+ * @brief A scope of scratch memory. Everything allocated from the calling thread's arena while the frame
+ *      lives, through limbs() or a scratch_vector, is released when it ends. Frames must end in the
+ *      reverse order of their creation, which holds for frames that are local variables.
+ */
+class ScratchFrame
+{
+public:
+    ScratchFrame() : arena(scratch_arena()), start(arena.mark()) {}
+    ScratchFrame(const ScratchFrame &) = delete;
+    ScratchFrame &operator=(const ScratchFrame &) = delete;
+    ~ScratchFrame() { arena.rewind(start); }
+
+    limb_t *limbs(size_t a_len)
+    {
+        return static_cast<limb_t *>(arena.allocate(a_len * sizeof(limb_t), alignof(limb_t)));
+    }
+
+private:
+    ScratchArena &arena;
+    ScratchArena::Mark start;
+};
+
+/**
+ * @brief A limb vector whose memory comes from the calling thread's scratch arena.
+ */
+using scratch_vector = std::pmr::vector<limb_t>;
+
+/**
+ * @brief A fixed set of worker threads for fork-join parallelism inside the kernels. run() queues all but
+ *      the first of a batch of tasks, runs the first on the calling thread, then helps with the queued
+ *      tasks of that batch, and only those, until the whole batch is done. Tasks may call run() again;
+ *      since a waiting thread keeps working on its own batch, nested batches cannot starve the pool.
+ *      Tasks must not wait on each other in any other way, and must not hold a lock across a call to
+ *      run().
+ */
+class ThreadPool
+{
+public:
+    explicit ThreadPool(size_t);
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+    ~ThreadPool();
+
+    size_t size() const { return workers.size(); }
+
+    template <typename Task>
+    void run(size_t, const Task &);
+
+private:
+    struct Job
+    {
+        const void *task;
+        void (*call)(const void *, size_t);
+        size_t index;
+        bool done;
+        std::exception_ptr error;
+    };
+
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::deque<Job *> queue;
+    vector<std::thread> workers;
+    bool stopping = false;
+
+    void work();
+    void execute(Job *, std::unique_lock<std::mutex> &);
+};
+
+/**
+ * @brief Constructor. Starts the worker threads.
+ *
+ * @param a_threads The number of worker threads. The threads that call run() work as well.
+ */
+ThreadPool::ThreadPool(size_t a_threads)
+{
+    for (size_t i = 0; i < a_threads; i++)
+    {
+        workers.emplace_back(&ThreadPool::work, this);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    changed.notify_all();
+    for (std::thread &worker : workers)
+    {
+        worker.join();
+    }
+}
+
+/**
+ * @brief Private method. Run a job taken off the queue without holding the lock, then mark it done.
+ */
+void ThreadPool::execute(Job *a_job, std::unique_lock<std::mutex> &a_lock)
+{
+    a_lock.unlock();
+    try
+    {
+        a_job->call(a_job->task, a_job->index);
+    }
+    catch (...)
+    {
+        a_job->error = std::current_exception();
+    }
+    a_lock.lock();
+    a_job->done = true;
+    changed.notify_all();
+}
+
+/**
+ * @brief Private method. The loop of a worker thread, which takes the oldest, and so largest, job first.
+ */
+void ThreadPool::work()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true)
+    {
+        changed.wait(lock, [this] { return stopping || !queue.empty(); });
+        if (queue.empty())
+        {
+            return;
+        }
+        Job *job = queue.front();
+        queue.pop_front();
+        execute(job, lock);
+    }
+}
+
+/**
+ * @brief Call a_task(0) .. a_task(a_count - 1), in parallel, and return when all have finished. If any
+ *      throws, one of the exceptions is rethrown once all have finished.
+ *
+ * @param a_count The number of calls
+ * @param a_task The callable, taking the index of the call
+ */
+template <typename Task>
+void ThreadPool::run(size_t a_count, const Task &a_task)
+{
+    if (a_count == 0)
+    {
+        return;
+    }
+    vector<Job> jobs(a_count - 1);
+    auto call = [](const void *a_context, size_t a_index) { (*static_cast<const Task *>(a_context))(a_index); };
+    std::unique_lock<std::mutex> lock(mutex);
+    for (size_t i = 0; i < jobs.size(); i++)
+    {
+        jobs[i] = {&a_task, call, i + 1, false, nullptr};
+        queue.push_back(&jobs[i]);
+    }
+    changed.notify_all();
+    lock.unlock();
+
+    std::exception_ptr error;
+    try
+    {
+        a_task(0);
+    }
+    catch (...)
+    {
+        error = std::current_exception();
+    }
+
+    // Help with this batch's queued jobs, newest first, until the whole batch is done. Jobs of other
+    // batches are left alone: this thread may be inside a kernel that keeps state in thread_local
+    // buffers, and a foreign job could re-enter that kernel and overwrite them.
+    auto own = [&](Job *a_job) { return a_job >= jobs.data() && a_job < jobs.data() + jobs.size(); };
+    lock.lock();
+    for (Job &job : jobs)
+    {
+        while (!job.done)
+        {
+            auto next = std::find_if(queue.rbegin(), queue.rend(), own);
+            if (next != queue.rend())
+            {
+                Job *mine = *next;
+                queue.erase(std::next(next).base());
+                execute(mine, lock);
+            }
+            else
+            {
+                changed.wait(lock);
+            }
+        }
+        if (job.error && !error)
+        {
+            error = job.error;
+        }
+    }
+    lock.unlock();
+    if (error)
+    {
+        std::rethrow_exception(error);
+    }
+}
+
+/**
+ * @brief The opt-in parallel mode. Setting pool to a ThreadPool lets the kernels split work across it
+ *      once the operands reach the given sizes; with no pool, as by default, everything runs on the
+ *      calling thread.
+ */
+struct ParallelSettings
+{
+    ThreadPool *pool = nullptr;
+    // Karatsuba and Toom-3 run their sub-products in parallel from this many limbs of the shorter operand.
+    size_t mul = 2000;
+    // NTT multiplication transforms the three primes in parallel, and splits each butterfly stage, from
+    // this transform length.
+    size_t ntt = (size_t)1 << 14;
+    // Decimal output converts both halves of a split in parallel from this many limbs.
+    size_t to_str = 2000;
+    // Decimal parsing converts both halves of a split in parallel from this many digits.
+    size_t parse = 40000;
+};
+
+ParallelSettings parallel_settings;
+
+/**
+ * @brief Call a_task(0) .. a_task(a_count - 1) on the thread pool if one is set and the work is large
+ *      enough, or one after another on the calling thread otherwise.
+ *
+ * @param a_count The number of calls
+ * @param a_size The size of the work, in the unit of the threshold
+ * @param a_threshold The size from which to go parallel
+ * @param a_task The callable, taking the index of the call
+ */
+template <typename Task>
+void parallel_run(size_t a_count, size_t a_size, size_t a_threshold, const Task &a_task)
+{
+    ThreadPool *pool = parallel_settings.pool;
+    if (pool == nullptr || pool->size() == 0 || a_size < a_threshold)
+    {
+        for (size_t i = 0; i < a_count; i++)
+        {
+            a_task(i);
+        }
+        return;
+    }
+    pool->run(a_count, a_task);
+}
+
+/**
+ * @brief The multiplication algorithms, for forcing one through mul().
+ */
+enum class MulAlgorithm
+{
+    Auto,
+    Schoolbook,
+    Karatsuba,
+    Toom3,
+    Ntt,
+};
+
+void mul_limbs(limb_t *a_r,
+               const limb_t *a_mnd, size_t a_len_1,
+               const limb_t *a_mer, size_t a_len_2,
+               MulAlgorithm a_algorithm = MulAlgorithm::Auto);
+void sqr_limbs(limb_t *a_r, const limb_t *a_opr, size_t a_len, MulAlgorithm a_algorithm = MulAlgorithm::Auto);
+
+/**
+ * @brief Multiply two limb vectors, then return the result.
+ *
+ * @param a_mnd The number to be multiplied
+ * @param a_mer The multiplier
+ * @param a_algorithm The algorithm to use at the top level
+ * @return The result of multiplication
+ */
+vector<limb_t> mul_limb_vectors(const vector<limb_t> &a_mnd, const vector<limb_t> &a_mer,
+                                MulAlgorithm a_algorithm = MulAlgorithm::Auto)
+{
+    if (a_mnd.empty() || a_mer.empty())
+    {
+        return vector<limb_t>();
+    }
+    vector<limb_t> result(a_mnd.size() + a_mer.size());
+    mul_limbs(result.data(), a_mnd.data(), a_mnd.size(), a_mer.data(), a_mer.size(), a_algorithm);
+    trim_limb_vector(result);
+    return result;
+}
+
+/**
+ * @brief Operand sizes, in limbs of the shorter operand, at which multiplication switches algorithm.
+ *      They may be changed at run time through mul_thresholds.
+ */
+struct MulThresholds
+{
+    // Below this, use the schoolbook method.
+    size_t karatsuba = 32;
+    // At or above this, use Toom-3 instead of Karatsuba.
+    size_t toom3 = 256;
+    // At or above this, use number-theoretic transforms.
+    size_t ntt = 5000;
+    // Below this, square with the schoolbook method, which does half the work of a general product.
+    size_t sqr_karatsuba = 48;
+    // At or above this, square with Toom-3 instead of Karatsuba.
+    size_t sqr_toom3 = 400;
+};
+
+/**
+ * @brief The thresholds used by mul_limbs.
+ */
+MulThresholds mul_thresholds;
+
+/**
+ * @brief Add a limb vector into a limb array at a limb offset. The sum must fit in the array.
+ *
+ * @param a_r The array to be added to
+ * @param a_len The length of the array
+ * @param a_opr The vector to be added
+ * @param a_offset The offset, in limbs, at which to add
+ */
+template <typename Allocator>
+void add_limbs_at(limb_t *a_r, size_t a_len, const vector<limb_t, Allocator> &a_opr, size_t a_offset)
+{
+    size_t opr_len = a_opr.size();
+    while (opr_len > 0 && a_opr[opr_len - 1] == 0)
+    {
+        opr_len--;
+    }
+    if (opr_len > 0)
+    {
+        add_limbs(a_r + a_offset, a_r + a_offset, a_len - a_offset, a_opr.data(), opr_len);
+    }
+}
+
+/**
+ * @brief Multiply two limb arrays with Karatsuba's method, splitting both at half the length of the first.
+ *
+ * @param a_r The output of a_len_1 + a_len_2 limbs, which must not alias either operand
+ * @param a_mnd The number to be multiplied
+ * @param a_len_1 The length of the number to be multiplied
+ * @param a_mer The multiplier
+ * @param a_len_2 The length of the multiplier, greater than half of a_len_1 and no greater than a_len_1
+ */
+void mul_limbs_karatsuba(limb_t *a_r,
+                         const limb_t *a_mnd, size_t a_len_1,
+                         const limb_t *a_mer, size_t a_len_2)
+{
+    size_t half = (a_len_1 + 1) / 2;
+    size_t len_r = a_len_1 + a_len_2;
+
+    ScratchFrame frame;
+    limb_t *sum_1 = frame.limbs(half + 1);
+    limb_t *sum_2 = frame.limbs(half + 1);
+    sum_1[half] = add_limbs(sum_1, a_mnd, half, a_mnd + half, a_len_1 - half);
+    sum_2[half] = add_limbs(sum_2, a_mer, half, a_mer + half, a_len_2 - half);
+    scratch_vector mid(2 * half + 2, &scratch_arena());
+
+    // z0 = a0 * b0 goes to the bottom and z2 = a1 * b1 to the top of the output, and
+    // z1 = (a0 + a1) * (b0 + b1) - z0 - z2 is added in the middle. The three products are independent.
+    parallel_run(3, a_len_2, parallel_settings.mul, [&](size_t a_i) {
+        if (a_i == 0)
+        {
+            mul_limbs(a_r, a_mnd, half, a_mer, half);
+        }
+        else if (a_i == 1)
+        {
+            mul_limbs(a_r + 2 * half, a_mnd + half, a_len_1 - half, a_mer + half, a_len_2 - half);
+        }
+        else
+        {
+            mul_limbs(mid.data(), sum_1, half + 1, sum_2, half + 1);
+        }
+    });
+    sub_limbs(mid.data(), mid.data(), mid.size(), a_r, 2 * half);
+    sub_limbs(mid.data(), mid.data(), mid.size(), a_r + 2 * half, len_r - 2 * half);
+
+    add_limbs_at(a_r, len_r, mid, half);
+}
+
+/**
+ * @brief Square a limb array with Karatsuba's method, as mul_limbs_karatsuba with both operands the same,
+ *      so that there is one sum to form and all three sub-products are squares.
+ *
+ * @param a_r The output of 2 * a_len limbs, which must not alias the operand
+ * @param a_opr The number to be squared
+ * @param a_len The length of the number, at least 4
+ */
+void sqr_limbs_karatsuba(limb_t *a_r, const limb_t *a_opr, size_t a_len)
+{
+    size_t half = (a_len + 1) / 2;
+    size_t len_r = 2 * a_len;
+
+    ScratchFrame frame;
+    limb_t *sum = frame.limbs(half + 1);
+    sum[half] = add_limbs(sum, a_opr, half, a_opr + half, a_len - half);
+    scratch_vector mid(2 * half + 2, &scratch_arena());
+
+    parallel_run(3, a_len, parallel_settings.mul, [&](size_t a_i) {
+        if (a_i == 0)
+        {
+            sqr_limbs(a_r, a_opr, half);
+        }
+        else if (a_i == 1)
+        {
+            sqr_limbs(a_r + 2 * half, a_opr + half, a_len - half);
+        }
+        else
+        {
+            sqr_limbs(mid.data(), sum, half + 1);
+        }
+    });
+    sub_limbs(mid.data(), mid.data(), mid.size(), a_r, 2 * half);
+    sub_limbs(mid.data(), mid.data(), mid.size(), a_r + 2 * half, len_r - 2 * half);
+
+    add_limbs_at(a_r, len_r, mid, half);
+}
+
+/**
+ * @brief A signed limb vector, for the negative intermediate values of Toom-Cook interpolation. The
+ *      magnitude lives in the scratch arena, so these must only be made inside a ScratchFrame.
+ */
+struct SignedLimbs
+{
+    bool is_negative = false;
+    scratch_vector mag = scratch_vector(&scratch_arena());
+};
+
+/**
+ * @brief Add two signed limb vectors.
+ *
+ * @param a_opr_1 The first operand
+ * @param a_opr_2 The second operand
+ * @param a_negate_2 If the second operand should be subtracted instead
+ * @return The sum
+ */
+SignedLimbs add_signed_limbs(const SignedLimbs &a_opr_1, const SignedLimbs &a_opr_2, bool a_negate_2 = false)
+{
+    SignedLimbs result;
+    bool negative_2 = (a_opr_2.is_negative != a_negate_2);
+    if (a_opr_1.is_negative == negative_2)
+    {
+        bool opr_1_is_longer = a_opr_1.mag.size() >= a_opr_2.mag.size();
+        const scratch_vector &opr_longer = opr_1_is_longer ? a_opr_1.mag : a_opr_2.mag;
+        const scratch_vector &opr_shorter = opr_1_is_longer ? a_opr_2.mag : a_opr_1.mag;
+        result.mag.resize(opr_longer.size() + 1);
+        result.mag[opr_longer.size()] = add_limbs(result.mag.data(), opr_longer.data(), opr_longer.size(),
+                                                  opr_shorter.data(), opr_shorter.size());
+        result.is_negative = a_opr_1.is_negative;
+    }
+    else
+    {
+        bool opr_1_is_bigger = cmp_limbs(a_opr_1.mag.data(), a_opr_1.mag.size(), a_opr_2.mag.data(), a_opr_2.mag.size()) > 0;
+        const scratch_vector &opr_bigger = opr_1_is_bigger ? a_opr_1.mag : a_opr_2.mag;
+        const scratch_vector &opr_smaller = opr_1_is_bigger ? a_opr_2.mag : a_opr_1.mag;
+        result.mag.resize(opr_bigger.size());
+        sub_limbs(result.mag.data(), opr_bigger.data(), opr_bigger.size(), opr_smaller.data(), opr_smaller.size());
+        result.is_negative = opr_1_is_bigger ? a_opr_1.is_negative : negative_2;
+    }
+    trim_limb_vector(result.mag);
+    if (result.mag.empty())
+    {
+        result.is_negative = false;
+    }
+    return result;
+}
+
+/**
+ * @brief Subtract two signed limb vectors.
+ *
+ * @param a_opr_1 The minuend
+ * @param a_opr_2 The subtrahend
+ * @return The difference
+ */
+SignedLimbs sub_signed_limbs(const SignedLimbs &a_opr_1, const SignedLimbs &a_opr_2)
+{
+    return add_signed_limbs(a_opr_1, a_opr_2, true);
+}
+
+/**
+ * @brief Divide a signed limb vector by a small number that is known to divide it exactly.
+ *
+ * @param a_opr The dividend
+ * @param a_dvs The divisor
+ * @return The quotient
+ */
+SignedLimbs div_exact_signed_limbs(SignedLimbs a_opr, limb_t a_dvs)
+{
+    div_1_limbs(a_opr.mag.data(), a_opr.mag.data(), a_opr.mag.size(), a_dvs);
+    trim_limb_vector(a_opr.mag);
+    if (a_opr.mag.empty())
+    {
+        a_opr.is_negative = false;
+    }
+    return a_opr;
+}
+
+/**
+ * @brief Evaluate a0 + a1 x + a2 x^2 at x = 0, 1, -1 and -2 for Toom-3.
+ *
+ * @param a_points The values at 0, 1, -1 and -2, then the top piece
+ * @param a_opr The limbs of the operand
+ * @param a_len The length of the operand
+ * @param a_third The length of a piece. The last piece holds the remaining limbs.
+ */
+void toom3_evaluate(SignedLimbs (&a_points)[5], const limb_t *a_opr, size_t a_len, size_t a_third)
+{
+    SignedLimbs piece_0;
+    SignedLimbs piece_1;
+    SignedLimbs piece_2;
+    piece_0.mag.assign(a_opr, a_opr + a_third);
+    piece_1.mag.assign(a_opr + a_third, a_opr + 2 * a_third);
+    piece_2.mag.assign(a_opr + 2 * a_third, a_opr + a_len);
+    trim_limb_vector(piece_0.mag);
+    trim_limb_vector(piece_1.mag);
+    trim_limb_vector(piece_2.mag);
+
+    SignedLimbs even = add_signed_limbs(piece_0, piece_2);
+    a_points[1] = add_signed_limbs(even, piece_1);
+    a_points[2] = sub_signed_limbs(even, piece_1);
+    // p(-2) = 2 * (p(-1) + a2) - a0
+    SignedLimbs at_m2 = add_signed_limbs(a_points[2], piece_2);
+    a_points[3] = sub_signed_limbs(add_signed_limbs(at_m2, at_m2), piece_0);
+    a_points[0] = std::move(piece_0);
+    a_points[4] = std::move(piece_2);
+}
+
+/**
+ * @brief Interpolate the five pointwise products of Toom-3 into the product with Bodrato's sequence.
+ *
+ * @param a_r The output
+ * @param a_len_r The length of the output
+ * @param a_third The length of a piece of the operands
+ * @param a_w The products at 0, 1, -1, -2 and infinity, which are trimmed here
+ */
+void toom3_interpolate(limb_t *a_r, size_t a_len_r, size_t a_third, SignedLimbs (&a_w)[5])
+{
+    for (SignedLimbs &product : a_w)
+    {
+        trim_limb_vector(product.mag);
+        product.is_negative = product.is_negative && !product.mag.empty();
+    }
+    const SignedLimbs &w_0 = a_w[0];
+    const SignedLimbs &w_1 = a_w[1];
+    const SignedLimbs &w_m1 = a_w[2];
+    const SignedLimbs &w_m2 = a_w[3];
+    const SignedLimbs &w_inf = a_w[4];
+
+    SignedLimbs r_3 = div_exact_signed_limbs(sub_signed_limbs(w_m2, w_1), 3);
+    SignedLimbs r_1 = div_exact_signed_limbs(sub_signed_limbs(w_1, w_m1), 2);
+    SignedLimbs r_2 = sub_signed_limbs(w_m1, w_0);
+    r_3 = add_signed_limbs(div_exact_signed_limbs(sub_signed_limbs(r_2, r_3), 2), add_signed_limbs(w_inf, w_inf));
+    r_2 = sub_signed_limbs(add_signed_limbs(r_2, r_1), w_inf);
+    r_1 = sub_signed_limbs(r_1, r_3);
+
+    // The coefficients of the product are non-negative, so only the magnitudes are needed.
+    std::fill(a_r, a_r + a_len_r, 0);
+    add_limbs_at(a_r, a_len_r, w_0.mag, 0);
+    add_limbs_at(a_r, a_len_r, r_1.mag, a_third);
+    add_limbs_at(a_r, a_len_r, r_2.mag, 2 * a_third);
+    add_limbs_at(a_r, a_len_r, r_3.mag, 3 * a_third);
+    add_limbs_at(a_r, a_len_r, w_inf.mag, 4 * a_third);
+}
+
+/**
+ * @brief Multiply two limb arrays with the Toom-3 method, evaluating at 0, 1, -1, -2 and infinity
+ *      and interpolating with Bodrato's sequence.
+ *
+ * @param a_r The output of a_len_1 + a_len_2 limbs, which must not alias either operand
+ * @param a_mnd The number to be multiplied
+ * @param a_len_1 The length of the number to be multiplied
+ * @param a_mer The multiplier
+ * @param a_len_2 The length of the multiplier, greater than two thirds of a_len_1 and no greater than a_len_1
+ */
+void mul_limbs_toom3(limb_t *a_r,
+                     const limb_t *a_mnd, size_t a_len_1,
+                     const limb_t *a_mer, size_t a_len_2)
+{
+    size_t third = (a_len_1 + 2) / 3;
+    size_t len_r = a_len_1 + a_len_2;
+
+    ScratchFrame frame;
+    SignedLimbs points_1[5];
+    SignedLimbs points_2[5];
+    toom3_evaluate(points_1, a_mnd, a_len_1, third);
+    toom3_evaluate(points_2, a_mer, a_len_2, third);
+    // The five pointwise products are independent. Their outputs are made here, so that a product run
+    // on another thread does not leave its result in that thread's scratch arena.
+    SignedLimbs w[5];
+    for (size_t i = 0; i < 5; i++)
+    {
+        w[i].is_negative = (points_1[i].is_negative != points_2[i].is_negative);
+        w[i].mag.resize(points_1[i].mag.size() + points_2[i].mag.size());
+    }
+    parallel_run(5, a_len_2, parallel_settings.mul, [&](size_t a_i) {
+        if (!points_1[a_i].mag.empty() && !points_2[a_i].mag.empty())
+        {
+            mul_limbs(w[a_i].mag.data(), points_1[a_i].mag.data(), points_1[a_i].mag.size(),
+                      points_2[a_i].mag.data(), points_2[a_i].mag.size());
+        }
+    });
+    toom3_interpolate(a_r, len_r, third, w);
+}
+
+/**
+ * @brief Square a limb array with the Toom-3 method. The operand is evaluated once, and the five pointwise
+ *      products are squares.
+ *
+ * @param a_r The output of 2 * a_len limbs, which must not alias the operand
+ * @param a_opr The number to be squared
+ * @param a_len The length of the number, at least 5
+ */
+void sqr_limbs_toom3(limb_t *a_r, const limb_t *a_opr, size_t a_len)
+{
+    size_t third = (a_len + 2) / 3;
+
+    ScratchFrame frame;
+    SignedLimbs points[5];
+    toom3_evaluate(points, a_opr, a_len, third);
+    SignedLimbs w[5];
+    for (size_t i = 0; i < 5; i++)
+    {
+        w[i].mag.resize(2 * points[i].mag.size());
+    }
+    parallel_run(5, a_len, parallel_settings.mul, [&](size_t a_i) {
+        if (!points[a_i].mag.empty())
+        {
+            sqr_limbs(w[a_i].mag.data(), points[a_i].mag.data(), points[a_i].mag.size());
+        }
+    });
+    toom3_interpolate(a_r, 2 * a_len, third, w);
+}
+
+/**
+ * @brief A prime of the form c * 2^k + 1 below 2^62, used as an NTT modulus, with a generator of its
+ *      multiplicative group.
+ */
+struct NttPrime
+{
+    limb_t modulus;
+    limb_t generator;
+};
+
+/**
+ * @brief The three NTT moduli. Their product exceeds 2^185, which bounds every coefficient of a product of
+ *      limb arrays with up to 2^41 limbs.
+ */
+const NttPrime NTT_PRIMES[3] = {
+    {4611615649683210241ULL, 11}, // 65535 * 2^46 + 1
+    {4611613450659954689ULL, 3},  // 2097119 * 2^41 + 1
+    {4611549678985543681ULL, 19}, // 1048545 * 2^42 + 1
+};
+
+/**
+ * @brief The largest transform length supported by every NTT modulus, as a power of two.
+ */
+const unsigned NTT_MAX_LOG = 41;
+
+/**
+ * @brief Raise a number to a power modulo a limb. Slow; only used to set up constants.
+ *
+ * @param a_base The base
+ * @param a_exp The exponent
+ * @param a_mod The modulus
+ * @return a_base ^ a_exp mod a_mod
+ */
+limb_t pow_mod_limb(limb_t a_base, limb_t a_exp, limb_t a_mod)
+{
+    dlimb_t result = 1 % a_mod;
+    dlimb_t base = a_base % a_mod;
+    while (a_exp > 0)
+    {
+        if (a_exp & 1)
+        {
+            result = result * base % a_mod;
+        }
+        base = base * base % a_mod;
+        a_exp >>= 1;
+    }
+    return (limb_t)result;
+}
+
+/**
+ * @brief Arithmetic modulo an odd limb below 2^63, with products reduced by Montgomery's method (R = 2^64).
+ */
+class MontgomeryLimb
+{
+public:
+    explicit MontgomeryLimb(limb_t);
+
+    limb_t modulus;
+    // -modulus^-1 mod 2^64
+    limb_t neg_inv;
+    // R^2 mod modulus
+    limb_t r_squared;
+
+    /**
+     * @brief Return a * b / R mod the modulus, for a * b < modulus * R.
+     */
+    limb_t mul(limb_t a_opr_1, limb_t a_opr_2) const
+    {
+        dlimb_t prod = (dlimb_t)a_opr_1 * a_opr_2;
+        limb_t m = (limb_t)prod * neg_inv;
+        limb_t result = (limb_t)((prod + (dlimb_t)m * modulus) >> LIMB_BITS);
+        return (result >= modulus) ? result - modulus : result;
+    }
+    limb_t add(limb_t a_opr_1, limb_t a_opr_2) const
+    {
+        limb_t result = a_opr_1 + a_opr_2;
+        return (result >= modulus) ? result - modulus : result;
+    }
+    limb_t sub(limb_t a_opr_1, limb_t a_opr_2) const
+    {
+        return (a_opr_1 >= a_opr_2) ? a_opr_1 - a_opr_2 : a_opr_1 + modulus - a_opr_2;
+    }
+    /**
+     * @brief Return a * R mod the modulus, the Montgomery form of a.
+     */
+    limb_t to_mont(limb_t a_opr) const
+    {
+        return mul(a_opr, r_squared);
+    }
+};
+
+MontgomeryLimb::MontgomeryLimb(limb_t a_modulus)
+{
+    modulus = a_modulus;
+    // Newton's iteration doubles the number of correct low bits of the inverse each step.
+    limb_t inv = a_modulus;
+    for (int i = 0; i < 5; i++)
+    {
+        inv *= 2 - a_modulus * inv;
+    }
+    neg_inv = (limb_t)0 - inv;
+    limb_t r_mod = (limb_t)(((dlimb_t)1 << LIMB_BITS) % a_modulus);
+    r_squared = (limb_t)((dlimb_t)r_mod * r_mod % a_modulus);
+}
+
+/**
+ * @brief Return how many pieces to split each stage of a transform into: one per thread of the pool
+ *      for long transforms in parallel mode, and one otherwise.
+ *
+ * @param a_n The length of the transform
+ * @return The number of pieces
+ */
+size_t ntt_pieces(size_t a_n)
+{
+    ThreadPool *pool = parallel_settings.pool;
+    return (pool != nullptr && a_n >= parallel_settings.ntt) ? pool->size() + 1 : 1;
+}
+
+/**
+ * @brief Run butterflies a_first .. a_last - 1 of one decimation-in-frequency stage. Butterfly b pairs
+ *      entries i + j and i + j + len, where i = (b / len) * 2 * len and j = b % len.
+ *
+ * @param a_data The array
+ * @param a_field The modulus
+ * @param a_roots The roots given to ntt_forward
+ * @param a_len The distance between the entries of a butterfly
+ * @param a_stride The step through the roots
+ * @param a_first The first butterfly
+ * @param a_last One past the last butterfly
+ */
+void ntt_forward_stage(limb_t *a_data, const MontgomeryLimb &a_field, const limb_t *a_roots,
+                       size_t a_len, size_t a_stride, size_t a_first, size_t a_last)
+{
+    size_t i = (a_first / a_len) * 2 * a_len;
+    size_t j = a_first % a_len;
+    for (size_t b = a_first; b < a_last; i += 2 * a_len, j = 0)
+    {
+        size_t j_end = std::min(a_len, j + (a_last - b));
+        b += j_end - j;
+        for (; j < j_end; j++)
+        {
+            limb_t u = a_data[i + j];
+            limb_t v = a_data[i + j + a_len];
+            a_data[i + j] = a_field.add(u, v);
+            a_data[i + j + a_len] = a_field.mul(a_field.sub(u, v), a_roots[j * a_stride]);
+        }
+    }
+}
+
+/**
+ * @brief Run butterflies a_first .. a_last - 1 of one decimation-in-time stage, numbered as in
+ *      ntt_forward_stage.
+ *
+ * @param a_data The array
+ * @param a_field The modulus
+ * @param a_roots The roots given to ntt_inverse
+ * @param a_len The distance between the entries of a butterfly
+ * @param a_stride The step through the roots
+ * @param a_first The first butterfly
+ * @param a_last One past the last butterfly
+ */
+void ntt_inverse_stage(limb_t *a_data, const MontgomeryLimb &a_field, const limb_t *a_roots,
+                       size_t a_len, size_t a_stride, size_t a_first, size_t a_last)
+{
+    size_t i = (a_first / a_len) * 2 * a_len;
+    size_t j = a_first % a_len;
+    for (size_t b = a_first; b < a_last; i += 2 * a_len, j = 0)
+    {
+        size_t j_end = std::min(a_len, j + (a_last - b));
+        b += j_end - j;
+        for (; j < j_end; j++)
+        {
+            limb_t u = a_data[i + j];
+            limb_t v = a_field.mul(a_data[i + j + a_len], a_roots[j * a_stride]);
+            a_data[i + j] = a_field.add(u, v);
+            a_data[i + j + a_len] = a_field.sub(u, v);
+        }
+    }
+}
+
+/**
+ * @brief Transform an array in place, in decimation-in-frequency order. The output is bit-reversed.
+ *      In parallel mode, the butterflies of each stage of a long transform are shared among the threads.
+ *
+ * @param a_data The array, with entries below the modulus
+ * @param a_n The length of the array, a power of two
+ * @param a_field The modulus
+ * @param a_roots Powers 0 .. n/2 - 1 of a primitive n-th root of unity, in Montgomery form
+ */
+void ntt_forward(limb_t *a_data, size_t a_n, const MontgomeryLimb &a_field, const limb_t *a_roots)
+{
+    size_t pieces = ntt_pieces(a_n);
+    size_t butterflies = a_n / 2;
+    for (size_t len = a_n / 2, stride = 1; len >= 1; len >>= 1, stride <<= 1)
+    {
+        parallel_run(pieces, a_n, parallel_settings.ntt, [&](size_t a_piece) {
+            ntt_forward_stage(a_data, a_field, a_roots, len, stride,
+                              butterflies * a_piece / pieces, butterflies * (a_piece + 1) / pieces);
+        });
+    }
+}
+
+/**
+ * @brief Undo ntt_forward in decimation-in-time order, without dividing by the length. The input is bit-reversed.
+ *
+ * @param a_data The array, with entries below the modulus
+ * @param a_n The length of the array, a power of two
+ * @param a_field The modulus
+ * @param a_roots Powers 0 .. n/2 - 1 of the inverse of the root given to ntt_forward, in Montgomery form
+ */
+void ntt_inverse(limb_t *a_data, size_t a_n, const MontgomeryLimb &a_field, const limb_t *a_roots)
+{
+    size_t pieces = ntt_pieces(a_n);
+    size_t butterflies = a_n / 2;
+    for (size_t len = 1, stride = a_n / 2; len < a_n; len <<= 1, stride >>= 1)
+    {
+        parallel_run(pieces, a_n, parallel_settings.ntt, [&](size_t a_piece) {
+            ntt_inverse_stage(a_data, a_field, a_roots, len, stride,
+                              butterflies * a_piece / pieces, butterflies * (a_piece + 1) / pieces);
+        });
+    }
+}
+
+/**
+ * @brief Compute the cyclic convolution of two limb arrays modulo one NTT prime.
+ *
+ * @param a_prime The NTT prime
+ * @param a_log_n The base-2 logarithm of the transform length
+ * @param a_mnd The number to be multiplied
+ * @param a_len_1 The length of the number to be multiplied
+ * @param a_mer The multiplier
+ * @param a_len_2 The length of the multiplier
+ * @param a_result The array that accepts the first a_len_1 + a_len_2 - 1 coefficients of the product,
+ *      modulo the prime. If both operands are the same array, it is transformed once.
+ */
+void ntt_convolve(const NttPrime &a_prime, unsigned a_log_n,
+                  const limb_t *a_mnd, size_t a_len_1,
+                  const limb_t *a_mer, size_t a_len_2, limb_t *a_result)
+{
+    ScratchFrame frame;
+    MontgomeryLimb field(a_prime.modulus);
+    limb_t p = a_prime.modulus;
+    size_t n = (size_t)1 << a_log_n;
+
+    limb_t root = pow_mod_limb(a_prime.generator, (p - 1) >> a_log_n, p);
+    limb_t root_inv = pow_mod_limb(root, p - 2, p);
+    limb_t *roots = frame.limbs(n / 2);
+    limb_t *roots_inv = frame.limbs(n / 2);
+    limb_t root_mont = field.to_mont(root);
+    limb_t root_inv_mont = field.to_mont(root_inv);
+    limb_t one_mont = field.to_mont(1);
+    for (size_t i = 0; i < n / 2; i++)
+    {
+        roots[i] = (i == 0) ? one_mont : field.mul(roots[i - 1], root_mont);
+        roots_inv[i] = (i == 0) ? one_mont : field.mul(roots_inv[i - 1], root_inv_mont);
+    }
+
+    // A square needs only one forward transform, which is multiplied by itself.
+    bool square = (a_mnd == a_mer && a_len_1 == a_len_2);
+    limb_t *data_1 = frame.limbs(n);
+    limb_t *data_2 = square ? data_1 : frame.limbs(n);
+    std::fill(data_1 + a_len_1, data_1 + n, 0);
+    for (size_t i = 0; i < a_len_1; i++)
+    {
+        data_1[i] = a_mnd[i] % p;
+    }
+    ntt_forward(data_1, n, field, roots);
+    if (!square)
+    {
+        std::fill(data_2 + a_len_2, data_2 + n, 0);
+        for (size_t i = 0; i < a_len_2; i++)
+        {
+            data_2[i] = a_mer[i] % p;
+        }
+        ntt_forward(data_2, n, field, roots);
+    }
+
+    // The pointwise product leaves a factor of 1/R, which the scale puts back along with 1/n.
+    limb_t n_inv = pow_mod_limb(n % p, p - 2, p);
+    limb_t scale = field.to_mont(field.to_mont(n_inv));
+    for (size_t i = 0; i < n; i++)
+    {
+        data_1[i] = field.mul(field.mul(data_1[i], data_2[i]), scale);
+    }
+    ntt_inverse(data_1, n, field, roots_inv);
+    std::copy(data_1, data_1 + a_len_1 + a_len_2 - 1, a_result);
+}
+
+/**
+ * @brief Multiply two limb arrays with number-theoretic transforms modulo three primes, then recombine
+ *      the coefficients with the Chinese remainder theorem (Garner's method).
+ *
+ * @param a_r The output of a_len_1 + a_len_2 limbs, which must not alias either operand
+ * @param a_mnd The number to be multiplied
+ * @param a_len_1 The length of the number to be multiplied, not zero
+ * @param a_mer The multiplier
+ * @param a_len_2 The length of the multiplier, not zero
+ * @throw out_of_range if the product needs a transform longer than 2^41
+ */
+void mul_limbs_ntt(limb_t *a_r,
+                   const limb_t *a_mnd, size_t a_len_1,
+                   const limb_t *a_mer, size_t a_len_2)
+{
+    size_t len_r = a_len_1 + a_len_2;
+    unsigned log_n = 0;
+    while (((size_t)1 << log_n) < len_r - 1)
+    {
+        log_n++;
+    }
+    if (log_n > NTT_MAX_LOG)
+    {
+        throw out_of_range("Operands too long for the NTT multiplier");
+    }
+
+    ScratchFrame frame;
+    limb_t *residues[3];
+    for (int k = 0; k < 3; k++)
+    {
+        residues[k] = frame.limbs(len_r - 1);
+    }
+    parallel_run(3, (size_t)1 << log_n, parallel_settings.ntt, [&](size_t a_k) {
+        ntt_convolve(NTT_PRIMES[a_k], log_n, a_mnd, a_len_1, a_mer, a_len_2, residues[a_k]);
+    });
+
+    limb_t p_1 = NTT_PRIMES[0].modulus;
+    limb_t p_2 = NTT_PRIMES[1].modulus;
+    limb_t p_3 = NTT_PRIMES[2].modulus;
+    MontgomeryLimb field_2(p_2);
+    MontgomeryLimb field_3(p_3);
+    // p1^-1 mod p2, (p1 * p2)^-1 mod p3 and p1 mod p3, in Montgomery form.
+    limb_t p_1_inv_2 = field_2.to_mont(pow_mod_limb(p_1, p_2 - 2, p_2));
+    limb_t p_12_mod_3 = (limb_t)((dlimb_t)p_1 * p_2 % p_3);
+    limb_t p_12_inv_3 = field_3.to_mont(pow_mod_limb(p_12_mod_3, p_3 - 2, p_3));
+    limb_t p_1_mod_3 = field_3.to_mont(p_1 % p_3);
+    dlimb_t p_12 = (dlimb_t)p_1 * p_2;
+    limb_t p_12_lo = (limb_t)p_12;
+    limb_t p_12_hi = (limb_t)(p_12 >> LIMB_BITS);
+
+    // Each coefficient is x1 + x2 * p1 + x3 * p1 * p2, up to three limbs, added in at its own limb offset.
+    limb_t carry[3] = {0, 0, 0};
+    for (size_t i = 0; i < len_r; i++)
+    {
+        limb_t coef[3] = {0, 0, 0};
+        if (i < len_r - 1)
+        {
+            limb_t x_1 = residues[0][i];
+            limb_t x_2 = field_2.mul(field_2.sub(residues[1][i], x_1 % p_2), p_1_inv_2);
+            limb_t x_12_mod_3 = field_3.add(x_1 % p_3, field_3.mul(x_2 % p_3, p_1_mod_3));
+            limb_t x_3 = field_3.mul(field_3.sub(residues[2][i], x_12_mod_3), p_12_inv_3);
+
+            dlimb_t low = (dlimb_t)x_2 * p_1 + x_1;
+            dlimb_t top_lo = (dlimb_t)x_3 * p_12_lo;
+            dlimb_t top_hi = (dlimb_t)x_3 * p_12_hi;
+            dlimb_t acc = (dlimb_t)(limb_t)low + (limb_t)top_lo;
+            coef[0] = (limb_t)acc;
+            acc = (acc >> LIMB_BITS) + (limb_t)(low >> LIMB_BITS) + (limb_t)(top_lo >> LIMB_BITS) + (limb_t)top_hi;
+            coef[1] = (limb_t)acc;
+            coef[2] = (limb_t)((acc >> LIMB_BITS) + (limb_t)(top_hi >> LIMB_BITS));
+        }
+        limb_t c = add_limbs(carry, carry, 3, coef, 3);
+        a_r[i] = carry[0];
+        carry[0] = carry[1];
+        carry[1] = carry[2];
+        carry[2] = c;
+    }
+}
+
+/**
+ * @brief Multiply two limb arrays, choosing the schoolbook, Karatsuba, Toom-3 or NTT method by the size of the
+ *      shorter operand. Below the NTT threshold, very unbalanced operands are multiplied in pieces of the
+ *      shorter length. A forced algorithm applies to the top level only, and is replaced with an automatic
+ *      choice if the operands are too short or unbalanced for it. If both operands are the same array,
+ *      the product is computed by sqr_limbs.
+ *
+ * @param a_r The output of a_len_1 + a_len_2 limbs, which must not alias either operand
+ * @param a_mnd The number to be multiplied
+ * @param a_len_1 The length of the number to be multiplied
+ * @param a_mer The multiplier
+ * @param a_len_2 The length of the multiplier
+ */
+void mul_limbs(limb_t *a_r,
+               const limb_t *a_mnd, size_t a_len_1,
+               const limb_t *a_mer, size_t a_len_2,
+               MulAlgorithm a_algorithm)
+{
+    if (a_mnd == a_mer && a_len_1 == a_len_2)
+    {
+        sqr_limbs(a_r, a_mnd, a_len_1, a_algorithm);
+        return;
+    }
+    if (a_len_1 < a_len_2)
+    {
+        std::swap(a_mnd, a_mer);
+        std::swap(a_len_1, a_len_2);
+    }
+    // Karatsuba only shrinks the operands from 4 limbs up.
+    bool karatsuba_fits = a_len_2 >= 4 && 2 * a_len_2 > a_len_1 + 1;
+    bool toom3_fits = karatsuba_fits && a_len_2 > 2 * ((a_len_1 + 2) / 3);
+    if (a_algorithm == MulAlgorithm::Schoolbook || a_len_2 == 0)
+    {
+        BIGINT_TIER(Basecase);
+        mul_limbs_schoolbook(a_r, a_mnd, a_len_1, a_mer, a_len_2);
+        return;
+    }
+    if (a_algorithm == MulAlgorithm::Ntt ||
+        (a_algorithm == MulAlgorithm::Auto && a_len_2 >= mul_thresholds.ntt))
+    {
+        BIGINT_TIER(Ntt);
+        mul_limbs_ntt(a_r, a_mnd, a_len_1, a_mer, a_len_2);
+        return;
+    }
+    if (a_algorithm == MulAlgorithm::Karatsuba && karatsuba_fits)
+    {
+        BIGINT_TIER(Karatsuba);
+        mul_limbs_karatsuba(a_r, a_mnd, a_len_1, a_mer, a_len_2);
+        return;
+    }
+    if (a_algorithm == MulAlgorithm::Toom3 && toom3_fits)
+    {
+        BIGINT_TIER(Toom3);
+        mul_limbs_toom3(a_r, a_mnd, a_len_1, a_mer, a_len_2);
+        return;
+    }
+    if (a_len_2 < std::max<size_t>(mul_thresholds.karatsuba, 4))
+    {
+        BIGINT_TIER(Basecase);
+        mul_limbs_schoolbook(a_r, a_mnd, a_len_1, a_mer, a_len_2);
+        return;
+    }
+    if (2 * a_len_2 <= a_len_1 + 1)
+    {
+        // Multiply the longer operand one piece at a time, each piece as long as the shorter operand.
+        std::fill(a_r, a_r + a_len_1 + a_len_2, 0);
+        ScratchFrame frame;
+        limb_t *piece = frame.limbs(2 * a_len_2);
+        for (size_t offset = 0; offset < a_len_1; offset += a_len_2)
+        {
+            size_t piece_len = std::min(a_len_2, a_len_1 - offset);
+            mul_limbs(piece, a_mnd + offset, piece_len, a_mer, a_len_2);
+            add_limbs(a_r + offset, a_r + offset, a_len_1 + a_len_2 - offset, piece, piece_len + a_len_2);
+        }
+        return;
+    }
+    if (a_len_2 < mul_thresholds.toom3 || !toom3_fits)
+    {
+        BIGINT_TIER(Karatsuba);
+        mul_limbs_karatsuba(a_r, a_mnd, a_len_1, a_mer, a_len_2);
+        return;
+    }
+    BIGINT_TIER(Toom3);
+    mul_limbs_toom3(a_r, a_mnd, a_len_1, a_mer, a_len_2);
+}
+
+/**
+ * @brief Square a limb array, choosing the schoolbook, Karatsuba, Toom-3 or NTT method by its length with
+ *      the squaring thresholds of mul_thresholds. A forced algorithm applies to the top level only, as in
+ *      mul_limbs.
+ *
+ * @param a_r The output of 2 * a_len limbs, which must not alias the operand
+ * @param a_opr The number to be squared
+ * @param a_len The length of the number
+ * @param a_algorithm The algorithm to use at the top level
+ */
+void sqr_limbs(limb_t *a_r, const limb_t *a_opr, size_t a_len, MulAlgorithm a_algorithm)
+{
+    bool toom3_fits = a_len > 2 * ((a_len + 2) / 3);
+    if (a_algorithm == MulAlgorithm::Schoolbook || a_len == 0)
+    {
+        BIGINT_TIER(Basecase);
+        sqr_limbs_schoolbook(a_r, a_opr, a_len);
+        return;
+    }
+    if (a_algorithm == MulAlgorithm::Ntt ||
+        (a_algorithm == MulAlgorithm::Auto && a_len >= mul_thresholds.ntt))
+    {
+        BIGINT_TIER(Ntt);
+        mul_limbs_ntt(a_r, a_opr, a_len, a_opr, a_len);
+        return;
+    }
+    if (a_algorithm == MulAlgorithm::Karatsuba && a_len >= 4)
+    {
+        BIGINT_TIER(Karatsuba);
+        sqr_limbs_karatsuba(a_r, a_opr, a_len);
+        return;
+    }
+    if (a_algorithm == MulAlgorithm::Toom3 && a_len >= 4 && toom3_fits)
+    {
+        BIGINT_TIER(Toom3);
+        sqr_limbs_toom3(a_r, a_opr, a_len);
+        return;
+    }
+    if (a_len < std::max<size_t>(mul_thresholds.sqr_karatsuba, 4))
+    {
+        BIGINT_TIER(Basecase);
+        sqr_limbs_schoolbook(a_r, a_opr, a_len);
+        return;
+    }
+    if (a_len < mul_thresholds.sqr_toom3 || !toom3_fits)
+    {
+        BIGINT_TIER(Karatsuba);
+        sqr_limbs_karatsuba(a_r, a_opr, a_len);
+        return;
+    }
+    BIGINT_TIER(Toom3);
+    sqr_limbs_toom3(a_r, a_opr, a_len);
+}
+
+/**
+ * @brief Divisor sizes, in limbs, at which division switches algorithm. May be changed at run time
+ *      through div_thresholds.
+ */
+struct DivThresholds
+{
+    // At or above this divisor length, and quotient length, use Burnikel-Ziegler recursive division.
+    size_t burnikel_ziegler = 80;
+    // At or above this divisor length, Divider reduces with a precomputed Barrett reciprocal.
+    size_t barrett = 80;
+};
+
+/**
+ * @brief The thresholds used by div_limb_vectors_bare and Divider.
+ */
+DivThresholds div_thresholds;
+
+/**
+ * @brief Return limbs a_from to a_to of a limb vector, as a trimmed vector. Limbs past the end read as zero.
+ *
+ * @param a_vec The limb vector
+ * @param a_from The first limb to include
+ * @param a_to One past the last limb to include
+ * @return The selected limbs
+ */
+vector<limb_t> limb_slice(const vector<limb_t> &a_vec, size_t a_from, size_t a_to)
+{
+    vector<limb_t> result;
+    if (a_from < a_vec.size())
+    {
+        result.assign(a_vec.begin() + a_from, a_vec.begin() + std::min(a_to, a_vec.size()));
+    }
+    trim_limb_vector(result);
+    return result;
+}
+
+void div_limbs_2n_1n(limb_t *a_q, limb_t *a_rem, const limb_t *a_dvd, const limb_t *a_dvs, size_t a_n);
+
+/**
+ * @brief Burnikel-Ziegler step. Divide a 3h-limb number by a 2h-limb normalized divisor, given that the
+ *      quotient fits in h limbs.
+ *
+ * @param a_q The quotient, of h limbs
+ * @param a_rem The remainder, of 2h limbs, which must not alias the dividend
+ * @param a_dvd The dividend, of 3h limbs, less than the divisor times 2^(64h)
+ * @param a_dvs The divisor, of 2h limbs, with the top bit set
+ * @param a_half The half length h
+ */
+void div_limbs_3n_2n(limb_t *a_q, limb_t *a_rem, const limb_t *a_dvd, const limb_t *a_dvs, size_t a_half)
+{
+    size_t h = a_half;
+    ScratchFrame frame;
+    // The remainder estimate, with a limb to spare for the carry of a1 + b1 and for going negative.
+    limb_t *rem_hat = frame.limbs(2 * h + 1);
+    std::copy(a_dvd, a_dvd + h, rem_hat);
+
+    // Estimate the quotient from the top limbs. The estimate is at most 2 too large.
+    if (cmp_limbs(a_dvd + 2 * h, h, a_dvs + h, h) < 0)
+    {
+        rem_hat[2 * h] = 0;
+        div_limbs_2n_1n(a_q, rem_hat + h, a_dvd + h, a_dvs + h, h);
+    }
+    else
+    {
+        // The top halves are equal, so the estimate is 2^(64h) - 1 and the remainder is a1 + b1.
+        std::fill(a_q, a_q + h, ~(limb_t)0);
+        rem_hat[2 * h] = add_limbs(rem_hat + h, a_dvd + h, h, a_dvs + h, h);
+    }
+
+    limb_t *correction = frame.limbs(2 * h);
+    mul_limbs(correction, a_q, h, a_dvs, h);
+    limb_t borrow = sub_limbs(rem_hat, rem_hat, 2 * h + 1, correction, 2 * h);
+    while (borrow != 0)
+    {
+        // The estimate was too large: decrement it and add the divisor back until the remainder wraps
+        // past zero.
+        const limb_t one = 1;
+        sub_limbs(a_q, a_q, h, &one, 1);
+        borrow = add_limbs(rem_hat, rem_hat, 2 * h + 1, a_dvs, 2 * h) == 0;
+    }
+    std::copy(rem_hat, rem_hat + 2 * h, a_rem);
+}
+
+/**
+ * @brief Burnikel-Ziegler recursive division of a 2n-limb number by an n-limb normalized divisor, given that
+ *      the quotient fits in n limbs. Short divisors fall back to Knuth's Algorithm D.
+ *
+ * @param a_q The quotient, of n limbs
+ * @param a_rem The remainder, of n limbs, which must not alias the dividend
+ * @param a_dvd The dividend, of 2n limbs, less than the divisor times 2^(64n)
+ * @param a_dvs The divisor, of n limbs, with the top bit set
+ * @param a_n The length n
+ */
+void div_limbs_2n_1n(limb_t *a_q, limb_t *a_rem, const limb_t *a_dvd, const limb_t *a_dvs, size_t a_n)
+{
+    ScratchFrame frame;
+    if (a_n < div_thresholds.burnikel_ziegler)
+    {
+        // Algorithm D gives a quotient of n + 1 limbs, whose top limb is zero here.
+        limb_t *quot = frame.limbs(a_n + 1);
+        div_limbs(quot, a_rem, a_dvd, 2 * a_n, a_dvs, a_n);
+        std::copy(quot, quot + a_n, a_q);
+        return;
+    }
+    if (a_n % 2 == 1)
+    {
+        // Scale both by one limb to make the length even. The quotient is unchanged.
+        limb_t *dvd = frame.limbs(2 * a_n + 2);
+        limb_t *dvs = frame.limbs(a_n + 1);
+        limb_t *quot = frame.limbs(a_n + 1);
+        limb_t *rem = frame.limbs(a_n + 1);
+        dvd[0] = 0;
+        std::copy(a_dvd, a_dvd + 2 * a_n, dvd + 1);
+        dvd[2 * a_n + 1] = 0;
+        dvs[0] = 0;
+        std::copy(a_dvs, a_dvs + a_n, dvs + 1);
+        div_limbs_2n_1n(quot, rem, dvd, dvs, a_n + 1);
+        std::copy(quot, quot + a_n, a_q);
+        std::copy(rem + 1, rem + a_n + 1, a_rem);
+        return;
+    }
+
+    size_t half = a_n / 2;
+    // The second step divides the remainder of the first with the low quarter of the dividend below it.
+    limb_t *dvd_lo = frame.limbs(3 * half);
+    std::copy(a_dvd, a_dvd + half, dvd_lo);
+    div_limbs_3n_2n(a_q + half, dvd_lo + half, a_dvd + half, a_dvs, half);
+    div_limbs_3n_2n(a_q, a_rem, dvd_lo, a_dvs, half);
+}
+
+/**
+ * @brief Divide two limb arrays with Burnikel-Ziegler recursive division. The dividend is cut into blocks
+ *      as long as the divisor, which are divided from the top as in long division. All intermediate values
+ *      live in the scratch arena.
+ *
+ * @param a_q The quotient, of a_len_1 - a_len_2 + 1 limbs
+ * @param a_rem The remainder, of a_len_2 limbs
+ * @param a_dvd The dividend
+ * @param a_len_1 The length of the dividend, no less than a_len_2
+ * @param a_dvs The divisor, whose most significant limb is not zero
+ * @param a_len_2 The length of the divisor
+ */
+void div_limbs_bz(limb_t *a_q, limb_t *a_rem,
+                  const limb_t *a_dvd, size_t a_len_1,
+                  const limb_t *a_dvs, size_t a_len_2)
+{
+    ScratchFrame frame;
+    unsigned shift = (unsigned)__builtin_clzll(a_dvs[a_len_2 - 1]);
+    size_t n = a_len_2;
+    limb_t *dvs = frame.limbs(n);
+    lsh_limbs(dvs, a_dvs, n, shift);
+
+    // The shifted dividend, with room for a zero block on top, cut into blocks. The top block must be below
+    // the divisor, so take one more block if it is not.
+    limb_t *dvd = frame.limbs(a_len_1 + 2 * n + 1);
+    dvd[a_len_1] = lsh_limbs(dvd, a_dvd, a_len_1, shift);
+    size_t dvd_len = (dvd[a_len_1] == 0) ? a_len_1 : a_len_1 + 1;
+    size_t blocks = (dvd_len + n - 1) / n;
+    std::fill(dvd + dvd_len, dvd + (blocks + 1) * n, 0);
+    if (cmp_limbs(dvd + (blocks - 1) * n, n, dvs, n) >= 0)
+    {
+        blocks++;
+    }
+
+    limb_t *quot = frame.limbs((blocks - 1) * n);
+    limb_t *part = frame.limbs(2 * n);
+    limb_t *rem = frame.limbs(n);
+    std::copy(dvd + (blocks - 1) * n, dvd + blocks * n, rem);
+    for (size_t i = blocks - 1; i-- > 0;)
+    {
+        std::copy(dvd + i * n, dvd + (i + 1) * n, part);
+        std::copy(rem, rem + n, part + n);
+        div_limbs_2n_1n(quot + i * n, rem, part, dvs, n);
+    }
+
+    // The quotient is below 2^(64 (blocks - 1) n), and also fits in the length the caller expects.
+    size_t q_len = a_len_1 - a_len_2 + 1;
+    size_t copied = std::min(q_len, (blocks - 1) * n);
+    std::copy(quot, quot + copied, a_q);
+    std::fill(a_q + copied, a_q + q_len, 0);
+    rsh_limbs(a_rem, rem, n, shift);
+}
+
+/**
+ * @brief Auxillary function. Divide two trimmed limb vectors then return the result, as well as the remainder, through its arguments.
+ *      Long divisors with long quotients use Burnikel-Ziegler division, the rest Knuth's Algorithm D.
+ *
+ * @param a_dvd The dividend
+ * @param a_dvs The divisor
+ * @param result The vector that accepts the result
+ * @param rem The vector that accepts the remainder
+ * @throw domain_error if the divisor is zero
+ */
+void div_limb_vectors_bare(const vector<limb_t> &a_dvd, const vector<limb_t> &a_dvs, vector<limb_t> &result, vector<limb_t> &rem)
+{
+    if (a_dvs.empty())
+    {
+        throw domain_error("Cannot divide by zero");
+    }
+    if (is_the_first_bigger(a_dvs, a_dvd))
+    {
+        result = vector<limb_t>();
+        rem = a_dvd;
+        return;
+    }
+    if (a_dvs.size() >= div_thresholds.burnikel_ziegler &&
+        a_dvd.size() - a_dvs.size() >= div_thresholds.burnikel_ziegler)
+    {
+        BIGINT_TIER(DivideAndConquer);
+        result.assign(a_dvd.size() - a_dvs.size() + 1, 0);
+        rem.assign(a_dvs.size(), 0);
+        div_limbs_bz(result.data(), rem.data(), a_dvd.data(), a_dvd.size(), a_dvs.data(), a_dvs.size());
+        trim_limb_vector(result);
+        trim_limb_vector(rem);
+        return;
+    }
+
+    result.assign(a_dvd.size() - a_dvs.size() + 1, 0);
+    rem.assign(a_dvs.size(), 0);
+    div_limbs(result.data(), rem.data(), a_dvd.data(), a_dvd.size(), a_dvs.data(), a_dvs.size());
+    trim_limb_vector(result);
+    trim_limb_vector(rem);
+}
+
+/**
+ * @brief Divide two limb vectors.
+ *
+ * @param a_dvd The dividend
+ * @param a_dvs the divisor
+ * @return The result of the division, truncated.
+ */
+vector<limb_t> div_limb_vectors(const vector<limb_t> &a_dvd, const vector<limb_t> &a_dvs)
+{
+    vector<limb_t> result;
+    vector<limb_t> rem;
+    div_limb_vectors_bare(a_dvd, a_dvs, result, rem);
+    return result;
+}
+
+/**
+ * @brief Montgomery multiplication modulo a fixed odd number, with R = 2^(64n) for an n-limb modulus.
+ *      Values in the Montgomery domain are vectors of exactly n limbs, below the modulus.
+ */
+class MontgomeryContext
+{
+public:
+    explicit MontgomeryContext(const vector<limb_t> &);
+
+    vector<limb_t> modulus;
+    // -modulus^-1 mod 2^64
+    limb_t neg_inv;
+    // R^2 mod modulus, for converting into the Montgomery domain
+    vector<limb_t> r_squared;
+
+    size_t size() const { return modulus.size(); }
+    vector<limb_t> one() const;
+    vector<limb_t> to_mont(const vector<limb_t> &) const;
+    vector<limb_t> from_mont(const vector<limb_t> &) const;
+    void mul(vector<limb_t> &, const vector<limb_t> &, const vector<limb_t> &, bool a_constant_time = false) const;
+    void mul(limb_t *, const limb_t *, const limb_t *, bool a_constant_time = false) const;
+};
+
+/**
+ * @brief Set up Montgomery multiplication for a modulus.
+ *
+ * @param a_modulus The modulus, odd and trimmed
+ */
+MontgomeryContext::MontgomeryContext(const vector<limb_t> &a_modulus)
+{
+    modulus = a_modulus;
+    limb_t inv = a_modulus[0];
+    for (int i = 0; i < 5; i++)
+    {
+        inv *= 2 - a_modulus[0] * inv;
+    }
+    neg_inv = (limb_t)0 - inv;
+
+    vector<limb_t> r_2(2 * size() + 1, 0);
+    r_2.back() = 1;
+    vector<limb_t> quot;
+    div_limb_vectors_bare(r_2, modulus, quot, r_squared);
+    r_squared.resize(size(), 0);
+}
+
+/**
+ * @brief Return R mod the modulus, the Montgomery form of 1.
+ *
+ * @return The Montgomery form of 1
+ */
+vector<limb_t> MontgomeryContext::one() const
+{
+    vector<limb_t> result(size(), 0);
+    result[0] = 1;
+    return to_mont(result);
+}
+
+/**
+ * @brief Convert into the Montgomery domain.
+ *
+ * @param a_opr A value below the modulus, of at most n limbs
+ * @return a_opr * R mod the modulus
+ */
+vector<limb_t> MontgomeryContext::to_mont(const vector<limb_t> &a_opr) const
+{
+    vector<limb_t> opr = a_opr;
+    opr.resize(size(), 0);
+    vector<limb_t> result;
+    mul(result, opr, r_squared);
+    return result;
+}
+
+/**
+ * @brief Convert out of the Montgomery domain.
+ *
+ * @param a_opr A value in the Montgomery domain
+ * @return a_opr / R mod the modulus, trimmed
+ */
+vector<limb_t> MontgomeryContext::from_mont(const vector<limb_t> &a_opr) const
+{
+    vector<limb_t> unit(size(), 0);
+    unit[0] = 1;
+    vector<limb_t> result;
+    mul(result, a_opr, unit);
+    trim_limb_vector(result);
+    return result;
+}
+
+/**
+ * @brief Multiply two values in the Montgomery domain, giving a * b / R mod the modulus.
+ *
+ * @param a_r The vector that accepts the product, which may be either operand
+ * @param a_opr_1 The first operand
+ * @param a_opr_2 The second operand
+ * @param a_constant_time If the final subtraction should be done without branching on the data
+ */
+void MontgomeryContext::mul(vector<limb_t> &a_r, const vector<limb_t> &a_opr_1, const vector<limb_t> &a_opr_2,
+                            bool a_constant_time) const
+{
+    a_r.resize(size());
+    mul(a_r.data(), a_opr_1.data(), a_opr_2.data(), a_constant_time);
+}
+
+/**
+ * @brief Multiply two values of n limbs in the Montgomery domain with the CIOS method, giving
+ *      a * b / R mod the modulus. A square, where both operands are the same array, is computed by
+ *      sqr_limbs and then reduced a limb at a time, unless a_constant_time is set.
+ *
+ * @param a_r The n limbs that accept the product, which may be either operand
+ * @param a_opr_1 The first operand
+ * @param a_opr_2 The second operand
+ * @param a_constant_time If the final subtraction should be done without branching on the data
+ */
+void MontgomeryContext::mul(limb_t *a_r, const limb_t *a_opr_1, const limb_t *a_opr_2, bool a_constant_time) const
+{
+    size_t n = size();
+    static thread_local vector<limb_t> acc;
+    const limb_t *mod = modulus.data();
+    if (a_opr_1 == a_opr_2 && !a_constant_time)
+    {
+        // Square, then clear the low n limbs one at a time with multiples of the modulus, and drop them.
+        acc.assign(2 * n + 1, 0);
+        sqr_limbs(acc.data(), a_opr_1, n);
+        for (size_t i = 0; i < n; i++)
+        {
+            limb_t carry = addmul_1_limbs(acc.data() + i, mod, n, acc[i] * neg_inv);
+            for (size_t j = i + n; carry != 0; j++)
+            {
+                acc[j] += carry;
+                carry = (acc[j] < carry) ? 1 : 0;
+            }
+        }
+        acc.erase(acc.begin(), acc.begin() + n);
+    }
+    else
+    {
+        acc.assign(n + 2, 0);
+        for (size_t i = 0; i < n; i++)
+        {
+            limb_t carry = addmul_1_limbs(acc.data(), a_opr_2, n, a_opr_1[i]);
+            dlimb_t top = (dlimb_t)acc[n] + carry;
+            acc[n] = (limb_t)top;
+            acc[n + 1] += (limb_t)(top >> LIMB_BITS);
+
+            // Add a multiple of the modulus that clears the low limb, then drop that limb.
+            limb_t m = acc[0] * neg_inv;
+            carry = addmul_1_limbs(acc.data(), mod, n, m);
+            top = (dlimb_t)acc[n] + carry;
+            acc[n] = (limb_t)top;
+            acc[n + 1] += (limb_t)(top >> LIMB_BITS);
+            std::copy(acc.begin() + 1, acc.end(), acc.begin());
+            acc[n + 1] = 0;
+        }
+    }
+
+    // The result is below twice the modulus.
+    if (a_constant_time)
+    {
+        limb_t borrow = sub_limbs(a_r, acc.data(), n, mod, n);
+        borrow = (acc[n] < borrow) ? 1 : 0;
+        limb_t keep_acc = (limb_t)0 - borrow;
+        for (size_t i = 0; i < n; i++)
+        {
+            a_r[i] = (acc[i] & keep_acc) | (a_r[i] & ~keep_acc);
+        }
+    }
+    else if (acc[n] != 0 || cmp_limbs(acc.data(), n, mod, n) >= 0)
+    {
+        sub_limbs(a_r, acc.data(), n, mod, n);
+    }
+    else
+    {
+        std::copy(acc.begin(), acc.begin() + n, a_r);
+    }
+}
+
+/**
+ * @brief Barrett reduction modulo a fixed number, for moduli that Montgomery multiplication cannot take.
+ *      Values are trimmed vectors below the modulus.
+ */
+class BarrettContext
+{
+public:
+    explicit BarrettContext(const vector<limb_t> &);
+
+    vector<limb_t> modulus;
+    // floor(2^(128n) / modulus) for an n-limb modulus
+    vector<limb_t> mu;
+
+    size_t size() const { return modulus.size(); }
+    vector<limb_t> one() const;
+    vector<limb_t> reduce(const vector<limb_t> &) const;
+    void mul(vector<limb_t> &, const vector<limb_t> &, const vector<limb_t> &) const;
+};
+
+/**
+ * @brief Set up Barrett reduction for a modulus.
+ *
+ * @param a_modulus The modulus, not zero, and trimmed
+ */
+BarrettContext::BarrettContext(const vector<limb_t> &a_modulus)
+{
+    modulus = a_modulus;
+    vector<limb_t> b_2n(2 * size() + 1, 0);
+    b_2n.back() = 1;
+    mu = div_limb_vectors(b_2n, modulus);
+}
+
+/**
+ * @brief Return 1 reduced by the modulus.
+ *
+ * @return 1 mod the modulus
+ */
+vector<limb_t> BarrettContext::one() const
+{
+    return reduce(vector<limb_t>{1});
+}
+
+/**
+ * @brief Reduce a value modulo the modulus.
+ *
+ * @param a_opr A trimmed value below 2^(128n)
+ * @return a_opr mod the modulus
+ */
+vector<limb_t> BarrettContext::reduce(const vector<limb_t> &a_opr) const
+{
+    size_t n = size();
+    // The quotient estimate is at most 2 below the true quotient.
+    vector<limb_t> quot_est = mul_limb_vectors(limb_slice(a_opr, n - 1, a_opr.size()), mu);
+    vector<limb_t> quot = limb_slice(quot_est, n + 1, quot_est.size());
+    vector<limb_t> result = sub_limb_vectors(a_opr, mul_limb_vectors(quot, modulus));
+    while (!is_the_first_bigger(modulus, result))
+    {
+        result = sub_limb_vectors(result, modulus);
+    }
+    return result;
+}
+
+/**
+ * @brief Multiply two reduced values modulo the modulus.
+ *
+ * @param a_r The vector that accepts the product, which may be either operand
+ * @param a_opr_1 The first operand
+ * @param a_opr_2 The second operand
+ */
+void BarrettContext::mul(vector<limb_t> &a_r, const vector<limb_t> &a_opr_1, const vector<limb_t> &a_opr_2) const
+{
+    a_r = reduce(mul_limb_vectors(a_opr_1, a_opr_2));
+}
+
+/**
+ * @brief Return bit a_bit of a limb vector.
+ *
+ * @param a_vec The limb vector
+ * @param a_bit The index of the bit, from the least significant
+ * @return The bit
+ */
+bool limb_vector_bit(const vector<limb_t> &a_vec, size_t a_bit)
+{
+    size_t limb = a_bit / LIMB_BITS;
+    return limb < a_vec.size() && ((a_vec[limb] >> (a_bit % LIMB_BITS)) & 1);
+}
+
+/**
+ * @brief Raise a value to a power in the domain of a modular context, scanning the exponent from the top with
+ *      a sliding window over precomputed odd powers.
+ *
+ * @tparam Context MontgomeryContext or BarrettContext
+ * @param a_ctx The modular context
+ * @param a_base The base, in the context's domain
+ * @param a_exp The exponent, trimmed
+ * @return a_base ^ a_exp, in the context's domain
+ */
+template <typename Context>
+vector<limb_t> pow_sliding_window(const Context &a_ctx, const vector<limb_t> &a_base, const vector<limb_t> &a_exp)
+{
+    vector<limb_t> result = a_ctx.one();
+    if (a_exp.empty())
+    {
+        return result;
+    }
+    size_t n_bits = a_exp.size() * LIMB_BITS - (size_t)__builtin_clzll(a_exp.back());
+    size_t window = 1;
+    for (size_t bound : {24, 80, 240, 672, 1792})
+    {
+        window += (n_bits > bound) ? 1 : 0;
+    }
+
+    // Odd powers base^1, base^3, .. base^(2^window - 1).
+    vector<vector<limb_t>> odd_powers(size_t(1) << (window - 1));
+    odd_powers[0] = a_base;
+    vector<limb_t> base_sq;
+    a_ctx.mul(base_sq, a_base, a_base);
+    for (size_t i = 1; i < odd_powers.size(); i++)
+    {
+        a_ctx.mul(odd_powers[i], odd_powers[i - 1], base_sq);
+    }
+
+    bool started = false;
+    for (size_t i = n_bits; i-- > 0;)
+    {
+        if (!limb_vector_bit(a_exp, i))
+        {
+            if (started)
+            {
+                a_ctx.mul(result, result, result);
+            }
+            continue;
+        }
+        // Take the longest window of up to window bits that starts at bit i and ends in a 1.
+        size_t low = (i + 1 >= window) ? i + 1 - window : 0;
+        while (!limb_vector_bit(a_exp, low))
+        {
+            low++;
+        }
+        size_t value = 0;
+        for (size_t j = i + 1; j-- > low;)
+        {
+            value = (value << 1) | (limb_vector_bit(a_exp, j) ? 1 : 0);
+            if (started)
+            {
+                a_ctx.mul(result, result, result);
+            }
+        }
+        if (started)
+        {
+            a_ctx.mul(result, result, odd_powers[value / 2]);
+        }
+        else
+        {
+            result = odd_powers[value / 2];
+            started = true;
+        }
+        i = low;
+    }
+    return result;
+}
+
+/**
+ * @brief Raise a value to a power in the Montgomery domain with a Montgomery ladder. Every bit position of
+ *      the exponent's limbs costs one multiplication and one squaring, and the bits only select values
+ *      through masks, so the running time does not depend on the exponent's bits.
+ *
+ * @param a_ctx The Montgomery context
+ * @param a_base The base, in the Montgomery domain
+ * @param a_exp The exponent
+ * @return a_base ^ a_exp, in the Montgomery domain
+ */
+vector<limb_t> pow_ladder(const MontgomeryContext &a_ctx, const vector<limb_t> &a_base, const vector<limb_t> &a_exp)
+{
+    vector<limb_t> low = a_ctx.one();
+    vector<limb_t> high = a_base;
+    for (size_t i = a_exp.size() * LIMB_BITS; i-- > 0;)
+    {
+        limb_t swap = (limb_t)0 - ((a_exp[i / LIMB_BITS] >> (i % LIMB_BITS)) & 1);
+        for (size_t j = 0; j < a_ctx.size(); j++)
+        {
+            limb_t diff = (low[j] ^ high[j]) & swap;
+            low[j] ^= diff;
+            high[j] ^= diff;
+        }
+        a_ctx.mul(high, low, high, true);
+        a_ctx.mul(low, low, low, true);
+        for (size_t j = 0; j < a_ctx.size(); j++)
+        {
+            limb_t diff = (low[j] ^ high[j]) & swap;
+            low[j] ^= diff;
+            high[j] ^= diff;
+        }
+    }
+    return low;
+}
+
+/**
+ * @brief Number of limbs a LimbVector holds inside the object before it moves to the heap. Four limbs cover
+ *      values of up to 256 bits.
+ */
+const size_t LIMB_VECTOR_INLINE = 4;
+
+/**
+ * @brief Return the memory resource that new LimbVectors, and so new Ints, of the calling thread take their
+ *      heap buffers from. It is the global operator new unless an IntArenaScope is active.
+ */
+std::pmr::memory_resource *&current_limb_resource()
+{
+    static thread_local std::pmr::memory_resource *resource = std::pmr::new_delete_resource();
+    return resource;
+}
+
+/**
+ * @brief Route the heap buffers of the Ints that the calling thread creates in a scope to one memory
+ *      resource, for example to release all the bignum memory of a request at once. By default the scope
+ *      owns a monotonic arena, which never frees and is released as a whole when the scope ends; it may
+ *      also install a resource of the caller's. Scopes nest, and each restores the previous resource.
+ *
+ *      Ints created in the scope must be destroyed before it ends. Ints from outside keep their own
+ *      resource, so assigning to one of them is the way to keep a value past the scope.
+ */
+class IntArenaScope
+{
+public:
+    IntArenaScope();
+    explicit IntArenaScope(std::pmr::memory_resource *);
+    IntArenaScope(const IntArenaScope &) = delete;
+    IntArenaScope &operator=(const IntArenaScope &) = delete;
+    ~IntArenaScope();
+
+    std::pmr::memory_resource *get_resource() const { return resource; }
+
+private:
+    std::pmr::monotonic_buffer_resource arena;
+    std::pmr::memory_resource *resource;
+    std::pmr::memory_resource *previous;
+};
+
+IntArenaScope::IntArenaScope()
+    : resource(&arena), previous(current_limb_resource())
+{
+    current_limb_resource() = resource;
+}
+
+IntArenaScope::IntArenaScope(std::pmr::memory_resource *a_resource)
+    : resource(a_resource), previous(current_limb_resource())
+{
+    current_limb_resource() = resource;
+}
+
+IntArenaScope::~IntArenaScope()
+{
+    current_limb_resource() = previous;
+}
+
+/**
+ * @brief A vector of limbs with small-buffer optimization. Up to LIMB_VECTOR_INLINE limbs live inside the
+ *      object, so word-sized integers and their temporaries never touch the heap. Larger buffers come from
+ *      a memory resource, by default the one current when the vector was made.
+ */
+class LimbVector
+{
+public:
+    LimbVector() = default;
+    explicit LimbVector(std::pmr::memory_resource *a_resource) : resource(a_resource) {}
+    LimbVector(const LimbVector &);
+    LimbVector(LimbVector &&) noexcept;
+    explicit LimbVector(const vector<limb_t> &);
+    ~LimbVector();
+
+    LimbVector &operator=(const LimbVector &);
+    LimbVector &operator=(LimbVector &&);
+
+    std::pmr::memory_resource *get_resource() const { return resource; }
+
+    limb_t *data() { return heap ? heap : local; }
+    const limb_t *data() const { return heap ? heap : local; }
+    size_t size() const { return len; }
+    size_t capacity() const { return cap; }
+    bool empty() const { return len == 0; }
+    bool is_inline() const { return heap == nullptr; }
+    limb_t &operator[](size_t a_i) { return data()[a_i]; }
+    const limb_t &operator[](size_t a_i) const { return data()[a_i]; }
+    limb_t &back() { return data()[len - 1]; }
+    const limb_t &back() const { return data()[len - 1]; }
+    limb_t *begin() { return data(); }
+    limb_t *end() { return data() + len; }
+    const limb_t *begin() const { return data(); }
+    const limb_t *end() const { return data() + len; }
+
+    void reserve(size_t);
+    void resize(size_t);
+    void assign(const limb_t *, const limb_t *);
+    void push_back(limb_t);
+    void pop_back() { len--; }
+    void clear() { len = 0; }
+    vector<limb_t> to_vector() const { return vector<limb_t>(begin(), end()); }
+    void swap(LimbVector &);
+    bool operator==(const LimbVector &) const;
+
+private:
+    std::pmr::memory_resource *resource = current_limb_resource();
+    limb_t *heap = nullptr;
+    size_t len = 0;
+    size_t cap = LIMB_VECTOR_INLINE;
+    limb_t local[LIMB_VECTOR_INLINE];
+
+    void release();
+};
+
+LimbVector::LimbVector(const LimbVector &a_that)
+{
+    assign(a_that.begin(), a_that.end());
+}
+
+/**
+ * @brief Move constructor. Takes over the buffer and the memory resource of the other vector.
+ */
+LimbVector::LimbVector(LimbVector &&a_that) noexcept
+    : resource(a_that.resource)
+{
+    *this = std::move(a_that);
+}
+
+LimbVector::LimbVector(const vector<limb_t> &a_limbs)
+{
+    assign(a_limbs.data(), a_limbs.data() + a_limbs.size());
+}
+
+LimbVector::~LimbVector()
+{
+    release();
+}
+
+/**
+ * @brief Private method. Give the heap buffer, if any, back to the memory resource.
+ */
+void LimbVector::release()
+{
+    if (heap != nullptr)
+    {
+        resource->deallocate(heap, cap * sizeof(limb_t), alignof(limb_t));
+        heap = nullptr;
+        cap = LIMB_VECTOR_INLINE;
+    }
+}
+
+LimbVector &LimbVector::operator=(const LimbVector &a_that)
+{
+    if (this != &a_that)
+    {
+        assign(a_that.begin(), a_that.end());
+    }
+    return *this;
+}
+
+/**
+ * @brief Move assignment. Takes over a heap buffer from the same memory resource, or copies the limbs
+ *      into this vector's own buffer otherwise. Either way this vector keeps its memory resource.
+ */
+LimbVector &LimbVector::operator=(LimbVector &&a_that)
+{
+    if (this == &a_that)
+    {
+        return *this;
+    }
+    if (a_that.heap != nullptr && resource->is_equal(*a_that.resource))
+    {
+        release();
+        heap = a_that.heap;
+        len = a_that.len;
+        cap = a_that.cap;
+        a_that.heap = nullptr;
+        a_that.cap = LIMB_VECTOR_INLINE;
+    }
+    else
+    {
+        assign(a_that.begin(), a_that.end());
+    }
+    a_that.len = 0;
+    return *this;
+}
+
+/**
+ * @brief Make room for at least a_cap limbs, keeping the current ones.
+ *
+ * @param a_cap The capacity wanted
+ */
+void LimbVector::reserve(size_t a_cap)
+{
+    if (a_cap <= cap)
+    {
+        return;
+    }
+    size_t new_cap = std::max(a_cap, 2 * cap);
+    limb_t *new_heap = static_cast<limb_t *>(resource->allocate(new_cap * sizeof(limb_t), alignof(limb_t)));
+    BIGINT_ALLOC(new_cap * sizeof(limb_t));
+    std::copy(data(), data() + len, new_heap);
+    release();
+    heap = new_heap;
+    cap = new_cap;
+}
+
+/**
+ * @brief Change the number of limbs. New limbs are zero.
+ *
+ * @param a_len The new number of limbs
+ */
+void LimbVector::resize(size_t a_len)
+{
+    reserve(a_len);
+    if (a_len > len)
+    {
+        std::fill(data() + len, data() + a_len, 0);
+    }
+    len = a_len;
+}
+
+/**
+ * @brief Replace the contents with a range of limbs, which must not lie inside this vector.
+ *
+ * @param a_first The first limb
+ * @param a_last One past the last limb
+ */
+void LimbVector::assign(const limb_t *a_first, const limb_t *a_last)
+{
+    size_t new_len = (size_t)(a_last - a_first);
+    len = 0;
+    reserve(new_len);
+    std::copy(a_first, a_last, data());
+    len = new_len;
+}
+
+void LimbVector::push_back(limb_t a_limb)
+{
+    reserve(len + 1);
+    data()[len++] = a_limb;
+}
+
+/**
+ * @brief Exchange contents with another vector. Heap buffers change hands without copying when both
+ *      vectors use the same memory resource.
+ */
+void LimbVector::swap(LimbVector &a_that)
+{
+    LimbVector tmp(std::move(*this));
+    *this = std::move(a_that);
+    a_that = std::move(tmp);
+}
+
+bool LimbVector::operator==(const LimbVector &a_that) const
+{
+    return len == a_that.len && std::equal(begin(), end(), a_that.begin());
+}
+
+/**
+ * @brief Remove the leading zero limbs of a limb vector.
+ *
+ * @param a_vec The vector to be trimmed
+ */
+void trim_limb_vector(LimbVector &a_vec)
+{
+    while (!a_vec.empty() && a_vec.back() == 0)
+    {
+        a_vec.pop_back();
+    }
+}
+
+/**
+ * @brief Set a_r to |a_opr_1| + |a_opr_2|. The output may be either operand.
+ *
+ * @param a_r The vector that accepts the sum
+ * @param a_opr_1 The first operand, trimmed
+ * @param a_opr_2 The second operand, trimmed
+ */
+void add_magnitudes(LimbVector &a_r, const LimbVector &a_opr_1, const LimbVector &a_opr_2)
+{
+    bool opr_1_is_longer = a_opr_1.size() >= a_opr_2.size();
+    const LimbVector &opr_longer = opr_1_is_longer ? a_opr_1 : a_opr_2;
+    const LimbVector &opr_shorter = opr_1_is_longer ? a_opr_2 : a_opr_1;
+    size_t len_longer = opr_longer.size();
+    size_t len_shorter = opr_shorter.size();
+
+    a_r.resize(len_longer + 1);
+    a_r[len_longer] = add_limbs(a_r.data(), opr_longer.data(), len_longer, opr_shorter.data(), len_shorter);
+    trim_limb_vector(a_r);
+}
+
+/**
+ * @brief Set a_r to ||a_opr_1| - |a_opr_2||. The output may be either operand.
+ *
+ * @param a_r The vector that accepts the difference
+ * @param a_opr_1 The first operand, trimmed
+ * @param a_opr_2 The second operand, trimmed
+ * @return If |a_opr_1| is smaller than |a_opr_2|
+ */
+bool sub_magnitudes(LimbVector &a_r, const LimbVector &a_opr_1, const LimbVector &a_opr_2)
+{
+    bool opr_2_is_bigger = cmp_limbs(a_opr_1.data(), a_opr_1.size(), a_opr_2.data(), a_opr_2.size()) < 0;
+    const LimbVector &opr_bigger = opr_2_is_bigger ? a_opr_2 : a_opr_1;
+    const LimbVector &opr_smaller = opr_2_is_bigger ? a_opr_1 : a_opr_2;
+    size_t len_bigger = opr_bigger.size();
+    size_t len_smaller = opr_smaller.size();
+
+    a_r.resize(len_bigger);
+    sub_limbs(a_r.data(), opr_bigger.data(), len_bigger, opr_smaller.data(), len_smaller);
+    trim_limb_vector(a_r);
+    return opr_2_is_bigger;
+}
+
+/**
+ * @brief Add one to a magnitude in place.
+ *
+ * @param a_vec The magnitude, trimmed
+ */
+void increment_magnitude(LimbVector &a_vec)
+{
+    for (limb_t &limb : a_vec)
+    {
+        if (++limb != 0)
+        {
+            return;
+        }
+    }
+    a_vec.push_back(1);
+}
+
+/**
+ * @brief Subtract one from a nonzero magnitude in place.
+ *
+ * @param a_vec The magnitude, trimmed and nonzero
+ */
+void decrement_magnitude(LimbVector &a_vec)
+{
+    for (limb_t &limb : a_vec)
+    {
+        if (limb-- != 0)
+        {
+            break;
+        }
+    }
+    trim_limb_vector(a_vec);
+}
+
+/**
+ * @brief Set a_r to |a_opr| * 2^a_bits: whole limbs are moved up, then the rest is one funnel shift.
+ *      The output may be the operand.
+ *
+ * @param a_r The vector that accepts the result
+ * @param a_opr The magnitude, trimmed
+ * @param a_bits The number of bits to shift by
+ */
+void shift_left_magnitude(LimbVector &a_r, const LimbVector &a_opr, size_t a_bits)
+{
+    size_t len = a_opr.size();
+    if (len == 0)
+    {
+        a_r.clear();
+        return;
+    }
+    size_t limbs = a_bits / LIMB_BITS;
+    a_r.resize(len + limbs + 1);
+    limb_t *r = a_r.data();
+    r[len + limbs] = lsh_limbs(r + limbs, a_opr.data(), len, (unsigned)(a_bits % LIMB_BITS));
+    std::fill(r, r + limbs, 0);
+    trim_limb_vector(a_r);
+}
+
+/**
+ * @brief Set a_r to |a_opr| / 2^a_bits, rounded down: whole limbs are dropped, then the rest is one funnel
+ *      shift. The output may be the operand.
+ *
+ * @param a_r The vector that accepts the result
+ * @param a_opr The magnitude, trimmed
+ * @param a_bits The number of bits to shift by
+ * @return If any of the bits shifted out were set
+ */
+bool shift_right_magnitude(LimbVector &a_r, const LimbVector &a_opr, size_t a_bits)
+{
+    size_t len = a_opr.size();
+    size_t limbs = a_bits / LIMB_BITS;
+    if (limbs >= len)
+    {
+        a_r.clear();
+        return len > 0;
+    }
+    const limb_t *opr = a_opr.data();
+    bool lost = std::any_of(opr, opr + limbs, [](limb_t a_limb) { return a_limb != 0; });
+    if (a_r.size() < len - limbs)
+    {
+        // Only when a_r is another vector, so this leaves opr in place.
+        a_r.resize(len - limbs);
+    }
+    lost = rsh_limbs(a_r.data(), opr + limbs, len - limbs, (unsigned)(a_bits % LIMB_BITS)) != 0 || lost;
+    a_r.resize(len - limbs);
+    trim_limb_vector(a_r);
+    return lost;
+}
+
+enum class BitwiseOp
+{
+    And,
+    Or,
+    Xor
+};
+
+/**
+ * @brief Apply a bitwise operation to two signed magnitudes as if both were in two's complement, with
+ *      infinitely many copies of the sign bit. A negative operand is complemented a limb at a time as it is
+ *      read, and a negative result as it is written, so the operation is one pass without temporaries.
+ *      The output may be either operand.
+ *
+ * @param a_r The vector that accepts the magnitude of the result
+ * @param a_is_positive_1 The sign of the first operand
+ * @param a_opr_1 The magnitude of the first operand, trimmed
+ * @param a_is_positive_2 The sign of the second operand
+ * @param a_opr_2 The magnitude of the second operand, trimmed
+ * @param a_op The operation
+ * @return If the result is positive
+ */
+bool bitwise_magnitudes(LimbVector &a_r, bool a_is_positive_1, const LimbVector &a_opr_1,
+                        bool a_is_positive_2, const LimbVector &a_opr_2, BitwiseOp a_op)
+{
+    // Zero is positive, so a negative magnitude is never zero and its borrow never runs past its top limb.
+    bool neg_1 = !a_is_positive_1;
+    bool neg_2 = !a_is_positive_2;
+    bool neg_r = (a_op == BitwiseOp::And) ? (neg_1 && neg_2) : (a_op == BitwiseOp::Or) ? (neg_1 || neg_2) : (neg_1 != neg_2);
+    size_t len_1 = a_opr_1.size();
+    size_t len_2 = a_opr_2.size();
+    size_t len = std::max(len_1, len_2);
+    if (a_op == BitwiseOp::And && !neg_r)
+    {
+        // A positive operand bounds the result; above it the sign bits of the other are masked off.
+        len = (neg_1) ? len_2 : (neg_2) ? len_1 : std::min(len_1, len_2);
+    }
+
+    // One more limb for the result, whose magnitude may reach 2^(64 len) when it is negative.
+    a_r.resize(std::max(a_r.size(), len + 1));
+    const limb_t *limbs_1 = a_opr_1.data();
+    const limb_t *limbs_2 = a_opr_2.data();
+    limb_t *r = a_r.data();
+    limb_t borrow_1 = neg_1;
+    limb_t borrow_2 = neg_2;
+    limb_t carry_r = neg_r;
+    for (size_t i = 0; i <= len; i++)
+    {
+        limb_t limb_1 = (i < len_1) ? limbs_1[i] : 0;
+        limb_t limb_2 = (i < len_2) ? limbs_2[i] : 0;
+        if (neg_1)
+        {
+            limb_t diff = limb_1 - borrow_1;
+            borrow_1 &= (limb_1 == 0);
+            limb_1 = ~diff;
+        }
+        if (neg_2)
+        {
+            limb_t diff = limb_2 - borrow_2;
+            borrow_2 &= (limb_2 == 0);
+            limb_2 = ~diff;
+        }
+        limb_t limb_r = (a_op == BitwiseOp::And) ? (limb_1 & limb_2) : (a_op == BitwiseOp::Or) ? (limb_1 | limb_2) : (limb_1 ^ limb_2);
+        if (neg_r)
+        {
+            limb_r = ~limb_r + carry_r;
+            carry_r &= (limb_r == 0);
+        }
+        r[i] = limb_r;
+    }
+    a_r.resize(len + 1);
+    trim_limb_vector(a_r);
+    return !neg_r || a_r.empty();
+}
+
+/**
+ * @brief Set a_r to |a_mnd| * |a_mer|. The output may be either operand.
+ *
+ * @param a_r The vector that accepts the product
+ * @param a_mnd The number to be multiplied, trimmed
+ * @param a_mer The multiplier, trimmed
+ * @param a_algorithm The algorithm to use at the top level
+ */
+void mul_magnitudes(LimbVector &a_r, const LimbVector &a_mnd, const LimbVector &a_mer,
+                    MulAlgorithm a_algorithm = MulAlgorithm::Auto)
+{
+    BIGINT_PROBE(InstrumentOp::Mul, std::max(a_mnd.size(), a_mer.size()));
+    if (a_mnd.empty() || a_mer.empty())
+    {
+        a_r.clear();
+        return;
+    }
+    // The product goes to a per-thread buffer, which then trades places with the output, so that
+    // a_r *= b reuses the output's old buffer on the next call.
+    static thread_local LimbVector result(std::pmr::new_delete_resource());
+    result.resize(a_mnd.size() + a_mer.size());
+    mul_limbs(result.data(), a_mnd.data(), a_mnd.size(), a_mer.data(), a_mer.size(), a_algorithm);
+    trim_limb_vector(result);
+    a_r.swap(result);
+}
+
+/**
+ * @brief Add |a_mnd| * |a_mer| to a_r. Short products are accumulated row by row straight into the
+ *      output, so a multiply-accumulate needs no temporary for the product.
+ *
+ * @param a_r The vector that accumulates the product, which must not be either operand
+ * @param a_mnd The number to be multiplied, trimmed
+ * @param a_mer The multiplier, trimmed
+ */
+void addmul_magnitudes(LimbVector &a_r, const LimbVector &a_mnd, const LimbVector &a_mer)
+{
+    if (a_mnd.empty() || a_mer.empty()) return;
+    bool mnd_is_longer = a_mnd.size() >= a_mer.size();
+    const LimbVector &opr_longer = mnd_is_longer ? a_mnd : a_mer;
+    const LimbVector &opr_shorter = mnd_is_longer ? a_mer : a_mnd;
+    size_t len_longer = opr_longer.size();
+    size_t len_shorter = opr_shorter.size();
+
+    if (len_shorter >= std::max<size_t>(mul_thresholds.karatsuba, 4))
+    {
+        if (a_r.empty())
+        {
+            mul_magnitudes(a_r, a_mnd, a_mer);
+            return;
+        }
+        static thread_local LimbVector product(std::pmr::new_delete_resource());
+        mul_magnitudes(product, a_mnd, a_mer);
+        add_magnitudes(a_r, a_r, product);
+        return;
+    }
+
+    size_t len = std::max(a_r.size(), len_longer + len_shorter) + 1;
+    a_r.resize(len);
+    for (size_t i = 0; i < len_shorter; i++)
+    {
+        limb_t carry = addmul_1_limbs(a_r.data() + i, opr_longer.data(), len_longer, opr_shorter[i]);
+        for (size_t j = i + len_longer; carry != 0; j++)
+        {
+            a_r[j] += carry;
+            carry = (a_r[j] < carry);
+        }
+    }
+    trim_limb_vector(a_r);
+}
+
+/**
+ * @brief Divide two magnitudes, giving the quotient and the remainder. Long divisors with long quotients
+ *      use Burnikel-Ziegler division and the rest Algorithm D, both into per-thread buffers, so a warm
+ *      division does not allocate. The outputs may be the operands.
+ *
+ * @param a_q The vector that accepts the quotient
+ * @param a_rem The vector that accepts the remainder
+ * @param a_dvd The dividend, trimmed
+ * @param a_dvs The divisor, trimmed
+ * @throw domain_error if the divisor is zero
+ */
+void divmod_magnitudes(LimbVector &a_q, LimbVector &a_rem, const LimbVector &a_dvd, const LimbVector &a_dvs)
+{
+    BIGINT_PROBE(InstrumentOp::Div, a_dvd.size());
+    if (a_dvs.empty())
+    {
+        throw domain_error("Cannot divide by zero");
+    }
+    if (cmp_limbs(a_dvd.data(), a_dvd.size(), a_dvs.data(), a_dvs.size()) < 0)
+    {
+        a_rem = a_dvd;
+        a_q.clear();
+        return;
+    }
+    // As in mul_magnitudes, per-thread buffers trade places with the outputs.
+    static thread_local LimbVector quot(std::pmr::new_delete_resource());
+    static thread_local LimbVector rem(std::pmr::new_delete_resource());
+    quot.resize(a_dvd.size() - a_dvs.size() + 1);
+    rem.resize(a_dvs.size());
+    // The same choice as div_limb_vectors_bare.
+    if (a_dvs.size() >= div_thresholds.burnikel_ziegler &&
+        a_dvd.size() - a_dvs.size() >= div_thresholds.burnikel_ziegler)
+    {
+        BIGINT_TIER(DivideAndConquer);
+        div_limbs_bz(quot.data(), rem.data(), a_dvd.data(), a_dvd.size(), a_dvs.data(), a_dvs.size());
+    }
+    else
+    {
+        div_limbs(quot.data(), rem.data(), a_dvd.data(), a_dvd.size(), a_dvs.data(), a_dvs.size());
+    }
+    trim_limb_vector(quot);
+    trim_limb_vector(rem);
+    a_q.swap(quot);
+    a_rem.swap(rem);
+}
+
+/**
+ * @brief Pack a vector of bools, most significant bit first, into trimmed limbs.
+ *
+ * @param a_bools The bools to be packed
+ * @return The limbs, least significant first
+ */
+vector<limb_t> bools_to_limbs(const vector<bool> &a_bools)
+{
+    vector<limb_t> result((a_bools.size() + LIMB_BITS - 1) / LIMB_BITS);
+    for (size_t i = 0; i < a_bools.size(); i++)
+    {
+        if (a_bools[a_bools.size() - i - 1])
+        {
+            result[i / LIMB_BITS] |= (limb_t)1 << (i % LIMB_BITS);
+        }
+    }
+    trim_limb_vector(result);
+    return result;
+}
+
+/**
+ * @brief Unpack limbs into a vector of bools, most significant bit first, without leading zeros.
+ *
+ * @param a_limbs The limbs to be unpacked, least significant first
+ * @return The bools
+ */
+vector<bool> limbs_to_bools(const vector<limb_t> &a_limbs)
+{
+    vector<bool> result;
+    if (is_zero_vector(a_limbs))
+    {
+        return result;
+    }
+    size_t top = a_limbs.size() - 1;
+    while (a_limbs[top] == 0)
+    {
+        top--;
+    }
+    size_t n_bits = top * LIMB_BITS + (LIMB_BITS - (size_t)__builtin_clzll(a_limbs[top]));
+    result.resize(n_bits);
+    for (size_t i = 0; i < n_bits; i++)
+    {
+        result[n_bits - i - 1] = (a_limbs[i / LIMB_BITS] >> (i % LIMB_BITS)) & 1;
+    }
+    return result;
+}
+
+/**
+ * @brief The largest power of ten that fits in a limb, 10^19. Decimal conversion works in chunks of this size.
+ */
+const limb_t DEC_CHUNK = 10000000000000000000ULL;
+
+/**
+ * @brief Number of decimal digits in a chunk of DEC_CHUNK.
+ */
+const size_t DEC_CHUNK_DIGITS = 19;
+
+/**
+ * @brief Below this many limbs, decimal conversion divides by DEC_CHUNK repeatedly instead of splitting.
+ */
+const size_t TO_STR_SCHOOLBOOK_LIMBS = 30;
+
+/**
+ * @brief Return the cached power 10^(19 * 2^k), computing it by repeated squaring on first use. The
+ *      squaring runs without the lock held, since in parallel mode it may help with other threads'
+ *      conversions, which need the cache too. Two threads may then compute the same power, and the
+ *      first to finish stores it.
+ *
+ * @param a_k The exponent k
+ * @return The trimmed limbs of 10^(19 * 2^k)
+ */
+const vector<limb_t> &pow10_limbs(size_t a_k)
+{
+    static std::mutex cache_mutex;
+    static std::deque<vector<limb_t>> cache{vector<limb_t>{DEC_CHUNK}};
+    std::unique_lock<std::mutex> lock(cache_mutex);
+    while (cache.size() <= a_k)
+    {
+        // Elements of a deque stay in place as it grows, so the last power may be read unlocked.
+        size_t known = cache.size();
+        const vector<limb_t> &last = cache.back();
+        lock.unlock();
+        vector<limb_t> next = mul_limb_vectors(last, last);
+        lock.lock();
+        if (cache.size() == known)
+        {
+            cache.push_back(std::move(next));
+        }
+    }
+    return cache[a_k];
+}
+
+/**
+ * @brief The default size of the buffer of a DecimalSink, in characters.
+ */
+const size_t DECIMAL_SINK_BYTES = 1 << 16;
+
+/**
+ * @brief An output for decimal conversion that collects digits in a buffer of bounded size and hands
+ *      each full buffer to a callback, so that the digits of a huge value are never all in memory at once.
+ *      It has the two append methods of std::string that the conversion uses.
+ */
+class DecimalSink
+{
+public:
+    DecimalSink(std::function<void(const char *, size_t)> a_write, size_t a_capacity = DECIMAL_SINK_BYTES)
+        : write(std::move(a_write)), buffer(std::max<size_t>(a_capacity, 1)) {}
+
+    /**
+     * @brief Append characters, passing on the buffer whenever it fills.
+     */
+    void append(const char *a_chars, size_t a_len)
+    {
+        while (a_len > 0)
+        {
+            size_t n = std::min(a_len, this->buffer.size() - this->used);
+            std::copy(a_chars, a_chars + n, this->buffer.data() + this->used);
+            this->used += n;
+            a_chars += n;
+            a_len -= n;
+            if (this->used == this->buffer.size())
+            {
+                this->flush();
+            }
+        }
+    }
+
+    /**
+     * @brief Append a character a_count times.
+     */
+    void append(size_t a_count, char a_chr)
+    {
+        while (a_count > 0)
+        {
+            size_t n = std::min(a_count, this->buffer.size() - this->used);
+            std::fill(this->buffer.data() + this->used, this->buffer.data() + this->used + n, a_chr);
+            this->used += n;
+            a_count -= n;
+            if (this->used == this->buffer.size())
+            {
+                this->flush();
+            }
+        }
+    }
+
+    /**
+     * @brief Pass on the characters in the buffer.
+     */
+    void flush()
+    {
+        if (this->used > 0)
+        {
+            this->write(this->buffer.data(), this->used);
+            this->used = 0;
+        }
+    }
+
+private:
+    std::function<void(const char *, size_t)> write;
+    vector<char> buffer;
+    size_t used = 0;
+};
+
+/**
+ * @brief Append the decimal digits of a small limb array to a string or a DecimalSink by repeated
+ *      division by DEC_CHUNK.
+ *
+ * @param a_limbs The limbs to be converted
+ * @param a_len The number of limbs
+ * @param a_width If not zero, pad the digits with leading zeros to this width
+ * @param a_out The string or sink to append to
+ */
+template <typename Out>
+void limbs_to_decimal_schoolbook(const limb_t *a_limbs, size_t a_len, size_t a_width, Out &a_out)
+{
+    ScratchFrame frame;
+    limb_t *tmp = frame.limbs(a_len);
+    std::copy(a_limbs, a_limbs + a_len, tmp);
+    scratch_vector chunks(&scratch_arena());
+    chunks.reserve(a_len * 2);
+    size_t len = a_len;
+    while (len > 0 && tmp[len - 1] == 0)
+    {
+        len--;
+    }
+    static const LimbDivisor chunk_divisor(DEC_CHUNK);
+    while (len > 0)
+    {
+        chunks.push_back(div_1_limbs(tmp, tmp, len, chunk_divisor));
+        while (len > 0 && tmp[len - 1] == 0)
+        {
+            len--;
+        }
+    }
+
+    // Every chunk but the most significant one is padded to 19 digits.
+    size_t digits_len = 0;
+    if (!chunks.empty())
+    {
+        digits_len = (chunks.size() - 1) * DEC_CHUNK_DIGITS + 1;
+        for (limb_t top = chunks.back(); top >= 10; top /= 10)
+        {
+            digits_len++;
+        }
+    }
+    if (a_width > digits_len)
+    {
+        a_out.append(a_width - digits_len, '0');
+    }
+    char buf[DEC_CHUNK_DIGITS];
+    for (size_t i = chunks.size(); i-- > 0;)
+    {
+        size_t pos = DEC_CHUNK_DIGITS;
+        limb_t chunk = chunks[i];
+        do
+        {
+            buf[--pos] = (char)('0' + chunk % 10);
+            chunk /= 10;
+        } while (chunk != 0);
+        if (i + 1 < chunks.size())
+        {
+            std::fill(buf, buf + pos, '0');
+            pos = 0;
+        }
+        a_out.append(buf + pos, DEC_CHUNK_DIGITS - pos);
+    }
+}
+
+/**
+ * @brief Append the decimal digits of a limb array to a string or a DecimalSink. Large values are split
+ *      by a cached power 10^(19 * 2^k) into a quotient and a remainder, which are converted recursively,
+ *      most significant first, so a sink receives the digits in order and only the quotients and
+ *      remainders on the current path of the recursion are alive, about twice the size of the value.
+ *
+ * @param a_limbs The limbs to be converted
+ * @param a_len The number of limbs
+ * @param a_width If not zero, pad the digits with leading zeros to this width
+ * @param a_out The string or sink to append to
+ */
+template <typename Out>
+void limbs_to_decimal(const limb_t *a_limbs, size_t a_len, size_t a_width, Out &a_out)
+{
+    while (a_len > 0 && a_limbs[a_len - 1] == 0)
+    {
+        a_len--;
+    }
+    if (a_len <= TO_STR_SCHOOLBOOK_LIMBS)
+    {
+        BIGINT_TIER(Basecase);
+        limbs_to_decimal_schoolbook(a_limbs, a_len, a_width, a_out);
+        return;
+    }
+    BIGINT_TIER(DivideAndConquer);
+
+    // Pick the largest power of about half the length, so that the quotient is never zero.
+    size_t k = 0;
+    while (pow10_limbs(k + 1).size() * 2 <= a_len + 1)
+    {
+        k++;
+    }
+    const vector<limb_t> &pow = pow10_limbs(k);
+    size_t pow_digits = DEC_CHUNK_DIGITS << k;
+
+    ScratchFrame frame;
+    size_t quot_len = a_len - pow.size() + 1;
+    limb_t *quot = frame.limbs(quot_len);
+    limb_t *rem = frame.limbs(pow.size());
+    // Long splits use Burnikel-Ziegler division on the same terms as div_limb_vectors_bare. Both write
+    // straight into the scratch arrays, so a warm conversion does not allocate.
+    if (pow.size() >= div_thresholds.burnikel_ziegler && a_len - pow.size() >= div_thresholds.burnikel_ziegler)
+    {
+        div_limbs_bz(quot, rem, a_limbs, a_len, pow.data(), pow.size());
+    }
+    else
+    {
+        div_limbs(quot, rem, a_limbs, a_len, pow.data(), pow.size());
+    }
+    size_t quot_width = (a_width > pow_digits) ? a_width - pow_digits : 0;
+    // A sink converts serially, since converting both halves at once would hold the low digits in memory.
+    if constexpr (std::is_same_v<Out, string>)
+    {
+        if (parallel_settings.pool != nullptr && a_len >= parallel_settings.to_str)
+        {
+            // The low digits go to a string of their own, so that both halves can be converted at once.
+            string low;
+            parallel_run(2, a_len, parallel_settings.to_str, [&](size_t a_i) {
+                if (a_i == 0)
+                {
+                    limbs_to_decimal(quot, quot_len, quot_width, a_out);
+                }
+                else
+                {
+                    limbs_to_decimal(rem, pow.size(), pow_digits, low);
+                }
+            });
+            a_out += low;
+            return;
+        }
+    }
+    limbs_to_decimal(quot, quot_len, quot_width, a_out);
+    limbs_to_decimal(rem, pow.size(), pow_digits, a_out);
+}
+
+/**
+ * @brief Below this many digits, decimal parsing accumulates 19-digit chunks directly instead of splitting.
+ */
+const size_t PARSE_SCHOOLBOOK_DIGITS = TO_STR_SCHOOLBOOK_LIMBS * DEC_CHUNK_DIGITS;
+
+/**
+ * @brief Convert a run of at most 19 decimal digits to a limb. The digits must have been validated.
+ *
+ * @param a_digits The digits
+ * @param a_len The number of digits
+ * @return The value of the digits
+ */
+limb_t digits_to_limb(const char *a_digits, size_t a_len)
+{
+    limb_t result = 0;
+    for (size_t i = 0; i < a_len; i++)
+    {
+        result = result * 10 + (limb_t)(a_digits[i] - '0');
+    }
+    return result;
+}
+
+/**
+ * @brief Convert a short run of validated decimal digits to limbs, 19 digits at a time.
+ *
+ * @param a_digits The digits, most significant first
+ * @param a_len The number of digits
+ * @param a_result The vector that accepts the trimmed limbs of the value
+ */
+void decimal_to_limbs_schoolbook(const char *a_digits, size_t a_len, LimbVector &a_result)
+{
+    a_result.clear();
+    a_result.reserve(a_len / DEC_CHUNK_DIGITS + 1);
+    size_t first_len = a_len % DEC_CHUNK_DIGITS;
+    if (first_len == 0 && a_len > 0)
+    {
+        first_len = DEC_CHUNK_DIGITS;
+    }
+    if (a_len > 0)
+    {
+        a_result.push_back(digits_to_limb(a_digits, first_len));
+    }
+    for (size_t pos = first_len; pos < a_len; pos += DEC_CHUNK_DIGITS)
+    {
+        limb_t carry = digits_to_limb(a_digits + pos, DEC_CHUNK_DIGITS);
+        for (limb_t &limb : a_result)
+        {
+            dlimb_t prod = (dlimb_t)limb * DEC_CHUNK + carry;
+            limb = (limb_t)prod;
+            carry = (limb_t)(prod >> LIMB_BITS);
+        }
+        if (carry != 0)
+        {
+            a_result.push_back(carry);
+        }
+    }
+    trim_limb_vector(a_result);
+}
+
+/**
+ * @brief Convert a run of validated decimal digits to limbs. Long runs are split into a high and a low part,
+ *      where the low part has 19 * 2^k digits, and combined as high * 10^(19 * 2^k) + low.
+ *
+ * @param a_digits The digits, most significant first
+ * @param a_len The number of digits
+ * @return The trimmed limbs of the value
+ */
+vector<limb_t> decimal_to_limbs(const char *a_digits, size_t a_len)
+{
+    if (a_len <= PARSE_SCHOOLBOOK_DIGITS)
+    {
+        LimbVector result;
+        decimal_to_limbs_schoolbook(a_digits, a_len, result);
+        return result.to_vector();
+    }
+
+    size_t k = 0;
+    while ((DEC_CHUNK_DIGITS << (k + 1)) < a_len)
+    {
+        k++;
+    }
+    size_t low_len = DEC_CHUNK_DIGITS << k;
+    vector<limb_t> high;
+    vector<limb_t> low;
+    parallel_run(2, a_len, parallel_settings.parse, [&](size_t a_i) {
+        if (a_i == 0)
+        {
+            high = decimal_to_limbs(a_digits, a_len - low_len);
+        }
+        else
+        {
+            low = decimal_to_limbs(a_digits + a_len - low_len, low_len);
+        }
+    });
+    return add_limb_vectors(mul_limb_vectors(high, pow10_limbs(k)), low);
+}
+
+/**
+ * @brief Describe why a string cannot be parsed as an integer.
+ *
+ * @param a_in The string being parsed
+ * @param a_pos The position of the offending character
+ * @return An error message naming the character and its position
+ */
+string describe_parse_error(const string &a_in, size_t a_pos)
+{
+    unsigned char chr = (unsigned char)a_in[a_pos];
+    string what;
+    if (chr == '+' || chr == '-')
+    {
+        what = string("unexpected sign '") + (char)chr + "'";
+    }
+    else if (chr == ' ' || (chr >= '\t' && chr <= '\r'))
+    {
+        what = "unexpected whitespace";
+    }
+    else if (chr >= 0x20 && chr < 0x7f)
+    {
+        what = string("invalid character '") + (char)chr + "'";
+    }
+    else
+    {
+        what = "invalid byte " + to_string((unsigned)chr);
+    }
+    return "Cannot parse integer: " + what + " at position " + to_string(a_pos);
+}
+
+template <typename Expr>
+struct IntExpr;
+
+/**
+ * @brief The built-in integer types that Int converts from and operates with directly: the standard
+ *      integer types other than bool, and the 128-bit ones.
+ */
+template <typename T>
+concept BuiltinInteger = (std::is_integral_v<T> && !std::is_same_v<T, bool>) ||
+                         std::is_same_v<T, __int128> || std::is_same_v<T, unsigned __int128>;
+
+/**
+ * @brief Return if a built-in integer is negative.
+ */
+template <BuiltinInteger T>
+bool builtin_is_negative(T a_value)
+{
+    return a_value < T(0);
+}
+
+/**
+ * @brief Return the absolute value of a built-in integer, which fits in 128 bits even for the most
+ *      negative value of a signed type.
+ */
+template <BuiltinInteger T>
+dlimb_t builtin_magnitude(T a_value)
+{
+    dlimb_t mag = (dlimb_t)a_value;
+    return builtin_is_negative(a_value) ? (dlimb_t)0 - mag : mag;
+}
+
+/**
+ * @brief Return the largest magnitude a built-in integer type holds with a given sign.
+ */
+template <BuiltinInteger T>
+dlimb_t builtin_max_magnitude(bool a_is_negative)
+{
+    constexpr bool is_signed = T(-1) < T(0);
+    constexpr unsigned bits = 8 * sizeof(T) - (is_signed ? 1 : 0);
+    dlimb_t max = (bits == 128) ? ~(dlimb_t)0 : ((dlimb_t)1 << bits) - 1;
+    if (!a_is_negative)
+    {
+        return max;
+    }
+    return is_signed ? max + 1 : 0;
+}
+
+/**
+ * @brief Arbitrary-length integer, stored as a sign and a magnitude of 64-bit limbs, least significant first.
+ *      Its length is technically limited by size_t, though this limitation is unlikely to come up.
+ *      The magnitude never has leading zero limbs and zero is always positive, so every value has one
+ *      representation; the constructors and operators all keep this form.
+ */
+class Int
+{
+public:
+    Int(const Int &);
+    Int(const Int &, std::pmr::memory_resource *);
+    Int(Int &&) noexcept;
+    explicit Int(std::pmr::memory_resource *);
+    Int(const string &);
+    Int(const bool &, const vector<bool> &);
+    template <typename Expr>
+    Int(const IntExpr<Expr> &);
+    template <BuiltinInteger T>
+    Int(T);
+
+    static Int from_limbs(const bool &, const vector<limb_t> &);
+    static Int from_limbs(const bool &, LimbVector &&);
+
+    bool is_positive = true;
+    LimbVector limbs;
+
+    std::pmr::memory_resource *get_resource() const { return limbs.get_resource(); }
+
+    Int &operator=(const Int &);
+    Int &operator=(Int &&);
+    template <typename Expr>
+    Int &operator=(const IntExpr<Expr> &);
+    template <typename Expr>
+    Int &operator+=(const IntExpr<Expr> &);
+    template <typename Expr>
+    Int &operator-=(const IntExpr<Expr> &);
+
+    friend ostream &operator<<(const ostream &, const Int &);
+    Int operator-() const &;
+    Int operator-() &&;
+    Int operator+(const Int &) const;
+    Int &operator+=(const Int &);
+    Int operator-(const Int &a_that) const;
+    Int &operator-=(const Int &a_that);
+    Int operator*(const Int &a_that) const;
+    Int &operator*=(const Int &a_that);
+    Int operator/(const Int &a_that) const;
+    Int &operator/=(const Int &a_that);
+    Int operator%(const Int &a_that) const;
+    Int &operator%=(const Int &a_that);
+    Int operator~() const;
+    Int operator&(const Int &a_that) const;
+    Int &operator&=(const Int &a_that);
+    Int operator|(const Int &a_that) const;
+    Int &operator|=(const Int &a_that);
+    Int operator^(const Int &a_that) const;
+    Int &operator^=(const Int &a_that);
+    Int operator<<(size_t a_bits) const;
+    Int &operator<<=(size_t a_bits);
+    Int operator>>(size_t a_bits) const;
+    Int &operator>>=(size_t a_bits);
+    bool test_bit(size_t a_bit) const;
+    size_t bit_length() const;
+    size_t popcount() const;
+    size_t ctz() const;
+    bool operator==(const Int &a_that) const;
+    bool operator!=(const Int &a_that) const;
+    bool operator>(const Int &a_that) const;
+    bool operator<(const Int &a_that) const;
+    bool operator>=(const Int &a_that) const;
+    bool operator<=(const Int &a_that) const;
+    strong_ordering compare(const Int &a_that) const;
+    template <BuiltinInteger T>
+    Int operator+(T a_that) const;
+    template <BuiltinInteger T>
+    Int &operator+=(T a_that);
+    template <BuiltinInteger T>
+    Int operator-(T a_that) const;
+    template <BuiltinInteger T>
+    Int &operator-=(T a_that);
+    template <BuiltinInteger T>
+    Int operator*(T a_that) const;
+    template <BuiltinInteger T>
+    Int &operator*=(T a_that);
+    template <BuiltinInteger T>
+    Int operator/(T a_that) const;
+    template <BuiltinInteger T>
+    Int &operator/=(T a_that);
+    template <BuiltinInteger T>
+    Int operator%(T a_that) const;
+    template <BuiltinInteger T>
+    Int &operator%=(T a_that);
+    template <BuiltinInteger T>
+    bool operator==(T a_that) const;
+    template <BuiltinInteger T>
+    strong_ordering operator<=>(T a_that) const;
+    template <BuiltinInteger T>
+    strong_ordering compare(T a_that) const;
+    template <BuiltinInteger T>
+    bool fits_in() const;
+    int64_t to_int64() const;
+    string to_str() const;
+    string to_str_bools() const;
+    vector<bool> to_bools() const;
+    size_t digits_needed(int) const;
+
+private:
+    Int() = default;
+    void consume_str_to_limbs(const string &, size_t);
+    static void add_signed(Int &, const Int &, const Int &, bool);
+    void assign_builtin(bool, dlimb_t);
+    void add_builtin(bool, dlimb_t);
+    void mul_builtin(bool, dlimb_t);
+    void div_builtin(bool, dlimb_t);
+    Int rem_builtin(dlimb_t) const;
+    strong_ordering compare_builtin(bool, dlimb_t) const;
+    dlimb_t low_magnitude() const;
+};
+
+/**
+ * @brief Return the magnitude of this integer as a vector of bools, most significant bit first.
+ *
+ * @return The magnitude of this integer as a vector of bools.
+ */
+vector<bool> Int::to_bools() const
+{
+    return limbs_to_bools(this->limbs.to_vector());
+}
+
+/**
+ * @brief Return a string representation of this integer.
+ *
+ * @return A string representation of this integer.
+ */
+string Int::to_str() const
+{
+    BIGINT_PROBE(InstrumentOp::ToStr, this->limbs.size());
+    if (this->limbs.empty()) return "0";
+    string result = (this->is_positive ? "" : "-");
+    result.reserve(this->limbs.size() * 20 + 1);
+    limbs_to_decimal(this->limbs.data(), this->limbs.size(), 0, result);
+    return result;
+}
+
+/**
+ * @brief Constructor from a string of digits, optionally preceded by a '-'.
+ *
+ * @param a_in a string to construct from
+ * @throw invalid_argument if the input is empty, or contains anything other than a leading '-' and digits.
+ */
+Int::Int(const string &a_in)
+{
+    if (a_in.empty())
+    {
+        throw invalid_argument("Cannot parse integer: empty string");
+    }
+    BIGINT_PROBE(InstrumentOp::Parse, a_in.size() / DEC_CHUNK_DIGITS + 1);
+    this->is_positive = a_in[0] != '-';
+    size_t start = this->is_positive ? 0 : 1;
+    if (start == a_in.size())
+    {
+        throw invalid_argument("Cannot parse integer: no digits after '-'");
+    }
+    consume_str_to_limbs(a_in, start);
+    this->is_positive = this->is_positive || this->limbs.empty();
+};
+
+/**
+ * @brief Copy constructor.
+ *
+ * @param a_int another instance of Int
+ */
+Int::Int(const Int &a_int)
+{
+    this->is_positive = a_int.is_positive;
+    this->limbs = a_int.limbs;
+};
+
+/**
+ * @brief Copy constructor that takes the heap buffer, if one is needed, from a given memory resource.
+ *
+ * @param a_int another instance of Int
+ * @param a_resource the memory resource for the limbs
+ */
+Int::Int(const Int &a_int, std::pmr::memory_resource *a_resource)
+    : limbs(a_resource)
+{
+    this->is_positive = a_int.is_positive;
+    this->limbs = a_int.limbs;
+};
+
+/**
+ * @brief Move constructor. Takes over the limbs, and their memory resource, of the other instance, which
+ *      is left as zero.
+ *
+ * @param a_int another instance of Int
+ */
+Int::Int(Int &&a_int) noexcept
+    : limbs(std::move(a_int.limbs))
+{
+    this->is_positive = a_int.is_positive;
+    a_int.is_positive = true;
+};
+
+/**
+ * @brief Constructor of zero, whose limbs will take their heap buffer from a given memory resource.
+ *
+ * @param a_resource the memory resource for the limbs
+ */
+Int::Int(std::pmr::memory_resource *a_resource)
+    : limbs(a_resource)
+{
+};
+
+/**
+ * @brief Constructor from attributes.
+ *
+ * @param a_is_positive the sign of the integer
+ * @param a_bools the magnitude of the integer, most significant bit first
+ */
+Int::Int(const bool &a_is_positive, const vector<bool> &a_bools)
+{
+    this->limbs = LimbVector(bools_to_limbs(a_bools));
+    this->is_positive = a_is_positive || this->limbs.empty();
+};
+
+/**
+ * @brief Construct from a sign and limbs, least significant first.
+ *
+ * @param a_is_positive the sign of the integer
+ * @param a_limbs the magnitude of the integer
+ * @return The constructed integer
+ */
+Int Int::from_limbs(const bool &a_is_positive, const vector<limb_t> &a_limbs)
+{
+    Int result;
+    result.limbs = LimbVector(a_limbs);
+    trim_limb_vector(result.limbs);
+    result.is_positive = a_is_positive || result.limbs.empty();
+    return result;
+}
+
+/**
+ * @brief Construct from a sign and limbs, least significant first, taking over the limbs.
+ *
+ * @param a_is_positive the sign of the integer
+ * @param a_limbs the magnitude of the integer
+ * @return The constructed integer
+ */
+Int Int::from_limbs(const bool &a_is_positive, LimbVector &&a_limbs)
+{
+    Int result;
+    result.limbs = std::move(a_limbs);
+    trim_limb_vector(result.limbs);
+    result.is_positive = a_is_positive || result.limbs.empty();
+    return result;
+}
+
+/**
+ * @brief Private method. Take a string, validate it, then load its value into the
+ *      limb field of this object.
+ *
+ * @param a_in the string to be read
+ * @param a_start the position of the first digit
+ * @throw invalid_argument if the input contains non-digit characters.
+ */
+void Int::consume_str_to_limbs(const string &a_in, size_t a_start)
+{
+    for (size_t i = a_start; i < a_in.size(); i++)
+    {
+        if (a_in[i] < '0' || a_in[i] > '9')
+        {
+            throw invalid_argument(describe_parse_error(a_in, i));
+        }
+    }
+    size_t first_nonzero = a_in.find_first_not_of('0', a_start);
+    if (first_nonzero == string::npos)
+    {
+        return;
+    }
+    size_t len = a_in.size() - first_nonzero;
+    if (len <= PARSE_SCHOOLBOOK_DIGITS)
+    {
+        decimal_to_limbs_schoolbook(a_in.data() + first_nonzero, len, limbs);
+        return;
+    }
+    BIGINT_TIER(DivideAndConquer);
+    limbs = LimbVector(decimal_to_limbs(a_in.data() + first_nonzero, len));
+}
+
+
+/**
+ * @brief Write the decimal digits of an integer through a DecimalSink.
+ *
+ * @param a_int The integer
+ * @param a_sink The sink, which is flushed at the end
+ */
+void write_decimal(const Int &a_int, DecimalSink &a_sink)
+{
+    BIGINT_PROBE(InstrumentOp::ToStr, a_int.limbs.size());
+    if (a_int.limbs.empty())
+    {
+        a_sink.append("0", 1);
+    }
+    else
+    {
+        if (!a_int.is_positive)
+        {
+            a_sink.append("-", 1);
+        }
+        limbs_to_decimal(a_int.limbs.data(), a_int.limbs.size(), 0, a_sink);
+    }
+    a_sink.flush();
+}
+
+/**
+ * @brief Return an upper bound on the number of characters of an integer in decimal, sign included: a
+ *      limb has fewer than DEC_CHUNK_DIGITS + 1 digits.
+ *
+ * @param a_int The integer
+ * @return The bound
+ */
+size_t decimal_chars_bound(const Int &a_int)
+{
+    return a_int.limbs.size() * (DEC_CHUNK_DIGITS + 1) + 2;
+}
+
+/**
+ * @brief Write the decimal digits of an integer to a stream in chunks of bounded size, without building
+ *      the whole string.
+ *
+ * @param a_os The stream
+ * @param a_int The integer
+ * @param a_chunk The largest number of characters written at once. The buffer is no larger than the
+ *      digits need.
+ */
+void write_decimal(ostream &a_os, const Int &a_int, size_t a_chunk = DECIMAL_SINK_BYTES)
+{
+    DecimalSink sink([&a_os](const char *a_chars, size_t a_len)
+                     { a_os.write(a_chars, a_len); },
+                     std::min(a_chunk, decimal_chars_bound(a_int)));
+    write_decimal(a_int, sink);
+}
+
+#if __has_include(<unistd.h>)
+/**
+ * @brief Write the decimal digits of an integer to a file descriptor in chunks of bounded size, without
+ *      building the whole string.
+ *
+ * @param a_fd The file descriptor
+ * @param a_int The integer
+ * @param a_chunk The largest number of characters written at once
+ * @throw std::system_error if a write fails
+ */
+void write_decimal(int a_fd, const Int &a_int, size_t a_chunk = DECIMAL_SINK_BYTES)
+{
+    DecimalSink sink([a_fd](const char *a_chars, size_t a_len)
+                     {
+                         while (a_len > 0)
+                         {
+                             ssize_t n = ::write(a_fd, a_chars, a_len);
+                             if (n < 0 && errno == EINTR)
+                             {
+                                 continue;
+                             }
+                             if (n < 0)
+                             {
+                                 throw std::system_error(errno, std::generic_category(), "Cannot write decimal digits");
+                             }
+                             a_chars += n;
+                             a_len -= n;
+                         } },
+                     std::min(a_chunk, decimal_chars_bound(a_int)));
+    write_decimal(a_int, sink);
+}
+#endif
+
+/**
+ * @brief The digits of every radix from 2 to 36, in order.
+ */
+const char RADIX_DIGITS[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+
+/**
+ * @brief Check that a radix is supported.
+ *
+ * @param a_base The radix
+ * @throw domain_error if it is not in [2, 36]
+ */
+void check_radix(int a_base)
+{
+    if (a_base < 2 || a_base > 36)
+    {
+        throw domain_error("Radix " + to_string(a_base) + " is not in [2, 36]");
+    }
+}
+
+/**
+ * @brief Return the value of a digit character in any radix up to 36.
+ *
+ * @param a_chr The character, a digit or a letter of either case
+ * @return Its value, or 36 if it is not a digit
+ */
+unsigned radix_digit_value(char a_chr)
+{
+    if (a_chr >= '0' && a_chr <= '9')
+    {
+        return a_chr - '0';
+    }
+    if (a_chr >= 'a' && a_chr <= 'z')
+    {
+        return a_chr - 'a' + 10;
+    }
+    if (a_chr >= 'A' && a_chr <= 'Z')
+    {
+        return a_chr - 'A' + 10;
+    }
+    return 36;
+}
+
+/**
+ * @brief An output for the conversion functions that writes into a caller's buffer and notes when
+ *      the buffer is too small, in which case it stops writing. It has the append methods of std::string.
+ */
+struct CharRangeOut
+{
+    char *pos;
+    char *last;
+    bool overflow = false;
+
+    void append(const char *a_chars, size_t a_len)
+    {
+        if (overflow || a_len > (size_t)(last - pos))
+        {
+            overflow = true;
+            return;
+        }
+        pos = std::copy(a_chars, a_chars + a_len, pos);
+    }
+
+    void append(size_t a_count, char a_chr)
+    {
+        if (overflow || a_count > (size_t)(last - pos))
+        {
+            overflow = true;
+            return;
+        }
+        pos = std::fill_n(pos, a_count, a_chr);
+    }
+};
+
+/**
+ * @brief Write the digits of a magnitude in a power-of-two radix, by reading each digit's bits straight
+ *      out of the limbs, in linear time.
+ *
+ * @param a_limbs The trimmed limbs, not empty
+ * @param a_len The number of limbs
+ * @param a_shift The number of bits per digit, log2 of the radix
+ * @param a_out The output
+ */
+void limbs_to_radix_pow2(const limb_t *a_limbs, size_t a_len, unsigned a_shift, CharRangeOut &a_out)
+{
+    size_t n_bits = a_len * LIMB_BITS - (size_t)__builtin_clzll(a_limbs[a_len - 1]);
+    size_t n_digits = (n_bits + a_shift - 1) / a_shift;
+    if (a_out.overflow || n_digits > (size_t)(a_out.last - a_out.pos))
+    {
+        a_out.overflow = true;
+        return;
+    }
+    limb_t mask = ((limb_t)1 << a_shift) - 1;
+    for (size_t i = n_digits; i-- > 0;)
+    {
+        size_t bit = i * a_shift;
+        size_t limb = bit / LIMB_BITS;
+        unsigned offset = bit % LIMB_BITS;
+        limb_t digit = a_limbs[limb] >> offset;
+        if (offset + a_shift > LIMB_BITS && limb + 1 < a_len)
+        {
+            digit |= a_limbs[limb + 1] << (LIMB_BITS - offset);
+        }
+        *a_out.pos++ = RADIX_DIGITS[digit & mask];
+    }
+}
+
+/**
+ * @brief Write the digits of a magnitude in a radix that is neither 10 nor a power of two, by repeated
+ *      division by the largest power of the radix that fits in a limb. This takes quadratic time.
+ *
+ * @param a_limbs The trimmed limbs, not empty
+ * @param a_len The number of limbs
+ * @param a_base The radix
+ * @param a_out The output
+ */
+void limbs_to_radix_schoolbook(const limb_t *a_limbs, size_t a_len, unsigned a_base, CharRangeOut &a_out)
+{
+    limb_t chunk_base = a_base;
+    size_t chunk_digits = 1;
+    while (chunk_base <= ~(limb_t)0 / a_base)
+    {
+        chunk_base *= a_base;
+        chunk_digits++;
+    }
+    ScratchFrame frame;
+    limb_t *tmp = frame.limbs(a_len);
+    std::copy(a_limbs, a_limbs + a_len, tmp);
+    scratch_vector chunks(&scratch_arena());
+    LimbDivisor chunk_divisor(chunk_base);
+    size_t len = a_len;
+    while (len > 0)
+    {
+        chunks.push_back(div_1_limbs(tmp, tmp, len, chunk_divisor));
+        while (len > 0 && tmp[len - 1] == 0)
+        {
+            len--;
+        }
+    }
+    // Every chunk but the most significant one is padded to chunk_digits digits.
+    char buf[LIMB_BITS];
+    for (size_t i = chunks.size(); i-- > 0;)
+    {
+        size_t pos = chunk_digits;
+        limb_t chunk = chunks[i];
+        do
+        {
+            buf[--pos] = RADIX_DIGITS[chunk % a_base];
+            chunk /= a_base;
+        } while (chunk != 0);
+        if (i + 1 < chunks.size())
+        {
+            std::fill(buf, buf + pos, '0');
+            pos = 0;
+        }
+        a_out.append(buf + pos, chunk_digits - pos);
+    }
+}
+
+/**
+ * @brief Write an integer into a character range, like std::to_chars: digits in lowercase, a leading
+ *      '-' for negative numbers and no terminating null. Powers of two take linear time and base 10 uses
+ *      the subquadratic decimal conversion. It only allocates while the thread's scratch arena grows.
+ *
+ * @param a_first The start of the range
+ * @param a_last The end of the range
+ * @param a_value The integer
+ * @param a_base The radix, in [2, 36]
+ * @return The end of the written characters, or a_last with std::errc::value_too_large if the range is
+ *      too small, in which case its contents are unspecified
+ * @throw domain_error if the radix is not in [2, 36]
+ */
+std::to_chars_result to_chars(char *a_first, char *a_last, const Int &a_value, int a_base = 10)
+{
+    check_radix(a_base);
+    BIGINT_PROBE(InstrumentOp::ToStr, a_value.limbs.size());
+    CharRangeOut out{a_first, a_last};
+    if (a_value.limbs.empty())
+    {
+        out.append("0", 1);
+    }
+    else
+    {
+        if (!a_value.is_positive)
+        {
+            out.append("-", 1);
+        }
+        if (std::has_single_bit((unsigned)a_base))
+        {
+            limbs_to_radix_pow2(a_value.limbs.data(), a_value.limbs.size(), std::countr_zero((unsigned)a_base), out);
+        }
+        else if (a_base == 10)
+        {
+            limbs_to_decimal(a_value.limbs.data(), a_value.limbs.size(), 0, out);
+        }
+        else
+        {
+            limbs_to_radix_schoolbook(a_value.limbs.data(), a_value.limbs.size(), a_base, out);
+        }
+    }
+    if (out.overflow)
+    {
+        return {a_last, std::errc::value_too_large};
+    }
+    return {out.pos, std::errc()};
+}
+
+/**
+ * @brief Write an integer to a stream in decimal. Values of up to TO_STR_SCHOOLBOOK_LIMBS limbs are
+ *      converted on the stack, so that they do not allocate. Longer ones are streamed in chunks, unless a
+ *      field width is set, which needs the length of the whole string first.
+ */
+ostream &operator<<(ostream &a_os, const Int &a_int)
+{
+    if (a_int.limbs.size() <= TO_STR_SCHOOLBOOK_LIMBS)
+    {
+        char buf[TO_STR_SCHOOLBOOK_LIMBS * (DEC_CHUNK_DIGITS + 1) + 1];
+        std::to_chars_result result = to_chars(buf, buf + sizeof(buf), a_int);
+        a_os << std::string_view(buf, result.ptr - buf);
+        return a_os;
+    }
+    if (a_os.width() != 0)
+    {
+        a_os << a_int.to_str();
+        return a_os;
+    }
+    write_decimal(a_os, a_int);
+    return a_os;
+}
+
+/**
+ * @brief Read an integer from a character range, like std::from_chars: an optional '-' followed by at
+ *      least one digit of the radix, in either case, stopping at the first character that is not one.
+ *      Powers of two are packed into limbs directly in linear time, and base 10 uses the subquadratic
+ *      decimal parser.
+ *
+ * @param a_first The start of the range
+ * @param a_last The end of the range
+ * @param a_value Receives the integer, reusing its capacity. It is left unchanged if there are no digits.
+ * @param a_base The radix, in [2, 36]
+ * @return The first character not parsed, or a_first with std::errc::invalid_argument if there are no digits
+ * @throw domain_error if the radix is not in [2, 36]
+ */
+std::from_chars_result from_chars(const char *a_first, const char *a_last, Int &a_value, int a_base = 10)
+{
+    check_radix(a_base);
+    const char *pos = a_first;
+    bool is_negative = pos != a_last && *pos == '-';
+    pos += is_negative;
+    const char *digits = pos;
+    while (pos != a_last && radix_digit_value(*pos) < (unsigned)a_base)
+    {
+        pos++;
+    }
+    if (pos == digits)
+    {
+        return {a_first, std::errc::invalid_argument};
+    }
+    while (digits != pos && *digits == '0')
+    {
+        digits++;
+    }
+    size_t len = pos - digits;
+    BIGINT_PROBE(InstrumentOp::Parse, len / DEC_CHUNK_DIGITS + 1);
+    if (a_base != 10)
+    {
+        BIGINT_TIER(Basecase);
+    }
+    LimbVector &limbs = a_value.limbs;
+    if (std::has_single_bit((unsigned)a_base))
+    {
+        unsigned shift = std::countr_zero((unsigned)a_base);
+        limbs.resize((len * shift + LIMB_BITS - 1) / LIMB_BITS);
+        std::fill(limbs.begin(), limbs.end(), 0);
+        for (size_t i = 0; i < len; i++)
+        {
+            size_t bit = i * shift;
+            limb_t digit = radix_digit_value(pos[-1 - (ptrdiff_t)i]);
+            limbs[bit / LIMB_BITS] |= digit << (bit % LIMB_BITS);
+            if (bit % LIMB_BITS + shift > LIMB_BITS)
+            {
+                limbs[bit / LIMB_BITS + 1] |= digit >> (LIMB_BITS - bit % LIMB_BITS);
+            }
+        }
+        trim_limb_vector(limbs);
+    }
+    else if (a_base == 10 && len <= PARSE_SCHOOLBOOK_DIGITS)
+    {
+        decimal_to_limbs_schoolbook(digits, len, limbs);
+    }
+    else if (a_base == 10)
+    {
+        BIGINT_TIER(DivideAndConquer);
+        vector<limb_t> result = decimal_to_limbs(digits, len);
+        limbs.assign(result.data(), result.data() + result.size());
+    }
+    else
+    {
+        // Accumulate the largest run of digits that fits in a limb at a time.
+        limb_t chunk_base = a_base;
+        size_t chunk_digits = 1;
+        while (chunk_base <= ~(limb_t)0 / a_base)
+        {
+            chunk_base *= a_base;
+            chunk_digits++;
+        }
+        limbs.clear();
+        for (size_t start = 0; start < len;)
+        {
+            size_t n = std::min(chunk_digits, len - start);
+            limb_t scale = 1;
+            limb_t carry = 0;
+            for (size_t i = 0; i < n; i++)
+            {
+                scale *= a_base;
+                carry = carry * a_base + radix_digit_value(digits[start + i]);
+            }
+            start += n;
+            for (limb_t &limb : limbs)
+            {
+                dlimb_t prod = (dlimb_t)limb * scale + carry;
+                limb = (limb_t)prod;
+                carry = (limb_t)(prod >> LIMB_BITS);
+            }
+            if (carry != 0)
+            {
+                limbs.push_back(carry);
+            }
+        }
+    }
+    a_value.is_positive = !is_negative || limbs.empty();
+    return {pos, std::errc()};
+}
+
+/**
+ * @brief Return the exact number of characters to_chars writes for this integer, including the sign.
+ *      Powers of two are counted from the bit length. Other radixes take the two candidates that the bit
+ *      length allows, and settle between them by comparing with a power of the radix when they differ.
+ *
+ * @param a_base The radix, in [2, 36]
+ * @return The number of characters
+ * @throw domain_error if the radix is not in [2, 36]
+ */
+size_t Int::digits_needed(int a_base) const
+{
+    check_radix(a_base);
+    if (this->limbs.empty())
+    {
+        return 1;
+    }
+    size_t sign = this->is_positive ? 0 : 1;
+    size_t n_bits = this->limbs.size() * LIMB_BITS - (size_t)__builtin_clzll(this->limbs.back());
+    if (std::has_single_bit((unsigned)a_base))
+    {
+        unsigned shift = std::countr_zero((unsigned)a_base);
+        return sign + (n_bits + shift - 1) / shift;
+    }
+    if (this->limbs.size() == 1)
+    {
+        size_t digits = 1;
+        for (limb_t rest = this->limbs[0]; rest >= (limb_t)a_base; rest /= a_base)
+        {
+            digits++;
+        }
+        return sign + digits;
+    }
+    // The magnitude is in [2^(n_bits - 1), 2^n_bits), so its digit count is between these bounds; the
+    // margin covers the rounding of the logarithm.
+    long double log_2 = std::log((long double)2) / std::log((long double)a_base);
+    size_t low = (size_t)std::floor((n_bits - 1) * log_2 - 1e-9L) + 1;
+    size_t high = (size_t)std::floor(n_bits * log_2 + 1e-9L) + 1;
+    size_t digits = low;
+    if (low == high)
+    {
+        return sign + digits;
+    }
+    // Raise the radix to the power low from the top bit of the exponent down, in scratch memory, so that
+    // sizing a buffer for to_chars does not allocate. Every power up to base^low is at most the
+    // magnitude, and a square needs twice the length of its root.
+    ScratchFrame frame;
+    size_t capacity = 2 * this->limbs.size() + 2;
+    limb_t *power = frame.limbs(capacity);
+    limb_t *square = frame.limbs(capacity);
+    power[0] = 1;
+    size_t power_len = 1;
+    for (size_t bit = std::bit_width(low); bit-- > 0;)
+    {
+        sqr_limbs(square, power, power_len);
+        std::swap(power, square);
+        power_len *= 2;
+        while (power[power_len - 1] == 0)
+        {
+            power_len--;
+        }
+        if ((low >> bit) & 1)
+        {
+            power[power_len] = mul_1_limbs(power, power, power_len, (limb_t)a_base);
+            power_len += (power[power_len] != 0) ? 1 : 0;
+        }
+    }
+    // The magnitude has more than `digits` digits while it is at least base^digits.
+    while (digits < high && cmp_limbs(this->limbs.data(), this->limbs.size(), power, power_len) >= 0)
+    {
+        power[power_len] = mul_1_limbs(power, power, power_len, (limb_t)a_base);
+        power_len += (power[power_len] != 0) ? 1 : 0;
+        digits++;
+    }
+    return sign + digits;
+}
+
+/**
+ * @brief Return a binary string representation of this integer.
+ *
+ * @return A binary string representation of this integer.
+ */
+string Int::to_str_bools() const
+{
+    string result(this->digits_needed(2), '\0');
+    to_chars(result.data(), result.data() + result.size(), *this, 2);
+    return result;
+}
+
+#if defined(__cpp_lib_format)
+/**
+ * @brief Formatting of Int with std::format, with the standard format spec of integers:
+ *      [[fill]align][sign]['#']['0'][width][type]. The type is 'd' (the default), 'b', 'B', 'o', 'x' or
+ *      'X', '#' adds the prefix of the radix, and the width is a fixed number; the locale option and
+ *      nested width arguments are not supported.
+ */
+template <>
+struct std::formatter<Int>
+{
+    int base = 10;
+    bool upper = false;
+    char sign = '-';
+    bool alternate = false;
+    bool zero_pad = false;
+    char align = '\0';
+    // The fill character, which may take up to four bytes of UTF-8.
+    char fill[4] = {' '};
+    size_t fill_len = 1;
+    size_t width = 0;
+
+    constexpr auto parse(std::format_parse_context &a_ctx)
+    {
+        auto pos = a_ctx.begin();
+        auto end = a_ctx.end();
+        auto is_align = [](char a_chr) { return a_chr == '<' || a_chr == '>' || a_chr == '^'; };
+        if (pos != end && *pos != '}')
+        {
+            unsigned char lead = (unsigned char)*pos;
+            size_t len = (lead < 0x80) ? 1 : (lead >= 0xf0) ? 4 : (lead >= 0xe0) ? 3 : 2;
+            if ((size_t)(end - pos) > len && is_align(pos[len]))
+            {
+                if (*pos == '{')
+                {
+                    throw std::format_error("Invalid fill character for Int");
+                }
+                std::copy(pos, pos + len, fill);
+                fill_len = len;
+                align = pos[len];
+                pos += len + 1;
+            }
+            else if (is_align(*pos))
+            {
+                align = *pos++;
+            }
+        }
+        if (pos != end && (*pos == '+' || *pos == '-' || *pos == ' '))
+        {
+            sign = *pos++;
+        }
+        if (pos != end && *pos == '#')
+        {
+            alternate = true;
+            pos++;
+        }
+        if (pos != end && *pos == '0')
+        {
+            zero_pad = true;
+            pos++;
+        }
+        while (pos != end && *pos >= '0' && *pos <= '9')
+        {
+            width = width * 10 + (size_t)(*pos++ - '0');
+        }
+        if (pos != end && *pos != '}')
+        {
+            switch (*pos)
+            {
+            case 'd':
+                base = 10;
+                break;
+            case 'B':
+                upper = true;
+                [[fallthrough]];
+            case 'b':
+                base = 2;
+                break;
+            case 'o':
+                base = 8;
+                break;
+            case 'X':
+                upper = true;
+                [[fallthrough]];
+            case 'x':
+                base = 16;
+                break;
+            default:
+                throw std::format_error("Invalid format spec for Int");
+            }
+            pos++;
+        }
+        if (pos != end && *pos != '}')
+        {
+            throw std::format_error("Invalid format spec for Int");
+        }
+        return pos;
+    }
+
+    template <typename FormatContext>
+    auto format(const Int &a_value, FormatContext &a_ctx) const
+    {
+        // The digits are converted once, into a per-thread buffer of exactly digits_needed characters.
+        // A buffer grown past DECIMAL_SINK_BYTES is freed afterwards, so that one huge value does not
+        // hold its digits in memory for the life of the thread.
+        static thread_local string buffer;
+        size_t len = a_value.digits_needed(base);
+        if (buffer.size() < len)
+        {
+            buffer.resize(len);
+        }
+        to_chars(buffer.data(), buffer.data() + len, a_value, base);
+        std::string_view digits(buffer.data(), len);
+        char sign_chr = (sign == '-') ? '\0' : sign;
+        if (digits.front() == '-')
+        {
+            sign_chr = '-';
+            digits.remove_prefix(1);
+        }
+        if (upper)
+        {
+            for (size_t i = 0; i < len; i++)
+            {
+                buffer[i] = (buffer[i] >= 'a' && buffer[i] <= 'z') ? (char)(buffer[i] - 'a' + 'A') : buffer[i];
+            }
+        }
+        std::string_view prefix;
+        if (alternate)
+        {
+            prefix = (base == 2) ? (upper ? "0B" : "0b") : (base == 16) ? (upper ? "0X" : "0x") : "";
+            prefix = (base == 8 && digits != "0") ? "0" : prefix;
+        }
+
+        // Without an alignment, '0' pads with zeros between the prefix and the digits; otherwise the fill
+        // goes on the side the alignment leaves free, and integers align right by default.
+        size_t size = (sign_chr != '\0' ? 1 : 0) + prefix.size() + digits.size();
+        size_t pad = (width > size) ? width - size : 0;
+        size_t zeros = (align == '\0' && zero_pad) ? pad : 0;
+        size_t before = (zeros != 0) ? 0 : (align == '<') ? 0 : (align == '^') ? pad / 2 : pad;
+        size_t after = pad - zeros - before;
+        auto out = a_ctx.out();
+        for (size_t i = 0; i < before; i++)
+        {
+            out = std::copy(fill, fill + fill_len, out);
+        }
+        if (sign_chr != '\0')
+        {
+            *out++ = sign_chr;
+        }
+        out = std::copy(prefix.begin(), prefix.end(), out);
+        out = std::fill_n(out, zeros, '0');
+        out = std::copy(digits.begin(), digits.end(), out);
+        for (size_t i = 0; i < after; i++)
+        {
+            out = std::copy(fill, fill + fill_len, out);
+        }
+        if (len > DECIMAL_SINK_BYTES)
+        {
+            string().swap(buffer);
+        }
+        return out;
+    }
+};
+#endif
+
+/**
+ * @brief Copy assignment. Reuses the capacity of this instance's limbs.
+ */
+Int &Int::operator=(const Int &a_opr_2)
+{
+    this->is_positive = a_opr_2.is_positive;
+    this->limbs = a_opr_2.limbs;
+    return *this;
+};
+
+/**
+ * @brief Move assignment. Takes over the limbs of the other instance if they come from the same memory
+ *      resource, and copies them otherwise. Either way the other instance is left as zero.
+ */
+Int &Int::operator=(Int &&a_opr_2)
+{
+    if (this != &a_opr_2)
+    {
+        this->is_positive = a_opr_2.is_positive;
+        this->limbs = std::move(a_opr_2.limbs);
+        a_opr_2.is_positive = true;
+    }
+    return *this;
+};
+
+/**
+ * @brief Private method. Set a_r to a_opr_1 + a_opr_2, or a_opr_1 - a_opr_2 if a_negate_2 is set.
+ *      The output may be either operand, in which case its limbs are updated in place.
+ *
+ * @param a_r The integer that accepts the result
+ * @param a_opr_1 The first operand
+ * @param a_opr_2 The second operand
+ * @param a_negate_2 If the second operand should be subtracted
+ */
+void Int::add_signed(Int &a_r, const Int &a_opr_1, const Int &a_opr_2, bool a_negate_2)
+{
+    BIGINT_PROBE(a_negate_2 ? InstrumentOp::Sub : InstrumentOp::Add, std::max(a_opr_1.limbs.size(), a_opr_2.limbs.size()));
+    bool sign_1 = a_opr_1.is_positive;
+    bool sign_2 = (a_opr_2.is_positive != a_negate_2);
+    if (sign_1 != sign_2)
+    {
+        bool opr_2_is_bigger = sub_magnitudes(a_r.limbs, a_opr_1.limbs, a_opr_2.limbs);
+        a_r.is_positive = (opr_2_is_bigger) ? sign_2 : sign_1;
+    }
+    else
+    {
+        add_magnitudes(a_r.limbs, a_opr_1.limbs, a_opr_2.limbs);
+        a_r.is_positive = sign_1;
+    }
+    a_r.is_positive = a_r.is_positive || a_r.limbs.empty();
+}
+
+Int Int::operator+(const Int &a_that) const
+{
+    Int result;
+    add_signed(result, *this, a_that, false);
+    return result;
+}
+
+Int &Int::operator+=(const Int &a_that)
+{
+    add_signed(*this, *this, a_that, false);
+    return *this;
+}
+
+Int Int::operator-(const Int &a_that) const
+{
+    Int result;
+    add_signed(result, *this, a_that, true);
+    return result;
+}
+
+Int &Int::operator-=(const Int &a_that)
+{
+    add_signed(*this, *this, a_that, true);
+    return *this;
+}
+
+Int Int::operator*(const Int &a_that) const
+{
+    Int result;
+    mul_magnitudes(result.limbs, this->limbs, a_that.limbs);
+    result.is_positive = (this->is_positive == a_that.is_positive) || result.limbs.empty();
+    return result;
+}
+
+Int &Int::operator*=(const Int &a_that)
+{
+    bool result_is_positive = (this->is_positive == a_that.is_positive);
+    mul_magnitudes(this->limbs, this->limbs, a_that.limbs);
+    this->is_positive = result_is_positive || this->limbs.empty();
+    return *this;
+}
+
+Int Int::operator/(const Int &a_that) const
+{
+    Int result;
+    LimbVector rem;
+    divmod_magnitudes(result.limbs, rem, this->limbs, a_that.limbs);
+    result.is_positive = (this->is_positive == a_that.is_positive) || result.limbs.empty();
+    return result;
+}
+
+Int &Int::operator/=(const Int &a_that)
+{
+    static thread_local LimbVector rem(std::pmr::new_delete_resource());
+    bool result_is_positive = (this->is_positive == a_that.is_positive);
+    divmod_magnitudes(this->limbs, rem, this->limbs, a_that.limbs);
+    this->is_positive = result_is_positive || this->limbs.empty();
+    return *this;
+}
+
+/**
+ * @brief Remainder of truncated division. The result has the sign of the dividend, as with built-in integers.
+ *
+ * @param a_that The divisor
+ * @return The remainder
+ * @throw domain_error if the divisor is zero
+ */
+Int Int::operator%(const Int &a_that) const
+{
+    Int result;
+    LimbVector quot;
+    divmod_magnitudes(quot, result.limbs, this->limbs, a_that.limbs);
+    result.is_positive = this->is_positive || result.limbs.empty();
+    return result;
+}
+
+Int &Int::operator%=(const Int &a_that)
+{
+    static thread_local LimbVector quot(std::pmr::new_delete_resource());
+    divmod_magnitudes(quot, this->limbs, this->limbs, a_that.limbs);
+    this->is_positive = this->is_positive || this->limbs.empty();
+    return *this;
+}
+
+/**
+ * @brief Bitwise complement in two's complement, that is -x - 1.
+ *
+ * @return The complement
+ */
+Int Int::operator~() const
+{
+    Int result(*this);
+    if (result.is_positive)
+    {
+        increment_magnitude(result.limbs);
+        result.is_positive = false;
+    }
+    else
+    {
+        decrement_magnitude(result.limbs);
+        result.is_positive = true;
+    }
+    return result;
+}
+
+/**
+ * @brief Bitwise and, as if both integers were in two's complement with infinitely many sign bits.
+ */
+Int Int::operator&(const Int &a_that) const
+{
+    Int result;
+    result.is_positive = bitwise_magnitudes(result.limbs, this->is_positive, this->limbs,
+                                            a_that.is_positive, a_that.limbs, BitwiseOp::And);
+    return result;
+}
+
+Int &Int::operator&=(const Int &a_that)
+{
+    this->is_positive = bitwise_magnitudes(this->limbs, this->is_positive, this->limbs,
+                                           a_that.is_positive, a_that.limbs, BitwiseOp::And);
+    return *this;
+}
+
+/**
+ * @brief Bitwise or, as if both integers were in two's complement with infinitely many sign bits.
+ */
+Int Int::operator|(const Int &a_that) const
+{
+    Int result;
+    result.is_positive = bitwise_magnitudes(result.limbs, this->is_positive, this->limbs,
+                                            a_that.is_positive, a_that.limbs, BitwiseOp::Or);
+    return result;
+}
+
+Int &Int::operator|=(const Int &a_that)
+{
+    this->is_positive = bitwise_magnitudes(this->limbs, this->is_positive, this->limbs,
+                                           a_that.is_positive, a_that.limbs, BitwiseOp::Or);
+    return *this;
+}
+
+/**
+ * @brief Bitwise exclusive or, as if both integers were in two's complement with infinitely many sign bits.
+ */
+Int Int::operator^(const Int &a_that) const
+{
+    Int result;
+    result.is_positive = bitwise_magnitudes(result.limbs, this->is_positive, this->limbs,
+                                            a_that.is_positive, a_that.limbs, BitwiseOp::Xor);
+    return result;
+}
+
+Int &Int::operator^=(const Int &a_that)
+{
+    this->is_positive = bitwise_magnitudes(this->limbs, this->is_positive, this->limbs,
+                                           a_that.is_positive, a_that.limbs, BitwiseOp::Xor);
+    return *this;
+}
+
+/**
+ * @brief Multiply by 2^a_bits.
+ *
+ * @param a_bits The number of bits to shift by
+ * @return The shifted integer
+ */
+Int Int::operator<<(size_t a_bits) const
+{
+    Int result;
+    shift_left_magnitude(result.limbs, this->limbs, a_bits);
+    result.is_positive = this->is_positive;
+    return result;
+}
+
+Int &Int::operator<<=(size_t a_bits)
+{
+    shift_left_magnitude(this->limbs, this->limbs, a_bits);
+    return *this;
+}
+
+/**
+ * @brief Arithmetic shift right: divide by 2^a_bits rounding toward negative infinity, as a two's
+ *      complement shift does, so that -1 >> n is -1.
+ *
+ * @param a_bits The number of bits to shift by
+ * @return The shifted integer
+ */
+Int Int::operator>>(size_t a_bits) const
+{
+    Int result;
+    bool lost = shift_right_magnitude(result.limbs, this->limbs, a_bits);
+    if (!this->is_positive && lost)
+    {
+        increment_magnitude(result.limbs);
+    }
+    result.is_positive = this->is_positive || result.limbs.empty();
+    return result;
+}
+
+Int &Int::operator>>=(size_t a_bits)
+{
+    bool lost = shift_right_magnitude(this->limbs, this->limbs, a_bits);
+    if (!this->is_positive && lost)
+    {
+        increment_magnitude(this->limbs);
+    }
+    this->is_positive = this->is_positive || this->limbs.empty();
+    return *this;
+}
+
+/**
+ * @brief Return a bit of this integer in two's complement, where a negative one has infinitely many set bits
+ *      above its magnitude.
+ *
+ * @param a_bit The index of the bit, from the least significant
+ * @return The bit
+ */
+bool Int::test_bit(size_t a_bit) const
+{
+    size_t limb = a_bit / LIMB_BITS;
+    if (limb >= this->limbs.size())
+    {
+        return !this->is_positive;
+    }
+    limb_t word = this->limbs[limb];
+    if (!this->is_positive)
+    {
+        // -m is ~(m - 1), and the borrow of m - 1 stops at the lowest nonzero limb.
+        bool borrow = std::all_of(this->limbs.begin(), this->limbs.begin() + limb, [](limb_t a_limb) { return a_limb == 0; });
+        word = ~(word - borrow);
+    }
+    return (word >> (a_bit % LIMB_BITS)) & 1;
+}
+
+/**
+ * @brief Return the number of bits in the magnitude, 0 for zero.
+ *
+ * @return The position of the highest set bit of |x|, plus one
+ */
+size_t Int::bit_length() const
+{
+    if (this->limbs.empty()) return 0;
+    return (this->limbs.size() - 1) * LIMB_BITS + (size_t)std::bit_width(this->limbs.back());
+}
+
+/**
+ * @brief Return the number of set bits in the magnitude. A negative integer has infinitely many in two's
+ *      complement, so it is counted by its absolute value.
+ *
+ * @return The number of set bits of |x|
+ */
+size_t Int::popcount() const
+{
+    size_t count = 0;
+    for (limb_t limb : this->limbs)
+    {
+        count += (size_t)std::popcount(limb);
+    }
+    return count;
+}
+
+/**
+ * @brief Return the number of trailing zero bits, which x and -x share.
+ *
+ * @return The position of the lowest set bit
+ * @throw domain_error if this integer is zero
+ */
+size_t Int::ctz() const
+{
+    if (this->limbs.empty())
+    {
+        throw domain_error("Trailing zeros of zero are undefined");
+    }
+    size_t limb = 0;
+    while (this->limbs[limb] == 0)
+    {
+        limb++;
+    }
+    return limb * LIMB_BITS + (size_t)std::countr_zero(this->limbs[limb]);
+}
+
+/**
+ * @brief Compare two integers. Magnitudes are trimmed, so those of different lengths are ordered by
+ *      length alone, and others are compared a word at a time from the top. Nothing is copied.
+ *
+ * @param a_that The integer to compare with
+ * @return The ordering of this integer relative to a_that
+ */
+strong_ordering Int::compare(const Int &a_that) const
+{
+    // Zero is taken by its magnitude, so that a negative zero written through is_positive still equals it.
+    int sign_1 = this->limbs.empty() ? 0 : (this->is_positive ? 1 : -1);
+    int sign_2 = a_that.limbs.empty() ? 0 : (a_that.is_positive ? 1 : -1);
+    if (sign_1 != sign_2 || sign_1 == 0)
+    {
+        return sign_1 <=> sign_2;
+    }
+    int cmp = cmp_limbs(this->limbs.data(), this->limbs.size(), a_that.limbs.data(), a_that.limbs.size());
+    return (sign_1 > 0) ? (cmp <=> 0) : (0 <=> cmp);
+}
+
+bool Int::operator==(const Int &a_that) const
+{
+    if (this->limbs.size() != a_that.limbs.size()) return false;
+    if (this->limbs.empty()) return true;
+    return this->is_positive == a_that.is_positive && this->limbs == a_that.limbs;
+}
+
+bool Int::operator!=(const Int &a_that) const
+{
+    return !(*this == a_that);
+}
+
+bool Int::operator>(const Int &a_that) const
+{
+    return this->compare(a_that) > 0;
+}
+
+bool Int::operator<(const Int &a_that) const
+{
+    return this->compare(a_that) < 0;
+}
+
+bool Int::operator>=(const Int &a_that) const
+{
+    return this->compare(a_that) >= 0;
+}
+
+bool Int::operator<=(const Int &a_that) const
+{
+    return this->compare(a_that) <= 0;
+}
+
+Int Int::operator-() const &
+{
+    Int result = Int(*this);
+    result.is_positive = !result.is_positive || result.limbs.empty();
+    return result;
+};
+
+Int Int::operator-() &&
+{
+    this->is_positive = !this->is_positive || this->limbs.empty();
+    return std::move(*this);
+};
+
+/**
+ * @brief Add to a temporary, reusing its limbs for the result.
+ */
+Int operator+(Int &&a_opr_1, const Int &a_opr_2)
+{
+    a_opr_1 += a_opr_2;
+    return std::move(a_opr_1);
+}
+
+/**
+ * @brief Add a temporary, reusing its limbs for the result.
+ */
+Int operator+(const Int &a_opr_1, Int &&a_opr_2)
+{
+    a_opr_2 += a_opr_1;
+    return std::move(a_opr_2);
+}
+
+Int operator+(Int &&a_opr_1, Int &&a_opr_2)
+{
+    a_opr_1 += a_opr_2;
+    return std::move(a_opr_1);
+}
+
+/**
+ * @brief Subtract from a temporary, reusing its limbs for the result.
+ */
+Int operator-(Int &&a_opr_1, const Int &a_opr_2)
+{
+    a_opr_1 -= a_opr_2;
+    return std::move(a_opr_1);
+}
+
+/**
+ * @brief Subtract a temporary, reusing its limbs for the result.
+ */
+Int operator-(const Int &a_opr_1, Int &&a_opr_2)
+{
+    a_opr_2 -= a_opr_1;
+    return -std::move(a_opr_2);
+}
+
+Int operator-(Int &&a_opr_1, Int &&a_opr_2)
+{
+    a_opr_1 -= a_opr_2;
+    return std::move(a_opr_1);
+}
+
+/**
+ * @brief Constructor from a built-in integer, which needs no more than two limbs and so stays inside the
+ *      object.
+ *
+ * @param a_value the value
+ */
+template <BuiltinInteger T>
+Int::Int(T a_value)
+{
+    this->assign_builtin(!builtin_is_negative(a_value), builtin_magnitude(a_value));
+}
+
+/**
+ * @brief Private method. Set this integer to a sign and a magnitude of up to two limbs.
+ *
+ * @param a_is_positive the sign
+ * @param a_mag the magnitude
+ */
+void Int::assign_builtin(bool a_is_positive, dlimb_t a_mag)
+{
+    this->limbs.clear();
+    if (a_mag != 0)
+    {
+        this->limbs.push_back((limb_t)a_mag);
+    }
+    if ((a_mag >> LIMB_BITS) != 0)
+    {
+        this->limbs.push_back((limb_t)(a_mag >> LIMB_BITS));
+    }
+    this->is_positive = a_is_positive || this->limbs.empty();
+}
+
+/**
+ * @brief Private method. Add a sign and a magnitude of up to two limbs to this integer in place, with
+ *      the carry or borrow running only as far as it needs to.
+ *
+ * @param a_is_positive the sign of the value to add
+ * @param a_mag the magnitude of the value to add
+ */
+void Int::add_builtin(bool a_is_positive, dlimb_t a_mag)
+{
+    limb_t mag[2] = {(limb_t)a_mag, (limb_t)(a_mag >> LIMB_BITS)};
+    size_t mag_len = (mag[1] != 0) ? 2 : (mag[0] != 0) ? 1 : 0;
+    size_t len = this->limbs.size();
+    if (mag_len == 0)
+    {
+        return;
+    }
+    if (len == 0 || this->is_positive == a_is_positive)
+    {
+        limb_t carry;
+        if (len >= mag_len)
+        {
+            carry = add_limbs(this->limbs.data(), this->limbs.data(), len, mag, mag_len);
+        }
+        else
+        {
+            this->limbs.resize(mag_len);
+            carry = add_limbs(this->limbs.data(), mag, mag_len, this->limbs.data(), len);
+        }
+        if (carry != 0)
+        {
+            this->limbs.push_back(carry);
+        }
+        this->is_positive = a_is_positive;
+        return;
+    }
+    if (cmp_limbs(this->limbs.data(), len, mag, mag_len) >= 0)
+    {
+        sub_limbs(this->limbs.data(), this->limbs.data(), len, mag, mag_len);
+        trim_limb_vector(this->limbs);
+        this->is_positive = this->is_positive || this->limbs.empty();
+        return;
+    }
+    // The value is larger, so this integer has at most as many limbs, and the sign flips.
+    this->limbs.resize(mag_len);
+    sub_limbs(this->limbs.data(), mag, mag_len, this->limbs.data(), len);
+    trim_limb_vector(this->limbs);
+    this->is_positive = a_is_positive;
+}
+
+/**
+ * @brief Private method. Multiply this integer in place by a sign and a magnitude of up to two limbs.
+ *      A single-limb factor takes one pass of mul_1_limbs.
+ *
+ * @param a_is_positive the sign of the factor
+ * @param a_mag the magnitude of the factor
+ */
+void Int::mul_builtin(bool a_is_positive, dlimb_t a_mag)
+{
+    if (a_mag == 0 || this->limbs.empty())
+    {
+        this->limbs.clear();
+        this->is_positive = true;
+        return;
+    }
+    if ((a_mag >> LIMB_BITS) == 0)
+    {
+        limb_t carry = mul_1_limbs(this->limbs.data(), this->limbs.data(), this->limbs.size(), (limb_t)a_mag);
+        if (carry != 0)
+        {
+            this->limbs.push_back(carry);
+        }
+    }
+    else
+    {
+        LimbVector mer;
+        mer.push_back((limb_t)a_mag);
+        mer.push_back((limb_t)(a_mag >> LIMB_BITS));
+        mul_magnitudes(this->limbs, this->limbs, mer);
+    }
+    this->is_positive = (this->is_positive == a_is_positive);
+}
+
+/**
+ * @brief Private method. Divide this integer in place by a sign and a magnitude of up to two limbs,
+ *      truncating toward zero. A single-limb divisor is divided by its precomputed reciprocal.
+ *
+ * @param a_is_positive the sign of the divisor
+ * @param a_mag the magnitude of the divisor
+ * @throw domain_error if the divisor is zero
+ */
+void Int::div_builtin(bool a_is_positive, dlimb_t a_mag)
+{
+    if (a_mag == 0)
+    {
+        throw domain_error("Cannot divide by zero");
+    }
+    if ((a_mag >> LIMB_BITS) != 0)
+    {
+        Int dvs;
+        dvs.assign_builtin(a_is_positive, a_mag);
+        *this /= dvs;
+        return;
+    }
+    div_1_limbs(this->limbs.data(), this->limbs.data(), this->limbs.size(), LimbDivisor((limb_t)a_mag));
+    trim_limb_vector(this->limbs);
+    this->is_positive = (this->is_positive == a_is_positive) || this->limbs.empty();
+}
+
+/**
+ * @brief Private method. Return the remainder of this integer divided by a magnitude of up to two limbs,
+ *      truncating toward zero, so that it takes the sign of this integer. The sign of the divisor does not
+ *      matter.
+ *
+ * @param a_mag the magnitude of the divisor
+ * @return The remainder
+ * @throw domain_error if the divisor is zero
+ */
+Int Int::rem_builtin(dlimb_t a_mag) const
+{
+    if (a_mag == 0)
+    {
+        throw domain_error("Cannot divide by zero");
+    }
+    Int result;
+    if ((a_mag >> LIMB_BITS) != 0)
+    {
+        Int dvs;
+        dvs.assign_builtin(true, a_mag);
+        return *this % dvs;
+    }
+    limb_t rem = mod_1_limbs(this->limbs.data(), this->limbs.size(), LimbDivisor((limb_t)a_mag));
+    result.assign_builtin(this->is_positive, rem);
+    return result;
+}
+
+/**
+ * @brief Private method. Compare this integer with a sign and a magnitude of up to two limbs.
+ *
+ * @param a_is_positive the sign of the value
+ * @param a_mag the magnitude of the value
+ * @return The ordering of this integer relative to the value
+ */
+strong_ordering Int::compare_builtin(bool a_is_positive, dlimb_t a_mag) const
+{
+    int sign_1 = this->limbs.empty() ? 0 : (this->is_positive ? 1 : -1);
+    int sign_2 = (a_mag == 0) ? 0 : (a_is_positive ? 1 : -1);
+    if (sign_1 != sign_2 || sign_1 == 0)
+    {
+        return sign_1 <=> sign_2;
+    }
+    if (this->limbs.size() > 2)
+    {
+        return (sign_1 > 0) ? strong_ordering::greater : strong_ordering::less;
+    }
+    dlimb_t mag = this->low_magnitude();
+    return (sign_1 > 0) ? (mag <=> a_mag) : (a_mag <=> mag);
+}
+
+/**
+ * @brief Private method. Return the lowest two limbs of the magnitude as one number.
+ *
+ * @return The magnitude modulo 2^128
+ */
+dlimb_t Int::low_magnitude() const
+{
+    size_t len = this->limbs.size();
+    dlimb_t low = (len > 0) ? this->limbs[0] : 0;
+    return (len > 1) ? low | ((dlimb_t)this->limbs[1] << LIMB_BITS) : low;
+}
+
+template <BuiltinInteger T>
+Int Int::operator+(T a_that) const
+{
+    Int result(*this);
+    result += a_that;
+    return result;
+}
+
+template <BuiltinInteger T>
+Int &Int::operator+=(T a_that)
+{
+    this->add_builtin(!builtin_is_negative(a_that), builtin_magnitude(a_that));
+    return *this;
+}
+
+template <BuiltinInteger T>
+Int Int::operator-(T a_that) const
+{
+    Int result(*this);
+    result -= a_that;
+    return result;
+}
+
+template <BuiltinInteger T>
+Int &Int::operator-=(T a_that)
+{
+    this->add_builtin(builtin_is_negative(a_that), builtin_magnitude(a_that));
+    return *this;
+}
+
+template <BuiltinInteger T>
+Int Int::operator*(T a_that) const
+{
+    Int result(*this);
+    result *= a_that;
+    return result;
+}
+
+template <BuiltinInteger T>
+Int &Int::operator*=(T a_that)
+{
+    this->mul_builtin(!builtin_is_negative(a_that), builtin_magnitude(a_that));
+    return *this;
+}
+
+template <BuiltinInteger T>
+Int Int::operator/(T a_that) const
+{
+    Int result(*this);
+    result /= a_that;
+    return result;
+}
+
+template <BuiltinInteger T>
+Int &Int::operator/=(T a_that)
+{
+    this->div_builtin(!builtin_is_negative(a_that), builtin_magnitude(a_that));
+    return *this;
+}
+
+/**
+ * @brief Remainder of truncated division by a built-in integer, computed without copying the dividend.
+ */
+template <BuiltinInteger T>
+Int Int::operator%(T a_that) const
+{
+    return this->rem_builtin(builtin_magnitude(a_that));
+}
+
+template <BuiltinInteger T>
+Int &Int::operator%=(T a_that)
+{
+    *this = this->rem_builtin(builtin_magnitude(a_that));
+    return *this;
+}
+
+template <BuiltinInteger T>
+bool Int::operator==(T a_that) const
+{
+    return this->compare(a_that) == 0;
+}
+
+/**
+ * @brief Three-way comparison with a built-in integer. C++20 derives <, <=, >, >= and the forms with the
+ *      built-in integer on the left from this and operator==.
+ */
+template <BuiltinInteger T>
+strong_ordering Int::operator<=>(T a_that) const
+{
+    return this->compare(a_that);
+}
+
+template <BuiltinInteger T>
+strong_ordering Int::compare(T a_that) const
+{
+    return this->compare_builtin(!builtin_is_negative(a_that), builtin_magnitude(a_that));
+}
+
+/**
+ * @brief Check if this integer can be converted to a built-in integer type without loss.
+ *
+ * @tparam T The built-in integer type
+ * @return If the value lies in the range of T
+ */
+template <BuiltinInteger T>
+bool Int::fits_in() const
+{
+    if (this->limbs.size() > 2)
+    {
+        return false;
+    }
+    return this->low_magnitude() <= builtin_max_magnitude<T>(!this->is_positive);
+}
+
+/**
+ * @brief Convert to int64_t.
+ *
+ * @return The value
+ * @throw out_of_range if the value does not fit in int64_t
+ */
+int64_t Int::to_int64() const
+{
+    if (!this->fits_in<int64_t>())
+    {
+        throw out_of_range("Integer does not fit in int64_t: " + this->to_str());
+    }
+    limb_t mag = this->limbs.empty() ? 0 : this->limbs[0];
+    return (int64_t)(this->is_positive ? mag : (limb_t)0 - mag);
+}
+
+template <BuiltinInteger T>
+Int operator+(T a_opr_1, const Int &a_opr_2)
+{
+    return a_opr_2 + a_opr_1;
+}
+
+template <BuiltinInteger T>
+Int operator+(Int &&a_opr_1, T a_opr_2)
+{
+    a_opr_1 += a_opr_2;
+    return std::move(a_opr_1);
+}
+
+template <BuiltinInteger T>
+Int operator-(T a_opr_1, const Int &a_opr_2)
+{
+    return Int(a_opr_1) - a_opr_2;
+}
+
+template <BuiltinInteger T>
+Int operator-(Int &&a_opr_1, T a_opr_2)
+{
+    a_opr_1 -= a_opr_2;
+    return std::move(a_opr_1);
+}
+
+template <BuiltinInteger T>
+Int operator*(T a_opr_1, const Int &a_opr_2)
+{
+    return a_opr_2 * a_opr_1;
+}
+
+template <BuiltinInteger T>
+Int operator*(Int &&a_opr_1, T a_opr_2)
+{
+    a_opr_1 *= a_opr_2;
+    return std::move(a_opr_1);
+}
+
+template <BuiltinInteger T>
+Int operator/(T a_opr_1, const Int &a_opr_2)
+{
+    return Int(a_opr_1) / a_opr_2;
+}
+
+template <BuiltinInteger T>
+Int operator/(Int &&a_opr_1, T a_opr_2)
+{
+    a_opr_1 /= a_opr_2;
+    return std::move(a_opr_1);
+}
+
+template <BuiltinInteger T>
+Int operator%(T a_opr_1, const Int &a_opr_2)
+{
+    return Int(a_opr_1) % a_opr_2;
+}
+
+/**
+ * @brief Add a signed magnitude to an integer in place.
+ *
+ * @param a_r The integer that accumulates the value
+ * @param a_is_positive The sign of the value
+ * @param a_mag The magnitude of the value, trimmed, which must not be a_r's limbs unless signs agree
+ */
+void add_signed_magnitude(Int &a_r, bool a_is_positive, const LimbVector &a_mag)
+{
+    if (a_r.is_positive == a_is_positive || a_r.limbs.empty())
+    {
+        add_magnitudes(a_r.limbs, a_r.limbs, a_mag);
+        a_r.is_positive = a_is_positive;
+    }
+    else if (sub_magnitudes(a_r.limbs, a_r.limbs, a_mag))
+    {
+        a_r.is_positive = a_is_positive;
+    }
+    a_r.is_positive = a_r.is_positive || a_r.limbs.empty();
+}
+
+/**
+ * @brief Add a signed product to an integer in place. Products with the sign of the output are
+ *      accumulated without a temporary; the others go through a per-thread scratch buffer.
+ *
+ * @param a_r The integer that accumulates the product, which must not be either operand
+ * @param a_is_positive The sign of the product
+ * @param a_mnd The magnitude of the number to be multiplied
+ * @param a_mer The magnitude of the multiplier
+ */
+void addmul_signed_magnitudes(Int &a_r, bool a_is_positive, const LimbVector &a_mnd, const LimbVector &a_mer)
+{
+    if (a_r.is_positive == a_is_positive || a_r.limbs.empty())
+    {
+        addmul_magnitudes(a_r.limbs, a_mnd, a_mer);
+        a_r.is_positive = a_is_positive || a_r.limbs.empty();
+        return;
+    }
+    static thread_local LimbVector product(std::pmr::new_delete_resource());
+    mul_magnitudes(product, a_mnd, a_mer);
+    add_signed_magnitude(a_r, a_is_positive, product);
+}
+
+/**
+ * @brief Base of the lazy expression nodes. Expressions are built with lazy() and the operators
+ *      below, and are only evaluated when assigned to, added to or used to construct an Int, at
+ *      which point every term is accumulated straight into the destination. A node refers to its
+ *      operands, so it must not outlive the integers it was built from.
+ *
+ *      Each node provides refers_to(), which tells if an integer is one of its operands, and
+ *      accumulate(), which adds the node's value, or subtracts it, to an integer that is not.
+ */
+template <typename Expr>
+struct IntExpr
+{
+    const Expr &self() const { return static_cast<const Expr &>(*this); }
+};
+
+/**
+ * @brief A leaf of a lazy expression, referring to an existing integer.
+ */
+struct LazyInt : IntExpr<LazyInt>
+{
+    explicit LazyInt(const Int &a_value) : value(a_value) {}
+
+    const Int &value;
+
+    bool refers_to(const Int *a_int) const { return &this->value == a_int; }
+    void accumulate(Int &a_r, bool a_negate) const
+    {
+        add_signed_magnitude(a_r, this->value.is_positive != a_negate, this->value.limbs);
+    }
+};
+
+/**
+ * @brief The sum of two lazy expressions, or their difference if Negate2 is set.
+ */
+template <typename Expr1, typename Expr2, bool Negate2>
+struct LazySum : IntExpr<LazySum<Expr1, Expr2, Negate2>>
+{
+    LazySum(const Expr1 &a_opr_1, const Expr2 &a_opr_2) : opr_1(a_opr_1), opr_2(a_opr_2) {}
+
+    Expr1 opr_1;
+    Expr2 opr_2;
+
+    bool refers_to(const Int *a_int) const { return this->opr_1.refers_to(a_int) || this->opr_2.refers_to(a_int); }
+    void accumulate(Int &a_r, bool a_negate) const
+    {
+        this->opr_1.accumulate(a_r, a_negate);
+        this->opr_2.accumulate(a_r, a_negate != Negate2);
+    }
+};
+
+/**
+ * @brief The negation of a lazy expression.
+ */
+template <typename Expr>
+struct LazyNegation : IntExpr<LazyNegation<Expr>>
+{
+    explicit LazyNegation(const Expr &a_opr) : opr(a_opr) {}
+
+    Expr opr;
+
+    bool refers_to(const Int *a_int) const { return this->opr.refers_to(a_int); }
+    void accumulate(Int &a_r, bool a_negate) const { this->opr.accumulate(a_r, !a_negate); }
+};
+
+/**
+ * @brief Return the integer a leaf refers to, without a copy.
+ */
+const Int &lazy_operand(const LazyInt &a_expr)
+{
+    return a_expr.value;
+}
+
+/**
+ * @brief Evaluate a compound operand of a lazy product into a temporary.
+ */
+template <typename Expr>
+Int lazy_operand(const IntExpr<Expr> &a_expr)
+{
+    return Int(a_expr);
+}
+
+/**
+ * @brief The product of two lazy expressions, which is accumulated into the destination as a
+ *      multiply-accumulate. Operands that are not leaves are evaluated into temporaries first.
+ */
+template <typename Expr1, typename Expr2>
+struct LazyProduct : IntExpr<LazyProduct<Expr1, Expr2>>
+{
+    LazyProduct(const Expr1 &a_mnd, const Expr2 &a_mer) : mnd(a_mnd), mer(a_mer) {}
+
+    Expr1 mnd;
+    Expr2 mer;
+
+    bool refers_to(const Int *a_int) const { return this->mnd.refers_to(a_int) || this->mer.refers_to(a_int); }
+    void accumulate(Int &a_r, bool a_negate) const
+    {
+        const Int &mnd_int = lazy_operand(this->mnd);
+        const Int &mer_int = lazy_operand(this->mer);
+        addmul_signed_magnitudes(a_r, (mnd_int.is_positive == mer_int.is_positive) != a_negate, mnd_int.limbs,
+                                 mer_int.limbs);
+    }
+};
+
+/**
+ * @brief Start a lazy expression. For example, r = lazy(a) * b + lazy(c) * d - e evaluates into r
+ *      with two multiply-accumulates and a subtraction, and without a temporary Int.
+ *
+ * @param a_int The integer to refer to, which must outlive the expression
+ * @return A leaf referring to a_int
+ */
+LazyInt lazy(const Int &a_int)
+{
+    return LazyInt(a_int);
+}
+
+template <typename Expr1, typename Expr2>
+LazySum<Expr1, Expr2, false> operator+(const IntExpr<Expr1> &a_opr_1, const IntExpr<Expr2> &a_opr_2)
+{
+    return LazySum<Expr1, Expr2, false>(a_opr_1.self(), a_opr_2.self());
+}
+
+template <typename Expr1>
+LazySum<Expr1, LazyInt, false> operator+(const IntExpr<Expr1> &a_opr_1, const Int &a_opr_2)
+{
+    return LazySum<Expr1, LazyInt, false>(a_opr_1.self(), LazyInt(a_opr_2));
+}
+
+template <typename Expr2>
+LazySum<LazyInt, Expr2, false> operator+(const Int &a_opr_1, const IntExpr<Expr2> &a_opr_2)
+{
+    return LazySum<LazyInt, Expr2, false>(LazyInt(a_opr_1), a_opr_2.self());
+}
+
+template <typename Expr1, typename Expr2>
+LazySum<Expr1, Expr2, true> operator-(const IntExpr<Expr1> &a_opr_1, const IntExpr<Expr2> &a_opr_2)
+{
+    return LazySum<Expr1, Expr2, true>(a_opr_1.self(), a_opr_2.self());
+}
+
+template <typename Expr1>
+LazySum<Expr1, LazyInt, true> operator-(const IntExpr<Expr1> &a_opr_1, const Int &a_opr_2)
+{
+    return LazySum<Expr1, LazyInt, true>(a_opr_1.self(), LazyInt(a_opr_2));
+}
+
+template <typename Expr2>
+LazySum<LazyInt, Expr2, true> operator-(const Int &a_opr_1, const IntExpr<Expr2> &a_opr_2)
+{
+    return LazySum<LazyInt, Expr2, true>(LazyInt(a_opr_1), a_opr_2.self());
+}
+
+template <typename Expr>
+LazyNegation<Expr> operator-(const IntExpr<Expr> &a_opr)
+{
+    return LazyNegation<Expr>(a_opr.self());
+}
+
+template <typename Expr1, typename Expr2>
+LazyProduct<Expr1, Expr2> operator*(const IntExpr<Expr1> &a_mnd, const IntExpr<Expr2> &a_mer)
+{
+    return LazyProduct<Expr1, Expr2>(a_mnd.self(), a_mer.self());
+}
+
+template <typename Expr1>
+LazyProduct<Expr1, LazyInt> operator*(const IntExpr<Expr1> &a_mnd, const Int &a_mer)
+{
+    return LazyProduct<Expr1, LazyInt>(a_mnd.self(), LazyInt(a_mer));
+}
+
+template <typename Expr2>
+LazyProduct<LazyInt, Expr2> operator*(const Int &a_mnd, const IntExpr<Expr2> &a_mer)
+{
+    return LazyProduct<LazyInt, Expr2>(LazyInt(a_mnd), a_mer.self());
+}
+
+/**
+ * @brief Constructor from a lazy expression, which is evaluated straight into the new instance.
+ *
+ * @param a_expr The expression to evaluate
+ */
+template <typename Expr>
+Int::Int(const IntExpr<Expr> &a_expr)
+{
+    a_expr.self().accumulate(*this, false);
+}
+
+/**
+ * @brief Assign the value of a lazy expression. If this instance is an operand of the expression,
+ *      the value goes to a per-thread buffer first, which then trades limbs with this instance.
+ *
+ * @param a_expr The expression to evaluate
+ * @return This instance
+ */
+template <typename Expr>
+Int &Int::operator=(const IntExpr<Expr> &a_expr)
+{
+    if (a_expr.self().refers_to(this))
+    {
+        static thread_local Int result(std::pmr::new_delete_resource());
+        result.is_positive = true;
+        result.limbs.clear();
+        a_expr.self().accumulate(result, false);
+        this->is_positive = result.is_positive;
+        this->limbs.swap(result.limbs);
+        return *this;
+    }
+    this->is_positive = true;
+    this->limbs.clear();
+    a_expr.self().accumulate(*this, false);
+    return *this;
+}
+
+/**
+ * @brief Add the value of a lazy expression in place, so acc += lazy(a) * b is a fused
+ *      multiply-accumulate.
+ *
+ * @param a_expr The expression to evaluate
+ * @return This instance
+ */
+template <typename Expr>
+Int &Int::operator+=(const IntExpr<Expr> &a_expr)
+{
+    if (a_expr.self().refers_to(this))
+    {
+        static thread_local Int result(std::pmr::new_delete_resource());
+        result = a_expr;
+        return *this += result;
+    }
+    a_expr.self().accumulate(*this, false);
+    return *this;
+}
+
+/**
+ * @brief Subtract the value of a lazy expression in place.
+ *
+ * @param a_expr The expression to evaluate
+ * @return This instance
+ */
+template <typename Expr>
+Int &Int::operator-=(const IntExpr<Expr> &a_expr)
+{
+    if (a_expr.self().refers_to(this))
+    {
+        static thread_local Int result(std::pmr::new_delete_resource());
+        result = a_expr;
+        return *this -= result;
+    }
+    a_expr.self().accumulate(*this, true);
+    return *this;
+}
+
+/**
+ * @brief Multiply two integers with a given algorithm at the top level, for benchmarking.
+ *      Int::operator* chooses the algorithm by operand size instead.
+ *
+ * @param a_mnd The number to be multiplied
+ * @param a_mer The multiplier
+ * @param a_algorithm The algorithm to use
+ * @return The product
+ */
+Int mul(const Int &a_mnd, const Int &a_mer, MulAlgorithm a_algorithm)
+{
+    LimbVector result;
+    mul_magnitudes(result, a_mnd.limbs, a_mer.limbs, a_algorithm);
+    return Int::from_limbs(a_mnd.is_positive == a_mer.is_positive, std::move(result));
+}
+
+/**
+ * @brief How divmod() rounds a quotient that is not exact.
+ */
+enum class DivRounding
+{
+    // Round toward zero. The remainder has the sign of the dividend, as with operator/ and operator%.
+    Trunc,
+    // Round toward negative infinity. The remainder has the sign of the divisor.
+    Floor,
+};
+
+/**
+ * @brief Give the magnitudes of a quotient and a remainder their signs, and round the quotient.
+ *
+ * @param a_quot The magnitude of the quotient, truncated
+ * @param a_rem The magnitude of the remainder
+ * @param a_dvd The dividend
+ * @param a_dvs The divisor
+ * @param a_rounding The rounding of the quotient
+ * @return The quotient and the remainder
+ */
+std::pair<Int, Int> divmod_signs(LimbVector &a_quot, LimbVector &a_rem, const Int &a_dvd, const Int &a_dvs,
+                                 DivRounding a_rounding)
+{
+    bool signs_differ = (a_dvd.is_positive != a_dvs.is_positive);
+    bool rem_is_positive = a_dvd.is_positive;
+    if (a_rounding == DivRounding::Floor && signs_differ && !a_rem.empty())
+    {
+        // Step the quotient one further from zero, which moves the remainder to the divisor's side.
+        LimbVector one;
+        one.push_back(1);
+        add_magnitudes(a_quot, a_quot, one);
+        sub_magnitudes(a_rem, a_dvs.limbs, a_rem);
+        rem_is_positive = a_dvs.is_positive;
+    }
+    bool quot_is_positive = !signs_differ || a_quot.empty();
+    return {Int::from_limbs(quot_is_positive, std::move(a_quot)),
+            Int::from_limbs(rem_is_positive || a_rem.empty(), std::move(a_rem))};
+}
+
+/**
+ * @brief Divide two integers, returning the quotient and the remainder from a single division.
+ *      In either rounding mode, a_dvd == quotient * a_dvs + remainder and |remainder| < |a_dvs|.
+ *
+ * @param a_dvd The dividend
+ * @param a_dvs The divisor
+ * @param a_rounding The rounding of the quotient
+ * @return The quotient and the remainder
+ * @throw domain_error if the divisor is zero
+ */
+std::pair<Int, Int> divmod(const Int &a_dvd, const Int &a_dvs, DivRounding a_rounding = DivRounding::Trunc)
+{
+    LimbVector quot_limbs;
+    LimbVector rem_limbs;
+    divmod_magnitudes(quot_limbs, rem_limbs, a_dvd.limbs, a_dvs.limbs);
+    return divmod_signs(quot_limbs, rem_limbs, a_dvd, a_dvs, a_rounding);
+}
+
+/**
+ * @brief Return the absolute value of an integer.
+ *
+ * @param a_opr The integer
+ * @return |a_opr|
+ */
+Int abs(const Int &a_opr)
+{
+    Int result = a_opr;
+    result.is_positive = true;
+    return result;
+}
+
+/**
+ * @brief Square an integer. Int::operator* takes the same path when both operands are the same object.
+ *
+ * @param a_opr The integer
+ * @return a_opr * a_opr
+ */
+Int square(const Int &a_opr)
+{
+    LimbVector result;
+    mul_magnitudes(result, a_opr.limbs, a_opr.limbs);
+    return Int::from_limbs(true, std::move(result));
+}
+
+/**
+ * @brief Raise an integer to a power by repeated squaring.
+ *
+ * @param a_base The base
+ * @param a_exp The exponent
+ * @return a_base ^ a_exp, where 0 ^ 0 is 1
+ */
+Int pow(const Int &a_base, uint64_t a_exp)
+{
+    Int result = Int::from_limbs(true, vector<limb_t>{1});
+    for (size_t i = LIMB_BITS; i-- > 0;)
+    {
+        result *= result;
+        if ((a_exp >> i) & 1)
+        {
+            result *= a_base;
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Reduce the operands of a modular exponentiation.
+ *
+ * @param a_base The base
+ * @param a_exp The exponent
+ * @param a_mod The modulus
+ * @return The base reduced into [0, |a_mod|)
+ * @throw domain_error if the modulus is zero or the exponent is negative
+ */
+vector<limb_t> powmod_reduce_base(const Int &a_base, const Int &a_exp, const Int &a_mod)
+{
+    if (a_mod.limbs.empty())
+    {
+        throw domain_error("Cannot reduce modulo zero");
+    }
+    if (!a_exp.is_positive && !a_exp.limbs.empty())
+    {
+        throw domain_error("Negative exponent in modular exponentiation");
+    }
+    Int mod_abs = a_mod;
+    mod_abs.is_positive = true;
+    return divmod(a_base, mod_abs, DivRounding::Floor).second.limbs.to_vector();
+}
+
+/**
+ * @brief Raise an integer to a power modulo another. Odd moduli use Montgomery multiplication, even moduli
+ *      Barrett reduction, both with sliding-window exponentiation.
+ *
+ * @param a_base The base
+ * @param a_exp The exponent, not negative
+ * @param a_mod The modulus, not zero. Its sign is ignored.
+ * @return a_base ^ a_exp mod |a_mod|, in [0, |a_mod|)
+ * @throw domain_error if the modulus is zero or the exponent is negative
+ */
+Int powmod(const Int &a_base, const Int &a_exp, const Int &a_mod)
+{
+    vector<limb_t> base = powmod_reduce_base(a_base, a_exp, a_mod);
+    if (a_mod.limbs[0] & 1)
+    {
+        MontgomeryContext ctx(a_mod.limbs.to_vector());
+        vector<limb_t> result = pow_sliding_window(ctx, ctx.to_mont(base), a_exp.limbs.to_vector());
+        return Int::from_limbs(true, ctx.from_mont(result));
+    }
+    BarrettContext ctx(a_mod.limbs.to_vector());
+    return Int::from_limbs(true, pow_sliding_window(ctx, base, a_exp.limbs.to_vector()));
+}
+
+/**
+ * @brief Raise an integer to a secret power modulo an odd number, with a Montgomery ladder whose running
+ *      time depends only on the number of limbs of the exponent and the modulus, not on the exponent's bits.
+ *
+ * @param a_base The base
+ * @param a_exp The exponent, not negative
+ * @param a_mod The modulus, odd. Its sign is ignored.
+ * @return a_base ^ a_exp mod |a_mod|, in [0, |a_mod|)
+ * @throw domain_error if the modulus is even or the exponent is negative
+ */
+Int powmod_ct(const Int &a_base, const Int &a_exp, const Int &a_mod)
+{
+    if (a_mod.limbs.empty() || !(a_mod.limbs[0] & 1))
+    {
+        throw domain_error("Constant-time modular exponentiation needs an odd modulus");
+    }
+    vector<limb_t> base = powmod_reduce_base(a_base, a_exp, a_mod);
+    MontgomeryContext ctx(a_mod.limbs.to_vector());
+    vector<limb_t> result = pow_ladder(ctx, ctx.to_mont(base), a_exp.limbs.to_vector());
+    return Int::from_limbs(true, ctx.from_mont(result));
+}
+
+/**
+ * @brief Division by a fixed integer, with the work that depends only on the divisor done once, for
+ *      dividing many numbers by the same one. Divisors of one limb keep the reciprocal of that limb, so that
+ *      each step is two multiplications. Longer divisors keep their normalized form and the reciprocal of its
+ *      top limb for Knuth's Algorithm D, and from div_thresholds.barrett limbs up also the Barrett reciprocal
+ *      floor(2^(128n) / |divisor|), which turns each n-limb block of the quotient into two multiplications
+ *      at the speed of mul_limbs. The methods are const and keep their temporaries per thread, so one
+ *      Divider may be shared by several threads.
+ */
+class Divider
+{
+public:
+    explicit Divider(const Int &);
+
+    const Int &divisor() const { return this->dvs; }
+    std::pair<Int, Int> divmod(const Int &, DivRounding a_rounding = DivRounding::Trunc) const;
+    Int quotient(const Int &) const;
+    Int remainder(const Int &) const;
+    void divmod_magnitudes(LimbVector &, LimbVector &, const LimbVector &) const;
+    void mod_magnitude(LimbVector &, const limb_t *, size_t) const;
+
+private:
+    Int dvs;
+    // The magnitude of the divisor shifted left until its top bit is set
+    vector<limb_t> normalized;
+    // The number of bits of that shift
+    unsigned shift;
+    // The reciprocal of the divisor if it has one limb, else of the top limb of normalized
+    LimbDivisor top;
+    // floor(2^(128n) / |divisor|) for an n-limb divisor, or empty below div_thresholds.barrett limbs
+    vector<limb_t> mu;
+
+    void divide_limbs(limb_t *, limb_t *, const limb_t *, size_t) const;
+    void barrett_divide_limbs(limb_t *, limb_t *, const limb_t *, size_t) const;
+};
+
+/**
+ * @brief Prepare division by an integer.
+ *
+ * @param a_dvs The divisor
+ * @throw domain_error if the divisor is zero
+ */
+Divider::Divider(const Int &a_dvs)
+    : dvs(a_dvs, std::pmr::new_delete_resource()),
+      shift(0),
+      top(a_dvs.limbs.empty() ? 1 : a_dvs.limbs.back())
+{
+    const LimbVector &limbs = this->dvs.limbs;
+    size_t n = limbs.size();
+    if (n == 0)
+    {
+        throw domain_error("Cannot divide by zero");
+    }
+    if (n == 1)
+    {
+        return;
+    }
+    this->shift = this->top.shift;
+    this->normalized.resize(n);
+    for (size_t i = n; i-- > 1;)
+    {
+        this->normalized[i] = (this->shift == 0)
+                                  ? limbs[i]
+                                  : (limbs[i] << this->shift) | (limbs[i - 1] >> (LIMB_BITS - this->shift));
+    }
+    this->normalized[0] = limbs[0] << this->shift;
+    this->top = LimbDivisor(this->normalized.back());
+    if (n >= div_thresholds.barrett)
+    {
+        vector<limb_t> b_2n(2 * n + 1, 0);
+        b_2n.back() = 1;
+        this->mu = div_limb_vectors(b_2n, limbs.to_vector());
+    }
+}
+
+/**
+ * @brief Divide a limb array by the divisor's magnitude.
+ *
+ * @param a_q The quotient, of a_len - n + 1 limbs for an n-limb divisor
+ * @param a_rem The remainder, of n limbs
+ * @param a_dvd The dividend, which must not alias either output
+ * @param a_len The length of the dividend, no less than n
+ */
+void Divider::divide_limbs(limb_t *a_q, limb_t *a_rem, const limb_t *a_dvd, size_t a_len) const
+{
+    size_t n = this->dvs.limbs.size();
+    if (n == 1)
+    {
+        a_rem[0] = div_1_limbs(a_q, a_dvd, a_len, this->top);
+    }
+    else if (!this->mu.empty())
+    {
+        barrett_divide_limbs(a_q, a_rem, a_dvd, a_len);
+    }
+    else
+    {
+        div_limbs_preinv(a_q, a_rem, a_dvd, a_len, this->normalized.data(), n, this->shift, this->top);
+    }
+}
+
+/**
+ * @brief Divide a limb array by the divisor's magnitude with Barrett reduction (Menezes et al., Handbook of
+ *      Applied Cryptography, 14.42), an n-limb block of the quotient at a time from the top. Each block
+ *      divides rem * 2^(64n) + the next n limbs of the dividend, which is below |divisor| * 2^(64n).
+ *
+ * @param a_q The quotient, of a_len - n + 1 limbs for an n-limb divisor
+ * @param a_rem The remainder, of n limbs
+ * @param a_dvd The dividend, which must not alias either output
+ * @param a_len The length of the dividend, no less than n
+ */
+void Divider::barrett_divide_limbs(limb_t *a_q, limb_t *a_rem, const limb_t *a_dvd, size_t a_len) const
+{
+    const limb_t *dvs_limbs = this->dvs.limbs.data();
+    size_t n = this->dvs.limbs.size();
+    size_t len_q = a_len - n + 1;
+    ScratchFrame frame;
+    // The running remainder in the high n limbs, and the block of the dividend below it.
+    limb_t *cur = frame.limbs(2 * n);
+    limb_t *prod = frame.limbs(2 * n + 2);
+    limb_t *quot = frame.limbs(n + 1);
+    std::fill(cur + n, cur + 2 * n, 0);
+    std::fill(a_q, a_q + len_q, 0);
+    for (size_t block = (a_len + n - 1) / n; block-- > 0;)
+    {
+        size_t low = block * n;
+        size_t len = std::min(n, a_len - low);
+        std::copy(a_dvd + low, a_dvd + low + len, cur);
+        std::fill(cur + len, cur + n, 0);
+
+        // quot = floor(floor(cur / 2^(64(n-1))) * mu / 2^(64(n+1))), at most 2 below the block's quotient.
+        size_t len_est = n + 1;
+        while (len_est > 0 && cur[n - 1 + len_est - 1] == 0)
+        {
+            len_est--;
+        }
+        size_t len_quot = 0;
+        if (len_est > 0)
+        {
+            mul_limbs(prod, this->mu.data(), this->mu.size(), cur + n - 1, len_est);
+            size_t len_prod = this->mu.size() + len_est;
+            if (len_prod > n + 1)
+            {
+                len_quot = len_prod - (n + 1);
+                std::copy(prod + n + 1, prod + len_prod, quot);
+            }
+            while (len_quot > 0 && quot[len_quot - 1] == 0)
+            {
+                len_quot--;
+            }
+        }
+
+        // cur - quot * divisor is below 3 |divisor|, so its low n + 1 limbs hold it exactly.
+        if (len_quot > 0)
+        {
+            mul_limbs(prod, dvs_limbs, n, quot, len_quot);
+            sub_limbs(cur, cur, n + 1, prod, n + 1);
+        }
+        std::fill(quot + len_quot, quot + n + 1, 0);
+        while (cur[n] != 0 || cmp_limbs(cur, n, dvs_limbs, n) >= 0)
+        {
+            cur[n] -= sub_limbs(cur, cur, n, dvs_limbs, n);
+            for (size_t i = 0; ++quot[i] == 0; i++)
+            {
+            }
+        }
+
+        for (size_t i = 0; i < n && low + i < len_q; i++)
+        {
+            a_q[low + i] = quot[i];
+        }
+        std::copy(cur, cur + n, cur + n);
+    }
+    std::copy(cur + n, cur + 2 * n, a_rem);
+}
+
+/**
+ * @brief Divide a magnitude by the divisor's magnitude.
+ *
+ * @param a_q The vector that accepts the quotient, trimmed
+ * @param a_rem The vector that accepts the remainder, trimmed
+ * @param a_dvd The dividend, trimmed, which may be either output
+ */
+void Divider::divmod_magnitudes(LimbVector &a_q, LimbVector &a_rem, const LimbVector &a_dvd) const
+{
+    BIGINT_PROBE(InstrumentOp::Div, a_dvd.size());
+    const LimbVector &dvs_limbs = this->dvs.limbs;
+    if (cmp_limbs(a_dvd.data(), a_dvd.size(), dvs_limbs.data(), dvs_limbs.size()) < 0)
+    {
+        a_rem = a_dvd;
+        a_q.clear();
+        return;
+    }
+    // As in the free divmod_magnitudes, per-thread buffers trade places with the outputs.
+    static thread_local LimbVector quot(std::pmr::new_delete_resource());
+    static thread_local LimbVector rem(std::pmr::new_delete_resource());
+    quot.resize(a_dvd.size() - dvs_limbs.size() + 1);
+    rem.resize(dvs_limbs.size());
+    divide_limbs(quot.data(), rem.data(), a_dvd.data(), a_dvd.size());
+    trim_limb_vector(quot);
+    trim_limb_vector(rem);
+    a_q.swap(quot);
+    a_rem.swap(rem);
+}
+
+/**
+ * @brief Reduce a magnitude by the divisor's magnitude, keeping the quotient in scratch memory.
+ *
+ * @param a_rem The vector that accepts the remainder, trimmed
+ * @param a_dvd The dividend, trimmed, which may lie in a_rem
+ * @param a_len The length of the dividend
+ */
+void Divider::mod_magnitude(LimbVector &a_rem, const limb_t *a_dvd, size_t a_len) const
+{
+    BIGINT_PROBE(InstrumentOp::Div, a_len);
+    const LimbVector &dvs_limbs = this->dvs.limbs;
+    size_t n = dvs_limbs.size();
+    if (cmp_limbs(a_dvd, a_len, dvs_limbs.data(), n) < 0)
+    {
+        if (a_dvd != a_rem.data())
+        {
+            a_rem.resize(a_len);
+            std::copy(a_dvd, a_dvd + a_len, a_rem.data());
+        }
+        return;
+    }
+    ScratchFrame frame;
+    limb_t *quot = frame.limbs(a_len - n + 1);
+    limb_t *rem = frame.limbs(n);
+    divide_limbs(quot, rem, a_dvd, a_len);
+    while (n > 0 && rem[n - 1] == 0)
+    {
+        n--;
+    }
+    a_rem.resize(n);
+    std::copy(rem, rem + n, a_rem.data());
+}
+
+/**
+ * @brief Divide an integer by the divisor, as the free divmod() does.
+ *
+ * @param a_dvd The dividend
+ * @param a_rounding The rounding of the quotient
+ * @return The quotient and the remainder
+ */
+std::pair<Int, Int> Divider::divmod(const Int &a_dvd, DivRounding a_rounding) const
+{
+    LimbVector quot_limbs;
+    LimbVector rem_limbs;
+    divmod_magnitudes(quot_limbs, rem_limbs, a_dvd.limbs);
+    return divmod_signs(quot_limbs, rem_limbs, a_dvd, this->dvs, a_rounding);
+}
+
+/**
+ * @brief Divide an integer by the divisor, truncating toward zero as operator/ does.
+ *
+ * @param a_dvd The dividend
+ * @return The quotient
+ */
+Int Divider::quotient(const Int &a_dvd) const
+{
+    return divmod(a_dvd).first;
+}
+
+/**
+ * @brief Return the remainder of an integer divided by the divisor, with the sign of the dividend as
+ *      operator% gives it.
+ *
+ * @param a_dvd The dividend
+ * @return The remainder
+ */
+Int Divider::remainder(const Int &a_dvd) const
+{
+    LimbVector rem;
+    mod_magnitude(rem, a_dvd.limbs.data(), a_dvd.limbs.size());
+    return Int::from_limbs(a_dvd.is_positive || rem.empty(), std::move(rem));
+}
+
+/**
+ * @brief Arithmetic modulo a fixed integer, with the constants of the modulus computed once, for reducing
+ *      many numbers by the same modulus. mod() and mulmod() take and return plain residues in [0, |m|).
+ *      add(), sub() and mul() work in the reducer's domain, which to_domain() enters and from_domain()
+ *      leaves: for odd moduli below div_thresholds.barrett limbs it is the Montgomery domain, so that mul()
+ *      needs no division, and otherwise it is the plain residues, reduced by a Divider. Like Divider, a
+ *      Reducer may be shared by several threads.
+ */
+class Reducer
+{
+public:
+    explicit Reducer(const Int &);
+
+    const Int &modulus() const { return this->divider.divisor(); }
+    Int mod(const Int &) const;
+    Int mulmod(const Int &, const Int &) const;
+    Int to_domain(const Int &) const;
+    Int from_domain(const Int &) const;
+    Int add(const Int &, const Int &) const;
+    Int sub(const Int &, const Int &) const;
+    Int mul(const Int &, const Int &) const;
+
+private:
+    Divider divider;
+    std::optional<MontgomeryContext> montgomery;
+
+    Int montgomery_mul(const Int &, const Int &) const;
+};
+
+/**
+ * @brief Prepare arithmetic modulo an integer.
+ *
+ * @param a_mod The modulus. Its sign is ignored.
+ * @throw domain_error if the modulus is zero
+ */
+Reducer::Reducer(const Int &a_mod) : divider(abs(a_mod))
+{
+    const LimbVector &limbs = modulus().limbs;
+    if ((limbs[0] & 1) && limbs.size() < div_thresholds.barrett)
+    {
+        this->montgomery.emplace(limbs.to_vector());
+    }
+}
+
+/**
+ * @brief Reduce an integer modulo the modulus.
+ *
+ * @param a_opr The integer
+ * @return a_opr mod |m|, in [0, |m|)
+ */
+Int Reducer::mod(const Int &a_opr) const
+{
+    LimbVector rem;
+    this->divider.mod_magnitude(rem, a_opr.limbs.data(), a_opr.limbs.size());
+    if (!a_opr.is_positive && !rem.empty())
+    {
+        sub_magnitudes(rem, modulus().limbs, rem);
+    }
+    return Int::from_limbs(true, std::move(rem));
+}
+
+/**
+ * @brief Multiply two residues modulo the modulus, reducing the product with the Divider.
+ *
+ * @param a_opr_1 The first residue, in [0, |m|)
+ * @param a_opr_2 The second residue, in [0, |m|)
+ * @return a_opr_1 * a_opr_2 mod |m|
+ */
+Int Reducer::mulmod(const Int &a_opr_1, const Int &a_opr_2) const
+{
+    size_t len_1 = a_opr_1.limbs.size();
+    size_t len_2 = a_opr_2.limbs.size();
+    LimbVector rem;
+    if (len_1 != 0 && len_2 != 0)
+    {
+        ScratchFrame frame;
+        limb_t *prod = frame.limbs(len_1 + len_2);
+        mul_limbs(prod, a_opr_1.limbs.data(), len_1, a_opr_2.limbs.data(), len_2);
+        size_t len = len_1 + len_2 - ((prod[len_1 + len_2 - 1] == 0) ? 1 : 0);
+        this->divider.mod_magnitude(rem, prod, len);
+    }
+    return Int::from_limbs(true, std::move(rem));
+}
+
+/**
+ * @brief Multiply two values of the Montgomery domain.
+ *
+ * @param a_opr_1 The first value
+ * @param a_opr_2 The second value
+ * @return a_opr_1 * a_opr_2 / R mod |m|
+ */
+Int Reducer::montgomery_mul(const Int &a_opr_1, const Int &a_opr_2) const
+{
+    size_t n = this->montgomery->size();
+    ScratchFrame frame;
+    limb_t *opr_1 = frame.limbs(n);
+    std::copy(a_opr_1.limbs.begin(), a_opr_1.limbs.end(), opr_1);
+    std::fill(opr_1 + a_opr_1.limbs.size(), opr_1 + n, 0);
+    limb_t *opr_2 = opr_1;
+    if (&a_opr_1 != &a_opr_2)
+    {
+        opr_2 = frame.limbs(n);
+        std::copy(a_opr_2.limbs.begin(), a_opr_2.limbs.end(), opr_2);
+        std::fill(opr_2 + a_opr_2.limbs.size(), opr_2 + n, 0);
+    }
+    LimbVector result;
+    result.resize(n);
+    this->montgomery->mul(result.data(), opr_1, opr_2);
+    trim_limb_vector(result);
+    return Int::from_limbs(true, std::move(result));
+}
+
+/**
+ * @brief Bring an integer into the reducer's domain.
+ *
+ * @param a_opr The integer
+ * @return The value of a_opr mod |m| in the domain
+ */
+Int Reducer::to_domain(const Int &a_opr) const
+{
+    Int result = mod(a_opr);
+    if (this->montgomery)
+    {
+        return montgomery_mul(result, Int::from_limbs(true, this->montgomery->r_squared));
+    }
+    return result;
+}
+
+/**
+ * @brief Take a value out of the reducer's domain.
+ *
+ * @param a_opr A value in the domain
+ * @return The residue it stands for, in [0, |m|)
+ */
+Int Reducer::from_domain(const Int &a_opr) const
+{
+    if (this->montgomery)
+    {
+        return montgomery_mul(a_opr, Int::from_limbs(true, vector<limb_t>{1}));
+    }
+    return a_opr;
+}
+
+/**
+ * @brief Add two values of the domain.
+ *
+ * @param a_opr_1 The first value
+ * @param a_opr_2 The second value
+ * @return The sum, in the domain
+ */
+Int Reducer::add(const Int &a_opr_1, const Int &a_opr_2) const
+{
+    Int result = a_opr_1 + a_opr_2;
+    if (result >= modulus())
+    {
+        result -= modulus();
+    }
+    return result;
+}
+
+/**
+ * @brief Subtract two values of the domain.
+ *
+ * @param a_opr_1 The minuend
+ * @param a_opr_2 The subtrahend
+ * @return The difference, in the domain
+ */
+Int Reducer::sub(const Int &a_opr_1, const Int &a_opr_2) const
+{
+    Int result = a_opr_1 - a_opr_2;
+    if (!result.is_positive)
+    {
+        result += modulus();
+    }
+    return result;
+}
+
+/**
+ * @brief Multiply two values of the domain.
+ *
+ * @param a_opr_1 The first value
+ * @param a_opr_2 The second value
+ * @return The product, in the domain
+ */
+Int Reducer::mul(const Int &a_opr_1, const Int &a_opr_2) const
+{
+    if (this->montgomery)
+    {
+        return montgomery_mul(a_opr_1, a_opr_2);
+    }
+    return mulmod(a_opr_1, a_opr_2);
+}
+
+/**
+ * @brief Operand sizes, in limbs, at which gcd() switches algorithm. May be changed at run time through
+ *      gcd_thresholds.
+ */
+struct GcdThresholds
+{
+    // At or above this length of the smaller operand, reduce with the subquadratic half-GCD.
+    size_t half_gcd = 160;
+};
+
+/**
+ * @brief The thresholds used by gcd(), lcm(), xgcd() and modinv().
+ */
+GcdThresholds gcd_thresholds;
+
+/**
+ * @brief The product of the quotient matrices [[q, 1], [1, 0]] of some steps of Euclid's algorithm, with
+ *      entries of one limb, such that (a, b) = M (a', b') for the values before and after the steps.
+ */
+struct LehmerMatrix
+{
+    limb_t m00 = 1;
+    limb_t m01 = 0;
+    limb_t m10 = 0;
+    limb_t m11 = 1;
+    // If the determinant is -1, after an odd number of steps
+    bool odd = false;
+};
+
+/**
+ * @brief Run Euclid's algorithm on two 128-bit numbers, taking only the steps whose remainder is at least
+ *      a_floor. For the leading 128 bits of two longer numbers and a_floor of at least 2^65, every entry of
+ *      the matrix is below 2^63 and below the reduced values, so that applied to the whole numbers the
+ *      matrix gives two positive values: a Lehmer step that covers about one limb of quotients at once.
+ *
+ * @param a_opr_1 The first number
+ * @param a_opr_2 The second number, no greater than the first
+ * @param a_floor The smallest remainder to step to, or 0 to run to the end
+ * @param a_m The matrix that accepts the steps
+ * @return If at least one step was taken
+ */
+bool lehmer_matrix(dlimb_t a_opr_1, dlimb_t a_opr_2, dlimb_t a_floor, LehmerMatrix &a_m)
+{
+    a_m = LehmerMatrix();
+    bool stepped = false;
+    while (a_opr_2 != 0 && a_opr_2 >= a_floor)
+    {
+        // Most quotients are small, and a 128-bit division is a slow library call.
+        limb_t q = 1;
+        dlimb_t rem = a_opr_1 - a_opr_2;
+        while (rem >= a_opr_2 && q < 4)
+        {
+            rem -= a_opr_2;
+            q++;
+        }
+        if (rem >= a_opr_2)
+        {
+            q = (limb_t)(a_opr_1 / a_opr_2);
+            rem = a_opr_1 % a_opr_2;
+        }
+        if (rem < a_floor)
+        {
+            break;
+        }
+        limb_t m00 = a_m.m00;
+        limb_t m10 = a_m.m10;
+        a_m.m00 = m00 * q + a_m.m01;
+        a_m.m01 = m00;
+        a_m.m10 = m10 * q + a_m.m11;
+        a_m.m11 = m10;
+        a_m.odd = !a_m.odd;
+        a_opr_1 = a_opr_2;
+        a_opr_2 = rem;
+        stepped = true;
+    }
+    return stepped;
+}
+
+/**
+ * @brief Compute a_u * a_x - a_v * a_y, for a result known not to be negative and to fit in a_len limbs.
+ *
+ * @param a_r The output of a_len limbs, which must not alias either operand
+ * @param a_x The first array, of a_len limbs
+ * @param a_u The multiplier of the first array
+ * @param a_y The second array, of a_len limbs
+ * @param a_v The multiplier of the second array
+ * @param a_len The length of the arrays
+ */
+void submul_2_limbs(limb_t *a_r, const limb_t *a_x, limb_t a_u, const limb_t *a_y, limb_t a_v, size_t a_len)
+{
+    limb_t carry_x = 0;
+    limb_t carry_y = 0;
+    limb_t borrow = 0;
+    for (size_t i = 0; i < a_len; i++)
+    {
+        dlimb_t prod_x = (dlimb_t)a_u * a_x[i] + carry_x;
+        dlimb_t prod_y = (dlimb_t)a_v * a_y[i] + carry_y;
+        carry_x = (limb_t)(prod_x >> LIMB_BITS);
+        carry_y = (limb_t)(prod_y >> LIMB_BITS);
+        limb_t lhs = (limb_t)prod_x;
+        limb_t rhs = (limb_t)prod_y;
+        limb_t diff = lhs - rhs;
+        limb_t borrow_out = (lhs < rhs) ? 1 : 0;
+        borrow_out += (diff < borrow) ? 1 : 0;
+        a_r[i] = diff - borrow;
+        borrow = borrow_out;
+    }
+}
+
+/**
+ * @brief Compute a_u * a_x + a_v * a_y.
+ *
+ * @param a_r The output of a_len limbs, which may alias either operand
+ * @param a_x The first array, of a_len limbs
+ * @param a_u The multiplier of the first array
+ * @param a_y The second array, of a_len limbs
+ * @param a_v The multiplier of the second array
+ * @param a_len The length of the arrays
+ * @return The carry out of the most significant limb
+ */
+limb_t addmul_2_limbs(limb_t *a_r, const limb_t *a_x, limb_t a_u, const limb_t *a_y, limb_t a_v, size_t a_len)
+{
+    limb_t carry_x = 0;
+    limb_t carry_y = 0;
+    limb_t carry = 0;
+    for (size_t i = 0; i < a_len; i++)
+    {
+        dlimb_t prod_x = (dlimb_t)a_u * a_x[i] + carry_x;
+        dlimb_t prod_y = (dlimb_t)a_v * a_y[i] + carry_y;
+        carry_x = (limb_t)(prod_x >> LIMB_BITS);
+        carry_y = (limb_t)(prod_y >> LIMB_BITS);
+        dlimb_t sum = (dlimb_t)(limb_t)prod_x + (limb_t)prod_y + carry;
+        a_r[i] = (limb_t)sum;
+        carry = (limb_t)(sum >> LIMB_BITS);
+    }
+    return carry_x + carry_y + carry;
+}
+
+/**
+ * @brief Replace two magnitudes (a, b) with M^-1 (a, b) for a Lehmer matrix M, which must give two values
+ *      that are not negative.
+ *
+ * @param a_opr_1 The first magnitude, trimmed, no shorter than the second
+ * @param a_opr_2 The second magnitude, trimmed
+ * @param a_m The matrix
+ */
+void lehmer_apply(LimbVector &a_opr_1, LimbVector &a_opr_2, const LehmerMatrix &a_m)
+{
+    size_t n = a_opr_1.size();
+    ScratchFrame frame;
+    limb_t *opr_2 = frame.limbs(n);
+    std::copy(a_opr_2.begin(), a_opr_2.end(), opr_2);
+    std::fill(opr_2 + a_opr_2.size(), opr_2 + n, 0);
+    limb_t *r_1 = frame.limbs(n);
+    limb_t *r_2 = frame.limbs(n);
+    // M^-1 is [[m11, -m01], [-m10, m00]] when the determinant is 1, and its negation otherwise.
+    if (a_m.odd)
+    {
+        submul_2_limbs(r_1, opr_2, a_m.m01, a_opr_1.data(), a_m.m11, n);
+        submul_2_limbs(r_2, a_opr_1.data(), a_m.m10, opr_2, a_m.m00, n);
+    }
+    else
+    {
+        submul_2_limbs(r_1, a_opr_1.data(), a_m.m11, opr_2, a_m.m01, n);
+        submul_2_limbs(r_2, opr_2, a_m.m00, a_opr_1.data(), a_m.m10, n);
+    }
+    size_t len_1 = n;
+    while (len_1 > 0 && r_1[len_1 - 1] == 0)
+    {
+        len_1--;
+    }
+    size_t len_2 = n;
+    while (len_2 > 0 && r_2[len_2 - 1] == 0)
+    {
+        len_2--;
+    }
+    a_opr_1.resize(len_1);
+    std::copy(r_1, r_1 + len_1, a_opr_1.data());
+    a_opr_2.resize(len_2);
+    std::copy(r_2, r_2 + len_2, a_opr_2.data());
+}
+
+/**
+ * @brief Replace two cofactors (u, v) with M^-1 (u, v) for a Lehmer matrix M, as lehmer_apply does to the
+ *      values they belong to.
+ *
+ * @param a_cof_1 The first cofactor
+ * @param a_cof_2 The second cofactor
+ * @param a_m The matrix
+ */
+void lehmer_apply_cofactors(Int &a_cof_1, Int &a_cof_2, const LehmerMatrix &a_m)
+{
+    Int cof_1 = a_cof_1 * a_m.m11 - a_cof_2 * a_m.m01;
+    Int cof_2 = a_cof_2 * a_m.m00 - a_cof_1 * a_m.m10;
+    if (a_m.odd)
+    {
+        cof_1.is_positive = !cof_1.is_positive || cof_1.limbs.empty();
+        cof_2.is_positive = !cof_2.is_positive || cof_2.limbs.empty();
+    }
+    a_cof_1 = std::move(cof_1);
+    a_cof_2 = std::move(cof_2);
+}
+
+/**
+ * @brief Return the 128 bits of a magnitude from bit a_bit up.
+ *
+ * @param a_opr The magnitude
+ * @param a_bit The lowest bit to take
+ * @return The bits
+ */
+dlimb_t limb_window(const LimbVector &a_opr, size_t a_bit)
+{
+    size_t index = a_bit / LIMB_BITS;
+    unsigned shift = (unsigned)(a_bit % LIMB_BITS);
+    limb_t limbs[3];
+    for (size_t i = 0; i < 3; i++)
+    {
+        limbs[i] = (index + i < a_opr.size()) ? a_opr[index + i] : 0;
+    }
+    dlimb_t low = ((dlimb_t)limbs[1] << LIMB_BITS) | limbs[0];
+    return (shift == 0) ? low : (low >> shift) | ((dlimb_t)limbs[2] << (2 * LIMB_BITS - shift));
+}
+
+/**
+ * @brief A product of quotient matrices of Euclid's algorithm with entries of any size, such that
+ *      (a, b) = M (a', b') for the values before and after the steps, as built by the half-GCD.
+ */
+struct GcdMatrix
+{
+    Int m00 = 1;
+    Int m01 = 0;
+    Int m10 = 0;
+    Int m11 = 1;
+    // If the determinant is -1
+    bool odd = false;
+
+    /**
+     * @brief Append one step of Euclid's algorithm with quotient a_q: M = M [[q, 1], [1, 0]].
+     */
+    void step(const Int &a_q)
+    {
+        Int m00_q = m00 * a_q + m01;
+        Int m10_q = m10 * a_q + m11;
+        m01 = std::move(m00);
+        m11 = std::move(m10);
+        m00 = std::move(m00_q);
+        m10 = std::move(m10_q);
+        odd = !odd;
+    }
+
+    /**
+     * @brief Append the steps of another matrix: M = M a_m.
+     */
+    void append(const GcdMatrix &a_m)
+    {
+        Int r00 = m00 * a_m.m00 + m01 * a_m.m10;
+        Int r01 = m00 * a_m.m01 + m01 * a_m.m11;
+        Int r10 = m10 * a_m.m00 + m11 * a_m.m10;
+        m11 = m10 * a_m.m01 + m11 * a_m.m11;
+        m00 = std::move(r00);
+        m01 = std::move(r01);
+        m10 = std::move(r10);
+        odd = (odd != a_m.odd);
+    }
+
+    /**
+     * @brief Append the steps of a Lehmer matrix, a row at a time in place, since every entry is positive.
+     */
+    void append(const LehmerMatrix &a_m)
+    {
+        append_row(m00.limbs, m01.limbs, a_m);
+        append_row(m10.limbs, m11.limbs, a_m);
+        odd = (odd != a_m.odd);
+    }
+
+    /**
+     * @brief Replace a row (x, y) with (x m00 + y m10, x m01 + y m11).
+     */
+    static void append_row(LimbVector &a_x, LimbVector &a_y, const LehmerMatrix &a_m)
+    {
+        size_t n = std::max(a_x.size(), a_y.size()) + 1;
+        ScratchFrame frame;
+        limb_t *x = frame.limbs(n);
+        limb_t *y = frame.limbs(n);
+        std::copy(a_x.begin(), a_x.end(), x);
+        std::fill(x + a_x.size(), x + n, 0);
+        std::copy(a_y.begin(), a_y.end(), y);
+        std::fill(y + a_y.size(), y + n, 0);
+        a_x.resize(n);
+        a_y.resize(n);
+        addmul_2_limbs(a_x.data(), x, a_m.m00, y, a_m.m10, n);
+        addmul_2_limbs(a_y.data(), x, a_m.m01, y, a_m.m11, n);
+        trim_limb_vector(a_x);
+        trim_limb_vector(a_y);
+    }
+
+    /**
+     * @brief Replace (a, b) with M^-1 (a, b).
+     */
+    void apply_inverse(Int &a_opr_1, Int &a_opr_2) const
+    {
+        Int opr_1 = m11 * a_opr_1 - m01 * a_opr_2;
+        Int opr_2 = m00 * a_opr_2 - m10 * a_opr_1;
+        if (odd)
+        {
+            opr_1 = -opr_1;
+            opr_2 = -opr_2;
+        }
+        a_opr_1 = std::move(opr_1);
+        a_opr_2 = std::move(opr_2);
+    }
+};
+
+/**
+ * @brief Take one step of Euclid's algorithm, (a, b) = (b, a mod b), unless the remainder has a_bound bits
+ *      or fewer.
+ *
+ * @param a_opr_1 The first value, not negative
+ * @param a_opr_2 The second value, positive
+ * @param a_bound The number of bits the remainder must exceed
+ * @param a_m The matrix that accepts the step, or nullptr
+ * @return If the step was taken
+ */
+bool hgcd_step(Int &a_opr_1, Int &a_opr_2, size_t a_bound, GcdMatrix *a_m)
+{
+    auto [quot, rem] = divmod(a_opr_1, a_opr_2);
+    if (rem.bit_length() <= a_bound)
+    {
+        return false;
+    }
+    a_opr_1 = std::move(a_opr_2);
+    a_opr_2 = std::move(rem);
+    if (a_m)
+    {
+        a_m->step(quot);
+    }
+    return true;
+}
+
+/**
+ * @brief Reduce two values with Lehmer steps as long as both stay above 2^a_bound, each step taking the
+ *      Euclid quotients that the leading 128 bits determine.
+ *
+ * @param a_opr_1 The first value, not below the second
+ * @param a_opr_2 The second value, above 2^a_bound
+ * @param a_bound The number of bits both values must keep
+ * @param a_m The matrix that accepts the steps, or nullptr
+ */
+void hgcd_lehmer(Int &a_opr_1, Int &a_opr_2, size_t a_bound, GcdMatrix *a_m)
+{
+    while (true)
+    {
+        size_t n = a_opr_1.bit_length();
+        size_t low = (n > 2 * LIMB_BITS) ? n - 2 * LIMB_BITS : 0;
+        // Values of at least 2^bound in the window, with bound of at least 65, stay above 2^(bound - 1 + low)
+        // in the whole numbers.
+        size_t bound = std::max((size_t)LIMB_BITS + 1, a_bound + 1 - std::min(a_bound, low));
+        LehmerMatrix m;
+        if (bound < 2 * LIMB_BITS &&
+            lehmer_matrix(limb_window(a_opr_1.limbs, low), limb_window(a_opr_2.limbs, low), (dlimb_t)1 << bound, m))
+        {
+            lehmer_apply(a_opr_1.limbs, a_opr_2.limbs, m);
+            if (a_m)
+            {
+                a_m->append(m);
+            }
+            if (a_opr_1 < a_opr_2)
+            {
+                hgcd_step(a_opr_1, a_opr_2, 0, a_m);
+            }
+        }
+        else if (!hgcd_step(a_opr_1, a_opr_2, a_bound, a_m))
+        {
+            return;
+        }
+    }
+}
+
+void hgcd(Int &, Int &, size_t, GcdMatrix *);
+
+/**
+ * @brief Return the low bits of a magnitude.
+ *
+ * @param a_opr The magnitude
+ * @param a_bits The number of bits to keep
+ * @return a_opr mod 2^a_bits
+ */
+Int low_bits(const Int &a_opr, size_t a_bits)
+{
+    size_t len = std::min(a_opr.limbs.size(), (a_bits + LIMB_BITS - 1) / LIMB_BITS);
+    LimbVector limbs;
+    limbs.resize(len);
+    std::copy(a_opr.limbs.begin(), a_opr.limbs.begin() + len, limbs.data());
+    if (len * LIMB_BITS > a_bits)
+    {
+        limbs[len - 1] &= ((limb_t)1 << (a_bits % LIMB_BITS)) - 1;
+    }
+    trim_limb_vector(limbs);
+    return Int::from_limbs(true, std::move(limbs));
+}
+
+/**
+ * @brief Reduce two values by the half-GCD of their bits from a_low up, so that both stay above 2^a_bound.
+ *
+ * @param a_opr_1 The first value, not below the second
+ * @param a_opr_2 The second value
+ * @param a_low The number of low bits to leave out, with 2 (a_bound - a_low) bits left in the first value
+ *      or more
+ * @param a_m The matrix that accepts the steps, or nullptr
+ */
+void hgcd_high(Int &a_opr_1, Int &a_opr_2, size_t a_low, GcdMatrix *a_m)
+{
+    Int high_1 = a_opr_1 >> a_low;
+    Int high_2 = a_opr_2 >> a_low;
+    GcdMatrix m;
+    // If both reduced high parts keep s bits, the entries of M are below 2^(s - 1), so that M^-1 applied to
+    // the whole values leaves both above 2^(s - 1 + a_low).
+    hgcd(high_1, high_2, high_1.bit_length() / 2 + 1, &m);
+    if (m.m01.limbs.empty() && m.m10.limbs.empty())
+    {
+        return;
+    }
+    // M^-1 takes the high parts to the reduced ones, so only the low parts need multiplying.
+    Int low_1 = low_bits(a_opr_1, a_low);
+    Int low_2 = low_bits(a_opr_2, a_low);
+    m.apply_inverse(low_1, low_2);
+    a_opr_1 = (high_1 << a_low) + low_1;
+    a_opr_2 = (high_2 << a_low) + low_2;
+    if (a_m)
+    {
+        a_m->append(m);
+    }
+}
+
+/**
+ * @brief Reduce two values with the half-GCD (Thull and Yap, "A unified approach to HGCD algorithms for
+ *      polynomials and integers", 1990; Moller, "On Schonhage's algorithm and subquadratic integer GCD
+ *      computation", 2008): take Euclid steps as long as both values stay above 2^a_bound, finding them
+ *      from the high half of the bits in two recursive calls, each on half of the length, so that the
+ *      cost is O(M(n) log n) instead of quadratic.
+ *
+ * @param a_opr_1 The first value, not negative
+ * @param a_opr_2 The second value, not negative
+ * @param a_bound The number of bits both values must keep, with a_opr_1 below 2^(2 a_bound)
+ * @param a_m The matrix that accepts the steps, or nullptr
+ */
+void hgcd(Int &a_opr_1, Int &a_opr_2, size_t a_bound, GcdMatrix *a_m)
+{
+    if (a_opr_1 < a_opr_2)
+    {
+        hgcd_step(a_opr_1, a_opr_2, 0, a_m);
+    }
+    if (a_opr_2.bit_length() <= a_bound)
+    {
+        return;
+    }
+    if (a_opr_2.limbs.size() < gcd_thresholds.half_gcd)
+    {
+        hgcd_lehmer(a_opr_1, a_opr_2, a_bound, a_m);
+        return;
+    }
+
+    // Take about half of the steps from the leading half of the bits.
+    hgcd_high(a_opr_1, a_opr_2, a_bound, a_m);
+    if (!hgcd_step(a_opr_1, a_opr_2, a_bound, a_m))
+    {
+        return;
+    }
+    // Then the rest from the leading 2 (n - a_bound) bits of what is left.
+    size_t n = a_opr_1.bit_length();
+    if (a_opr_2.limbs.size() >= gcd_thresholds.half_gcd && 2 * a_bound > n)
+    {
+        hgcd_high(a_opr_1, a_opr_2, 2 * a_bound - n, a_m);
+    }
+    if (a_opr_1 < a_opr_2)
+    {
+        hgcd_step(a_opr_1, a_opr_2, 0, a_m);
+    }
+    hgcd_lehmer(a_opr_1, a_opr_2, a_bound, a_m);
+}
+
+/**
+ * @brief Return the number of trailing zero bits of a number of one or two limbs, not zero.
+ */
+unsigned ctz_limbs(limb_t a_opr)
+{
+    return (unsigned)__builtin_ctzll(a_opr);
+}
+
+unsigned ctz_limbs(dlimb_t a_opr)
+{
+    limb_t low = (limb_t)a_opr;
+    return (low != 0) ? ctz_limbs(low) : LIMB_BITS + ctz_limbs((limb_t)(a_opr >> LIMB_BITS));
+}
+
+/**
+ * @brief Return the greatest common divisor of two magnitudes of one or two limbs, with binary GCD, which
+ *      needs no division.
+ *
+ * @tparam T limb_t or dlimb_t
+ * @param a_opr_1 The first magnitude
+ * @param a_opr_2 The second magnitude
+ * @return Their greatest common divisor
+ */
+template <typename T>
+T binary_gcd(T a_opr_1, T a_opr_2)
+{
+    if (a_opr_1 == 0 || a_opr_2 == 0)
+    {
+        return a_opr_1 | a_opr_2;
+    }
+    unsigned shift = ctz_limbs(a_opr_1 | a_opr_2);
+    a_opr_1 >>= ctz_limbs(a_opr_1);
+    while (a_opr_2 != 0)
+    {
+        a_opr_2 >>= ctz_limbs(a_opr_2);
+        if (a_opr_1 > a_opr_2)
+        {
+            std::swap(a_opr_1, a_opr_2);
+        }
+        a_opr_2 -= a_opr_1;
+    }
+    return a_opr_1 << shift;
+}
+
+/**
+ * @brief Run Euclid's algorithm to the end on two values, leaving their greatest common divisor in the
+ *      first and zero in the second. Large values are reduced by the half-GCD, smaller ones by Lehmer
+ *      steps, one limb of quotients at a time.
+ *
+ * @param a_opr_1 The first value, not negative
+ * @param a_opr_2 The second value, not negative
+ * @param a_cof_1 If not nullptr, a cofactor u of the first value, a multiple of the original first value
+ *      congruent to it modulo the original second one, updated with it
+ * @param a_cof_2 The cofactor of the second value, if a_cof_1 is not nullptr
+ */
+void gcd_reduce(Int &a_opr_1, Int &a_opr_2, Int *a_cof_1, Int *a_cof_2)
+{
+    auto euclid_step = [&]()
+    {
+        auto [quot, rem] = divmod(a_opr_1, a_opr_2);
+        a_opr_1 = std::move(a_opr_2);
+        a_opr_2 = std::move(rem);
+        if (a_cof_1)
+        {
+            Int cof = *a_cof_1 - quot * *a_cof_2;
+            *a_cof_1 = std::move(*a_cof_2);
+            *a_cof_2 = std::move(cof);
+        }
+    };
+    if (a_opr_1 < a_opr_2)
+    {
+        euclid_step();
+    }
+    while (!a_opr_2.limbs.empty())
+    {
+        if (a_opr_2.limbs.size() >= gcd_thresholds.half_gcd)
+        {
+            size_t bound = a_opr_1.bit_length() / 2 + 1;
+            if (a_opr_2.bit_length() > bound)
+            {
+                GcdMatrix m;
+                hgcd(a_opr_1, a_opr_2, bound, a_cof_1 ? &m : nullptr);
+                if (a_cof_1)
+                {
+                    m.apply_inverse(*a_cof_1, *a_cof_2);
+                }
+            }
+            euclid_step();
+            continue;
+        }
+        if (a_opr_1.limbs.size() == 1 && !a_cof_1)
+        {
+            a_opr_1 = binary_gcd(a_opr_1.limbs[0], a_opr_2.limbs[0]);
+            a_opr_2 = 0;
+            return;
+        }
+        if (a_opr_1.limbs.size() == 2 && !a_cof_1)
+        {
+            a_opr_1 = binary_gcd(limb_window(a_opr_1.limbs, 0), limb_window(a_opr_2.limbs, 0));
+            a_opr_2 = 0;
+            return;
+        }
+        // Two values of one limb run to the end in one matrix, whose entries are no greater than the values.
+        size_t n = a_opr_1.bit_length();
+        size_t low = (n > 2 * LIMB_BITS) ? n - 2 * LIMB_BITS : 0;
+        dlimb_t floor = (a_opr_1.limbs.size() == 1) ? 0 : (dlimb_t)1 << (LIMB_BITS + 1);
+        LehmerMatrix m;
+        if (lehmer_matrix(limb_window(a_opr_1.limbs, low), limb_window(a_opr_2.limbs, low), floor, m))
+        {
+            lehmer_apply(a_opr_1.limbs, a_opr_2.limbs, m);
+            if (a_cof_1)
+            {
+                lehmer_apply_cofactors(*a_cof_1, *a_cof_2, m);
+            }
+            if (a_opr_1 < a_opr_2)
+            {
+                euclid_step();
+            }
+        }
+        else
+        {
+            euclid_step();
+        }
+    }
+}
+
+/**
+ * @brief Return the greatest common divisor of two integers.
+ *
+ * @param a_opr_1 The first integer
+ * @param a_opr_2 The second integer
+ * @return The greatest common divisor, not negative, and 0 only if both integers are 0
+ */
+Int gcd(const Int &a_opr_1, const Int &a_opr_2)
+{
+    Int opr_1 = abs(a_opr_1);
+    Int opr_2 = abs(a_opr_2);
+    gcd_reduce(opr_1, opr_2, nullptr, nullptr);
+    return opr_1;
+}
+
+/**
+ * @brief Return the least common multiple of two integers.
+ *
+ * @param a_opr_1 The first integer
+ * @param a_opr_2 The second integer
+ * @return The least common multiple, not negative, and 0 if either integer is 0
+ */
+Int lcm(const Int &a_opr_1, const Int &a_opr_2)
+{
+    if (a_opr_1.limbs.empty() || a_opr_2.limbs.empty())
+    {
+        return 0;
+    }
+    return abs(a_opr_1) / gcd(a_opr_1, a_opr_2) * abs(a_opr_2);
+}
+
+/**
+ * @brief Return the greatest common divisor g of two integers a and b with cofactors s and t such that
+ *      a s + b t = g. When b is not 0, s is the one with |s| <= |b| / (2 g); when b is 0, s is the sign
+ *      of a and t is 0.
+ *
+ * @param a_opr_1 The first integer a
+ * @param a_opr_2 The second integer b
+ * @return g, s and t
+ */
+std::tuple<Int, Int, Int> xgcd(const Int &a_opr_1, const Int &a_opr_2)
+{
+    Int common = abs(a_opr_1);
+    Int opr_2 = abs(a_opr_2);
+    Int cof_1 = 1;
+    Int cof_2 = 0;
+    gcd_reduce(common, opr_2, &cof_1, &cof_2);
+    if (a_opr_2.limbs.empty())
+    {
+        return {common, a_opr_1.limbs.empty() ? 0 : (a_opr_1.is_positive ? 1 : -1), 0};
+    }
+    // Any s + k |b| / g also works. Take the one closest to zero, and solve for t.
+    Int period = abs(a_opr_2) / common;
+    Int cof = divmod(a_opr_1.is_positive ? cof_1 : -cof_1, period, DivRounding::Floor).second;
+    if (cof * 2 > period)
+    {
+        cof -= period;
+    }
+    Int other = (common - a_opr_1 * cof) / a_opr_2;
+    return {std::move(common), std::move(cof), std::move(other)};
+}
+
+/**
+ * @brief Return the inverse of an integer modulo another.
+ *
+ * @param a_opr The integer
+ * @param a_mod The modulus, not zero. Its sign is ignored.
+ * @return The x in [0, |a_mod|) with a_opr x = 1 mod |a_mod|
+ * @throw domain_error if the modulus is zero or the integer has no inverse
+ */
+Int modinv(const Int &a_opr, const Int &a_mod)
+{
+    if (a_mod.limbs.empty())
+    {
+        throw domain_error("Cannot invert modulo zero");
+    }
+    Int mod = abs(a_mod);
+    Int opr = divmod(a_opr, mod, DivRounding::Floor).second;
+    Int cof_1 = 1;
+    Int cof_2 = 0;
+    gcd_reduce(opr, mod, &cof_1, &cof_2);
+    if (opr != 1)
+    {
+        throw domain_error("Not invertible");
+    }
+    return divmod(cof_1, abs(a_mod), DivRounding::Floor).second;
+}
+
+/**
+ * @brief The number of lanes IntBatch kernels work on at a time, sized so that a block of carries and
+ *      accumulators stays in the L1 cache.
+ */
+const size_t BATCH_BLOCK = 256;
+
+/**
+ * @brief A batch of integers of the same fixed width, stored in structure-of-arrays layout: limb j of
+ *      every element lies in one contiguous row, so elementwise operations run down whole rows at once
+ *      instead of chasing one allocation per Int. Elements are two's complement with a_width limbs and
+ *      arithmetic between batches wraps modulo 2^(64 * width), like fixed-width machine integers.
+ */
+class IntBatch
+{
+public:
+    IntBatch(size_t, size_t);
+    IntBatch(const vector<Int> &, size_t);
+
+    size_t size() const { return this->count; }
+    size_t width() const { return this->limb_width; }
+    limb_t *row(size_t a_limb) { return this->data.data() + a_limb * this->count; }
+    const limb_t *row(size_t a_limb) const { return this->data.data() + a_limb * this->count; }
+
+    Int get(size_t) const;
+    void set(size_t, const Int &);
+    vector<Int> to_ints() const;
+
+    IntBatch operator+(const IntBatch &) const;
+    IntBatch &operator+=(const IntBatch &);
+    IntBatch operator-(const IntBatch &) const;
+    IntBatch &operator-=(const IntBatch &);
+    IntBatch operator*(const IntBatch &) const;
+    IntBatch &operator*=(const IntBatch &);
+    IntBatch operator+(const Int &) const;
+    IntBatch &operator+=(const Int &);
+    IntBatch operator-(const Int &) const;
+    IntBatch &operator-=(const Int &);
+    IntBatch operator*(const Int &) const;
+    IntBatch &operator*=(const Int &);
+
+private:
+    size_t count;
+    size_t limb_width;
+    vector<limb_t> data;
+
+    void check_shape(const IntBatch &) const;
+    vector<limb_t> to_fixed(const Int &) const;
+    void add_sub(const IntBatch *, const vector<limb_t> &, bool);
+    void mul(const IntBatch *, const vector<limb_t> &);
+};
+
+/**
+ * @brief Construct a batch of zeros.
+ *
+ * @param a_size The number of elements
+ * @param a_width The width of each element in limbs
+ * @throw domain_error if the width is zero
+ */
+IntBatch::IntBatch(size_t a_size, size_t a_width)
+    : count(a_size), limb_width(a_width), data(a_size * a_width, 0)
+{
+    if (a_width == 0)
+    {
+        throw domain_error("An IntBatch needs a width of at least one limb");
+    }
+}
+
+/**
+ * @brief Construct a batch from integers.
+ *
+ * @param a_values The elements
+ * @param a_width The width of each element in limbs
+ * @throw domain_error if the width is zero
+ * @throw out_of_range if an element does not fit in a_width limbs of two's complement
+ */
+IntBatch::IntBatch(const vector<Int> &a_values, size_t a_width)
+    : IntBatch(a_values.size(), a_width)
+{
+    for (size_t i = 0; i < a_values.size(); i++)
+    {
+        this->set(i, a_values[i]);
+    }
+}
+
+/**
+ * @brief Private method. Wrap an integer into the two's complement of this batch's width.
+ *
+ * @param a_value The integer
+ * @return Its residue modulo 2^(64 * width), least significant limb first
+ */
+vector<limb_t> IntBatch::to_fixed(const Int &a_value) const
+{
+    vector<limb_t> result(this->limb_width, 0);
+    size_t len = std::min(a_value.limbs.size(), this->limb_width);
+    std::copy(a_value.limbs.begin(), a_value.limbs.begin() + len, result.begin());
+    if (!a_value.is_positive)
+    {
+        limb_t carry = 1;
+        for (limb_t &limb : result)
+        {
+            limb = ~limb + carry;
+            carry = (carry && limb == 0) ? 1 : 0;
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Read an element.
+ *
+ * @param a_index The index of the element
+ * @return The element as an Int
+ * @throw out_of_range if the index is past the end
+ */
+Int IntBatch::get(size_t a_index) const
+{
+    if (a_index >= this->count)
+    {
+        throw out_of_range("IntBatch index " + to_string(a_index) + " is out of range");
+    }
+    vector<limb_t> limbs(this->limb_width);
+    for (size_t j = 0; j < this->limb_width; j++)
+    {
+        limbs[j] = this->row(j)[a_index];
+    }
+    bool is_negative = limbs.back() >> (LIMB_BITS - 1);
+    if (is_negative)
+    {
+        limb_t carry = 1;
+        for (limb_t &limb : limbs)
+        {
+            limb = ~limb + carry;
+            carry = (carry && limb == 0) ? 1 : 0;
+        }
+    }
+    return Int::from_limbs(!is_negative, limbs);
+}
+
+/**
+ * @brief Write an element.
+ *
+ * @param a_index The index of the element
+ * @param a_value The value, in [-2^(64 * width - 1), 2^(64 * width - 1))
+ * @throw out_of_range if the index is past the end or the value does not fit
+ */
+void IntBatch::set(size_t a_index, const Int &a_value)
+{
+    if (a_index >= this->count)
+    {
+        throw out_of_range("IntBatch index " + to_string(a_index) + " is out of range");
+    }
+    size_t len = a_value.limbs.size();
+    bool fits = len < this->limb_width;
+    if (len == this->limb_width)
+    {
+        limb_t top = a_value.limbs[len - 1];
+        const limb_t sign_bit = (limb_t)1 << (LIMB_BITS - 1);
+        // The most negative value is the only one whose magnitude has the sign bit set.
+        fits = !(top & sign_bit) ||
+               (!a_value.is_positive && top == sign_bit &&
+                std::all_of(a_value.limbs.begin(), a_value.limbs.begin() + (len - 1), [](limb_t l)
+                            { return l == 0; }));
+    }
+    if (!fits)
+    {
+        throw out_of_range("Integer does not fit in " + to_string(this->limb_width) + " limbs");
+    }
+    vector<limb_t> limbs = this->to_fixed(a_value);
+    for (size_t j = 0; j < this->limb_width; j++)
+    {
+        this->row(j)[a_index] = limbs[j];
+    }
+}
+
+/**
+ * @brief Convert every element.
+ *
+ * @return The elements as Ints, in order
+ */
+vector<Int> IntBatch::to_ints() const
+{
+    vector<Int> result;
+    result.reserve(this->count);
+    for (size_t i = 0; i < this->count; i++)
+    {
+        result.push_back(this->get(i));
+    }
+    return result;
+}
+
+/**
+ * @brief Private method. Check that another batch has the same size and width as this one.
+ *
+ * @param a_that The other batch
+ * @throw domain_error if the shapes differ
+ */
+void IntBatch::check_shape(const IntBatch &a_that) const
+{
+    if (this->count != a_that.count || this->limb_width != a_that.limb_width)
+    {
+        throw domain_error("IntBatch operands must have the same size and width");
+    }
+}
+
+/**
+ * @brief Private method. Add or subtract elementwise in place, a block of lanes at a time, running the
+ *      lane kernels up the rows with the carries of the block kept on the stack.
+ *
+ * @param a_batch The other operand, or nullptr to use a_scalar for every element
+ * @param a_scalar The scalar operand in two's complement, used when a_batch is nullptr
+ * @param a_is_sub If the operand is subtracted rather than added
+ */
+void IntBatch::add_sub(const IntBatch *a_batch, const vector<limb_t> &a_scalar, bool a_is_sub)
+{
+    auto lanes = a_is_sub ? limb_kernels.sub_lanes : limb_kernels.add_lanes;
+    limb_t carry[BATCH_BLOCK];
+    limb_t broadcast[BATCH_BLOCK];
+    for (size_t start = 0; start < this->count; start += BATCH_BLOCK)
+    {
+        size_t n = std::min(BATCH_BLOCK, this->count - start);
+        std::fill(carry, carry + n, 0);
+        for (size_t j = 0; j < this->limb_width; j++)
+        {
+            const limb_t *opr_2 = broadcast;
+            if (a_batch)
+            {
+                opr_2 = a_batch->row(j) + start;
+            }
+            else
+            {
+                std::fill(broadcast, broadcast + n, a_scalar[j]);
+            }
+            limb_t *r = this->row(j) + start;
+            lanes(r, r, opr_2, carry, n);
+        }
+    }
+}
+
+/**
+ * @brief Private method. Multiply elementwise in place, keeping the low width limbs of each product.
+ *      Each block scans the product column by column with a three-limb accumulator per lane. The
+ *      64 x 64 -> 128-bit multiplies have no vector form on x86-64, so this loop is scalar; the layout
+ *      still keeps every load sequential.
+ *
+ * @param a_batch The other operand, or nullptr to use a_scalar for every element
+ * @param a_scalar The scalar operand in two's complement, used when a_batch is nullptr
+ */
+void IntBatch::mul(const IntBatch *a_batch, const vector<limb_t> &a_scalar)
+{
+    vector<limb_t> result(this->data.size());
+    limb_t acc_0[BATCH_BLOCK];
+    limb_t acc_1[BATCH_BLOCK];
+    limb_t acc_2[BATCH_BLOCK];
+    for (size_t start = 0; start < this->count; start += BATCH_BLOCK)
+    {
+        size_t n = std::min(BATCH_BLOCK, this->count - start);
+        std::fill(acc_0, acc_0 + n, 0);
+        std::fill(acc_1, acc_1 + n, 0);
+        std::fill(acc_2, acc_2 + n, 0);
+        for (size_t k = 0; k < this->limb_width; k++)
+        {
+            for (size_t i = 0; i <= k; i++)
+            {
+                const limb_t *opr_1 = this->row(i) + start;
+                if (a_batch)
+                {
+                    const limb_t *opr_2 = a_batch->row(k - i) + start;
+                    for (size_t l = 0; l < n; l++)
+                    {
+                        dlimb_t prod = (dlimb_t)opr_1[l] * opr_2[l];
+                        dlimb_t low = (dlimb_t)acc_0[l] + (limb_t)prod;
+                        dlimb_t high = (dlimb_t)acc_1[l] + (limb_t)(prod >> LIMB_BITS) + (limb_t)(low >> LIMB_BITS);
+                        acc_0[l] = (limb_t)low;
+                        acc_1[l] = (limb_t)high;
+                        acc_2[l] += (limb_t)(high >> LIMB_BITS);
+                    }
+                }
+                else
+                {
+                    limb_t opr_2 = a_scalar[k - i];
+                    for (size_t l = 0; l < n; l++)
+                    {
+                        dlimb_t prod = (dlimb_t)opr_1[l] * opr_2;
+                        dlimb_t low = (dlimb_t)acc_0[l] + (limb_t)prod;
+                        dlimb_t high = (dlimb_t)acc_1[l] + (limb_t)(prod >> LIMB_BITS) + (limb_t)(low >> LIMB_BITS);
+                        acc_0[l] = (limb_t)low;
+                        acc_1[l] = (limb_t)high;
+                        acc_2[l] += (limb_t)(high >> LIMB_BITS);
+                    }
+                }
+            }
+            limb_t *r = result.data() + k * this->count + start;
+            for (size_t l = 0; l < n; l++)
+            {
+                r[l] = acc_0[l];
+                acc_0[l] = acc_1[l];
+                acc_1[l] = acc_2[l];
+                acc_2[l] = 0;
+            }
+        }
+    }
+    this->data.swap(result);
+}
+
+/**
+ * @brief Add elementwise, modulo 2^(64 * width).
+ *
+ * @param a_that The other batch, of the same size and width
+ * @return The sums
+ * @throw domain_error if the shapes differ
+ */
+IntBatch IntBatch::operator+(const IntBatch &a_that) const
+{
+    IntBatch result = *this;
+    return result += a_that;
+}
+
+/**
+ * @brief Add elementwise in place, modulo 2^(64 * width).
+ *
+ * @param a_that The other batch, of the same size and width
+ * @return This batch
+ * @throw domain_error if the shapes differ
+ */
+IntBatch &IntBatch::operator+=(const IntBatch &a_that)
+{
+    this->check_shape(a_that);
+    this->add_sub(&a_that, {}, false);
+    return *this;
+}
+
+/**
+ * @brief Subtract elementwise, modulo 2^(64 * width).
+ *
+ * @param a_that The other batch, of the same size and width
+ * @return The differences
+ * @throw domain_error if the shapes differ
+ */
+IntBatch IntBatch::operator-(const IntBatch &a_that) const
+{
+    IntBatch result = *this;
+    return result -= a_that;
+}
+
+/**
+ * @brief Subtract elementwise in place, modulo 2^(64 * width).
+ *
+ * @param a_that The other batch, of the same size and width
+ * @return This batch
+ * @throw domain_error if the shapes differ
  */
-Int::Int(const string &a_in)
+IntBatch &IntBatch::operator-=(const IntBatch &a_that)
 {
-    this->is_positive = a_in[0] != '-';
-    string body = a_in.substr(this->is_positive ? 0 : 1);
-    body.erase(0, body.find_first_not_of('0'));
-    consume_str_to_bools(body);
-};
+    this->check_shape(a_that);
+    this->add_sub(&a_that, {}, true);
+    return *this;
+}
 
 /**
- * @brief Copy constructor.
+ * @brief Multiply elementwise, modulo 2^(64 * width).
  *
- * @param a_int another instance of Int
+ * @param a_that The other batch, of the same size and width
+ * @return The products
+ * @throw domain_error if the shapes differ
  */
-Int::Int(const Int &a_int)
+IntBatch IntBatch::operator*(const IntBatch &a_that) const
 {
-    this->is_positive = a_int.is_positive;
-    this->bools = a_int.bools;
-};
+    IntBatch result = *this;
+    return result *= a_that;
+}
 
 /**
- * @brief Constructor from attributes.
+ * @brief Multiply elementwise in place, modulo 2^(64 * width).
  *
- * @param a_in attributes of Int to construct from
+ * @param a_that The other batch, of the same size and width, which may be this batch
+ * @return This batch
+ * @throw domain_error if the shapes differ
  */
-Int::Int(const bool &a_is_positive, const vector<bool> &a_bools)
+IntBatch &IntBatch::operator*=(const IntBatch &a_that)
 {
-    this->is_positive = a_is_positive;
-    this->bools = a_bools;
-};
+    this->check_shape(a_that);
+    this->mul(&a_that, {});
+    return *this;
+}
+
+/**
+ * @brief Add a scalar to every element, modulo 2^(64 * width).
+ *
+ * @param a_that The scalar, of any size
+ * @return The sums
+ */
+IntBatch IntBatch::operator+(const Int &a_that) const
+{
+    IntBatch result = *this;
+    return result += a_that;
+}
+
+/**
+ * @brief Add a scalar to every element in place, modulo 2^(64 * width).
+ *
+ * @param a_that The scalar, of any size
+ * @return This batch
+ */
+IntBatch &IntBatch::operator+=(const Int &a_that)
+{
+    this->add_sub(nullptr, this->to_fixed(a_that), false);
+    return *this;
+}
 
 /**
- * @brief Private method. Take a string, analuze it, then load the result into the
- *      bool field of this object.
+ * @brief Subtract a scalar from every element, modulo 2^(64 * width).
  *
- * @param a_dvd the string to be read
- * @throw domain_error if the input contains non-digit characters.
+ * @param a_that The scalar, of any size
+ * @return The differences
  */
-void Int::consume_str_to_bools(const string &a_dvd)
+IntBatch IntBatch::operator-(const Int &a_that) const
 {
-    if (a_dvd.length() == 0)
+    IntBatch result = *this;
+    return result -= a_that;
+}
+
+/**
+ * @brief Subtract a scalar from every element in place, modulo 2^(64 * width).
+ *
+ * @param a_that The scalar, of any size
+ * @return This batch
+ */
+IntBatch &IntBatch::operator-=(const Int &a_that)
+{
+    this->add_sub(nullptr, this->to_fixed(a_that), true);
+    return *this;
+}
+
+/**
+ * @brief Multiply every element by a scalar, modulo 2^(64 * width).
+ *
+ * @param a_that The scalar, of any size
+ * @return The products
+ */
+IntBatch IntBatch::operator*(const Int &a_that) const
+{
+    IntBatch result = *this;
+    return result *= a_that;
+}
+
+/**
+ * @brief Multiply every element by a scalar in place, modulo 2^(64 * width).
+ *
+ * @param a_that The scalar, of any size
+ * @return This batch
+ */
+IntBatch &IntBatch::operator*=(const Int &a_that)
+{
+    this->mul(nullptr, this->to_fixed(a_that));
+    return *this;
+}
+
+/**
+ * @brief Compare two batches elementwise as signed integers.
+ *
+ * @param a_opr_1 The first batch
+ * @param a_opr_2 The second batch, of the same size and width
+ * @return For each element, -1, 0 or 1 as the first is less than, equal to or greater than the second
+ * @throw domain_error if the shapes differ
+ */
+vector<int8_t> compare(const IntBatch &a_opr_1, const IntBatch &a_opr_2)
+{
+    if (a_opr_1.size() != a_opr_2.size() || a_opr_1.width() != a_opr_2.width())
     {
-        bools.push_back((bool)0);
-        return;
+        throw domain_error("IntBatch operands must have the same size and width");
+    }
+    vector<int8_t> result(a_opr_1.size());
+    int64_t order[BATCH_BLOCK];
+    for (size_t start = 0; start < a_opr_1.size(); start += BATCH_BLOCK)
+    {
+        size_t n = std::min(BATCH_BLOCK, a_opr_1.size() - start);
+        std::fill(order, order + n, 0);
+        for (size_t j = a_opr_1.width(); j-- > 0;)
+        {
+            limb_kernels.cmp_lanes(order, a_opr_1.row(j) + start, a_opr_2.row(j) + start, n,
+                                   j + 1 == a_opr_1.width());
+        }
+        std::copy(order, order + n, result.begin() + start);
     }
+    return result;
+}
 
-    string dvd = a_dvd;
-    while (true)
+/**
+ * @brief Add up every element of a batch exactly, without wrapping. Each row is summed into 128 bits,
+ *      then the rows are combined and 2^(64 * width) is taken off for each negative element.
+ *
+ * @param a_batch The batch
+ * @return The sum of its elements
+ */
+Int sum(const IntBatch &a_batch)
+{
+    size_t width = a_batch.width();
+    vector<limb_t> total(width + 2, 0);
+    for (size_t j = 0; j < width; j++)
     {
-        bool carry = false;
-        for (char &chr : dvd)
+        const limb_t *row = a_batch.row(j);
+        dlimb_t row_sum = 0;
+        for (size_t i = 0; i < a_batch.size(); i++)
         {
-            if (chr == 0)
-                break;
-            int8_t digit = char_to_int(chr);
-            bool carry_old = carry;
-            carry = digit % 2 == 0 ? false : true;
-            // Mystery. Why is this happening?
-            int8_t divide_me = (int8_t)(digit + (carry_old ? 10 : 0));
-            chr = dig_to_char(divide_me / 2);
-        }
-        bools.push_back((bool)carry);
-        if (dvd[0] == '0')
-        {
-            dvd.erase(0, 1);
-            if (dvd.empty())
-                break;
+            row_sum += row[i];
+        }
+        limb_t carry = 0;
+        for (size_t k = j; k < total.size(); k++)
+        {
+            dlimb_t limb_sum = (dlimb_t)total[k] + (limb_t)row_sum + carry;
+            total[k] = (limb_t)limb_sum;
+            carry = (limb_t)(limb_sum >> LIMB_BITS);
+            row_sum >>= LIMB_BITS;
+        }
+    }
+    const limb_t *top = a_batch.row(width - 1);
+    vector<limb_t> negatives(width + 1, 0);
+    negatives[width] = std::count_if(top, top + a_batch.size(), [](limb_t l)
+                                     { return l >> (LIMB_BITS - 1); });
+    return Int::from_limbs(true, total) - Int::from_limbs(true, negatives);
+}
+
+/**
+ * @brief Multiply every element of a batch exactly, without wrapping, with a balanced product tree so
+ *      that the large products near the root can use the subquadratic algorithms.
+ *
+ * @param a_batch The batch
+ * @return The product of its elements, 1 for an empty batch
+ */
+Int product(const IntBatch &a_batch)
+{
+    vector<Int> level = a_batch.to_ints();
+    if (level.empty())
+    {
+        return Int::from_limbs(true, vector<limb_t>{1});
+    }
+    while (level.size() > 1)
+    {
+        size_t half = level.size() / 2;
+        for (size_t i = 0; i < half; i++)
+        {
+            level[i] = level[2 * i] * level[2 * i + 1];
         }
+        if (level.size() & 1)
+        {
+            level[half] = std::move(level.back());
+            half++;
+        }
+        level.erase(level.begin() + half, level.end());
     }
-    reverse(bools.begin(), bools.end());
+    return std::move(level[0]);
 }
 
+/**
+ * @brief The version of the binary format written by serialize and write_int_array.
+ */
+const uint8_t SERIAL_VERSION = 1;
+
+/**
+ * @brief The flag of a serialized Int that marks it negative.
+ */
+const uint8_t SERIAL_NEGATIVE = 1;
 
-ostream &operator<<(ostream &a_os, const Int &a_int)
+/**
+ * @brief The size of the header of a serialized Int: the version, the flags, six bytes of padding that
+ *      keep the limbs aligned, and the limb count as a 64-bit little-endian number.
+ */
+const size_t SERIAL_HEADER_BYTES = 16;
+
+/**
+ * @brief Write a 64-bit number in little-endian order.
+ *
+ * @param a_out The destination, 8 bytes
+ * @param a_value The number
+ */
+void store_le64(uint8_t *a_out, uint64_t a_value)
 {
-    a_os << a_int.to_str();
-    return a_os;
+    if constexpr (std::endian::native != std::endian::little)
+    {
+        a_value = __builtin_bswap64(a_value);
+    }
+    std::memcpy(a_out, &a_value, 8);
 }
 
-Int Int::operator=(const Int &a_opr_2)
+/**
+ * @brief Read a 64-bit number in little-endian order.
+ *
+ * @param a_in The source, 8 bytes
+ * @return The number
+ */
+uint64_t load_le64(const uint8_t *a_in)
 {
-    return Int(a_opr_2);
-};
+    uint64_t value;
+    std::memcpy(&value, a_in, 8);
+    if constexpr (std::endian::native != std::endian::little)
+    {
+        value = __builtin_bswap64(value);
+    }
+    return value;
+}
 
-Int Int::operator+(const Int &a_that) const
+/**
+ * @brief Write limbs in little-endian order.
+ *
+ * @param a_out The destination, 8 bytes per limb
+ * @param a_limbs The limbs
+ * @param a_len The number of limbs
+ */
+void store_limbs_le(uint8_t *a_out, const limb_t *a_limbs, size_t a_len)
 {
-    bool my_bools_is_bigger = is_the_first_bigger(this->bools, a_that.bools);
-    vector<bool> result_bools;
-    bool result_is_positive;
-    if (this->is_positive != a_that.is_positive)
+    if constexpr (std::endian::native == std::endian::little)
     {
-        result_bools = sub_bool_vectors(this->bools, a_that.bools);
-        result_is_positive = (my_bools_is_bigger) ? this->is_positive : a_that.is_positive;
+        std::copy_n((const uint8_t *)a_limbs, a_len * sizeof(limb_t), a_out);
     }
     else
     {
-        result_bools = add_bool_vectors(this->bools, a_that.bools);
-        result_is_positive = this->is_positive;
+        for (size_t i = 0; i < a_len; i++)
+        {
+            store_le64(a_out + 8 * i, a_limbs[i]);
+        }
     }
-    return Int(result_is_positive, result_bools);
 }
 
-void Int::operator+=(const Int &a_that)
+/**
+ * @brief Write the header of a serialized integer.
+ *
+ * @param a_out The destination, SERIAL_HEADER_BYTES bytes
+ * @param a_value The integer
+ */
+void store_serial_header(uint8_t *a_out, const Int &a_value)
+{
+    a_out[0] = SERIAL_VERSION;
+    a_out[1] = (!a_value.is_positive && !a_value.limbs.empty()) ? SERIAL_NEGATIVE : 0;
+    std::fill_n(a_out + 2, 6, 0);
+    store_le64(a_out + 8, a_value.limbs.size());
+}
+
+/**
+ * @brief Write limbs to a stream in little-endian order.
+ *
+ * @param a_out The stream
+ * @param a_limbs The limbs
+ */
+void write_limbs_le(ostream &a_out, const LimbVector &a_limbs)
 {
-    bool my_bools_is_bigger = is_the_first_bigger(this->bools, a_that.bools);
-    vector<bool> result_bools;
-    bool result_is_positive;
-    if (this->is_positive != a_that.is_positive)
+    if constexpr (std::endian::native == std::endian::little)
     {
-        result_bools = sub_bool_vectors(this->bools, a_that.bools);
-        result_is_positive = (my_bools_is_bigger) ? this->is_positive : a_that.is_positive;
+        a_out.write((const char *)a_limbs.data(), a_limbs.size() * sizeof(limb_t));
     }
     else
     {
-        result_bools = add_bool_vectors(this->bools, a_that.bools);
-        result_is_positive = this->is_positive;
+        for (limb_t limb : a_limbs)
+        {
+            uint8_t bytes[8];
+            store_le64(bytes, limb);
+            a_out.write((const char *)bytes, 8);
+        }
     }
-    this->is_positive = result_is_positive;
-    this->bools = result_bools;
 }
 
-Int Int::operator-(const Int &a_that) const
+/**
+ * @brief Return the number of bytes serialize writes for an integer.
+ *
+ * @param a_value The integer
+ * @return The size of its serialized form
+ */
+size_t serialized_size(const Int &a_value)
 {
-    Int neg_that = a_that;
-    neg_that.is_positive = !neg_that.is_positive;
-    return (Int(*this) + neg_that);
+    return SERIAL_HEADER_BYTES + a_value.limbs.size() * sizeof(limb_t);
 }
 
-void Int::operator-=(const Int &a_that)
+/**
+ * @brief Serialize an integer into a buffer, as a 16-byte header (version, flags, padding and limb
+ *      count) followed by its limbs, least significant first, all little-endian.
+ *
+ * @param a_value The integer
+ * @param a_out The buffer, of at least serialized_size(a_value) bytes
+ * @return The number of bytes written
+ */
+size_t serialize(const Int &a_value, uint8_t *a_out)
 {
-    Int result = Int(*this) - a_that;
-    this->is_positive = result.is_positive;
-    this->bools = result.bools;
+    store_serial_header(a_out, a_value);
+    store_limbs_le(a_out + SERIAL_HEADER_BYTES, a_value.limbs.data(), a_value.limbs.size());
+    return serialized_size(a_value);
 }
 
-Int Int::operator*(const Int &a_that) const
+/**
+ * @brief Serialize an integer.
+ *
+ * @param a_value The integer
+ * @return Its serialized form
+ */
+vector<uint8_t> serialize(const Int &a_value)
 {
-    bool result_is_positive = (this->is_positive == a_that.is_positive);
-    vector<bool> result_bools = mul_bool_vectors(this->bools, a_that.bools);
-    return Int(result_is_positive, result_bools);
+    vector<uint8_t> result(serialized_size(a_value));
+    serialize(a_value, result.data());
+    return result;
 }
 
-void Int::operator*=(const Int &a_that)
+/**
+ * @brief Serialize an integer to a stream.
+ *
+ * @param a_value The integer
+ * @param a_out The stream, which should be opened in binary mode
+ */
+void serialize(const Int &a_value, ostream &a_out)
 {
-    Int result = Int(*this) * a_that;
-    this->is_positive = result.is_positive;
-    this->bools = result.bools;
+    uint8_t header[SERIAL_HEADER_BYTES];
+    store_serial_header(header, a_value);
+    a_out.write((const char *)header, SERIAL_HEADER_BYTES);
+    write_limbs_le(a_out, a_value.limbs);
 }
 
-Int Int::operator/(const Int &a_that) const
+/**
+ * @brief Check the header of a serialized integer.
+ *
+ * @param a_header The header, SERIAL_HEADER_BYTES bytes
+ * @return The number of limbs that follow
+ * @throw domain_error if the version or the flags are unknown
+ */
+uint64_t check_serial_header(const uint8_t *a_header)
 {
-    bool result_is_positive = (this->is_positive == a_that.is_positive);
-    vector<bool> result_bools = div_bool_vectors(this->bools, a_that.bools);
-    return Int(result_is_positive, result_bools);
+    if (a_header[0] != SERIAL_VERSION)
+    {
+        throw domain_error("Cannot deserialize integer: unknown version " + to_string(a_header[0]));
+    }
+    if (a_header[1] & ~SERIAL_NEGATIVE)
+    {
+        throw domain_error("Cannot deserialize integer: unknown flags " + to_string(a_header[1]));
+    }
+    return load_le64(a_header + 8);
 }
 
-void Int::operator/=(const Int &a_that)
+/**
+ * @brief Deserialize an integer from a buffer.
+ *
+ * @param a_in The buffer
+ * @param a_len The size of the buffer, which may hold more data after the integer
+ * @param a_consumed If not nullptr, receives the number of bytes read
+ * @return The integer
+ * @throw domain_error if the data is truncated or its version or flags are unknown
+ */
+Int deserialize(const uint8_t *a_in, size_t a_len, size_t *a_consumed = nullptr)
 {
-    Int result = Int(*this) / a_that;
-    this->is_positive = result.is_positive;
-    this->bools = result.bools;
+    if (a_len < SERIAL_HEADER_BYTES)
+    {
+        throw domain_error("Cannot deserialize integer: truncated header");
+    }
+    uint64_t len = check_serial_header(a_in);
+    if (len > (a_len - SERIAL_HEADER_BYTES) / sizeof(limb_t))
+    {
+        throw domain_error("Cannot deserialize integer: truncated limbs");
+    }
+    LimbVector limbs;
+    limbs.resize(len);
+    const uint8_t *in = a_in + SERIAL_HEADER_BYTES;
+    for (size_t i = 0; i < len; i++)
+    {
+        limbs[i] = load_le64(in + 8 * i);
+    }
+    if (a_consumed)
+    {
+        *a_consumed = SERIAL_HEADER_BYTES + len * sizeof(limb_t);
+    }
+    return Int::from_limbs(!(a_in[1] & SERIAL_NEGATIVE), std::move(limbs));
 }
 
-bool Int::operator==(const Int &a_that) const
+/**
+ * @brief Deserialize an integer from a buffer.
+ *
+ * @param a_in The buffer
+ * @return The integer
+ * @throw domain_error if the data is truncated or its version or flags are unknown
+ */
+Int deserialize(std::span<const uint8_t> a_in)
 {
-    if (is_zero_vector(this->bools) && is_zero_vector(a_that.bools)) return true;
-    return this->bools == a_that.bools && this->is_positive == a_that.is_positive;
+    return deserialize(a_in.data(), a_in.size());
 }
 
-bool Int::operator!=(const Int &a_that) const
+/**
+ * @brief Deserialize an integer from a stream.
+ *
+ * @param a_in The stream, which should be opened in binary mode
+ * @return The integer
+ * @throw domain_error if the data is truncated or its version or flags are unknown
+ */
+Int deserialize(std::istream &a_in)
 {
-    return !(Int(*this) == a_that);
+    uint8_t header[SERIAL_HEADER_BYTES];
+    if (!a_in.read((char *)header, SERIAL_HEADER_BYTES))
+    {
+        throw domain_error("Cannot deserialize integer: truncated header");
+    }
+    uint64_t len = check_serial_header(header);
+    LimbVector limbs;
+    // Read in bounded pieces, so that a corrupt count fails at the end of the stream rather than
+    // allocating it all up front.
+    const size_t piece = 1 << 16;
+    for (uint64_t done = 0; done < len;)
+    {
+        size_t n = (size_t)std::min<uint64_t>(piece, len - done);
+        limbs.resize(done + n);
+        if (!a_in.read((char *)(limbs.data() + done), n * sizeof(limb_t)))
+        {
+            throw domain_error("Cannot deserialize integer: truncated limbs");
+        }
+        if constexpr (std::endian::native != std::endian::little)
+        {
+            for (size_t i = done; i < done + n; i++)
+            {
+                limbs[i] = __builtin_bswap64(limbs[i]);
+            }
+        }
+        done += n;
+    }
+    return Int::from_limbs(!(header[1] & SERIAL_NEGATIVE), std::move(limbs));
 }
 
-bool Int::operator>(const Int &a_that) const
+/**
+ * @brief The magic number at the start of an integer array file.
+ */
+const char INT_ARRAY_MAGIC[8] = {'B', 'I', 'G', 'I', 'N', 'T', 'A', '\0'};
+
+/**
+ * @brief Write an array of integers to a file that MappedIntArray can map without parsing. The file is
+ *      the 8-byte magic, the version and the element count as 64-bit numbers, then
+ *      count + 1 limb offsets, one sign byte per element padded to 8 bytes, and the limbs of every
+ *      element back to back. Every number is little-endian and every section is 8-byte aligned.
+ *
+ * @param a_path The path of the file, which is replaced
+ * @param a_values The integers
+ * @throw std::system_error if the file cannot be written
+ */
+void write_int_array(const string &a_path, std::span<const Int> a_values)
 {
-    if (is_zero_vector(this->bools) && is_zero_vector(a_that.bools)) return false;
-    if (this->is_positive && !a_that.is_positive)
+    std::ofstream out(a_path, std::ios::binary | std::ios::trunc);
+    if (!out)
     {
-
-        return true;
+        throw std::system_error(errno, std::generic_category(), "Cannot open " + a_path);
     }
-    else if (!this->is_positive && a_that.is_positive)
+    uint8_t header[24] = {};
+    std::memcpy(header, INT_ARRAY_MAGIC, 8);
+    header[8] = SERIAL_VERSION;
+    store_le64(header + 16, a_values.size());
+    out.write((const char *)header, sizeof(header));
+    uint64_t offset = 0;
+    uint8_t word[8];
+    for (size_t i = 0; i <= a_values.size(); i++)
     {
-        return false;
+        store_le64(word, offset);
+        out.write((const char *)word, 8);
+        if (i < a_values.size())
+        {
+            offset += a_values[i].limbs.size();
+        }
+    }
+    string signs((a_values.size() + 7) / 8 * 8, '\0');
+    for (size_t i = 0; i < a_values.size(); i++)
+    {
+        signs[i] = (!a_values[i].is_positive && !a_values[i].limbs.empty()) ? SERIAL_NEGATIVE : 0;
+    }
+    out.write(signs.data(), signs.size());
+    for (const Int &value : a_values)
+    {
+        write_limbs_le(out, value.limbs);
+    }
+    if (!out.flush())
+    {
+        throw std::system_error(errno, std::generic_category(), "Cannot write " + a_path);
     }
-    return (!is_the_first_bigger(a_that.bools, this->bools));
 }
-bool Int::operator<(const Int &a_that) const
+
+/**
+ * @brief A read-only view of an integer stored elsewhere, such as in a mapped file. Its limbs can be
+ *      passed to the mpn functions directly.
+ */
+struct IntView
 {
-    return a_that > Int(*this);
-}
+    bool is_positive;
+    std::span<const limb_t> limbs;
 
-bool Int::operator>=(const Int &a_that) const
+    /**
+     * @brief Copy the viewed integer.
+     *
+     * @return The integer
+     */
+    Int to_int() const
+    {
+        LimbVector copy;
+        copy.assign(this->limbs.data(), this->limbs.data() + this->limbs.size());
+        return Int::from_limbs(this->is_positive, std::move(copy));
+    }
+};
+
+#if __has_include(<sys/mman.h>)
+/**
+ * @brief An integer array file written by write_int_array, mapped into memory. Opening it checks the
+ *      header only; elements are read in place as IntViews, which stay valid while the array is open.
+ *      Only little-endian hosts can map the limbs directly.
+ */
+class MappedIntArray
 {
-    return (Int(*this) > a_that || Int(*this) == a_that);
+public:
+    explicit MappedIntArray(const string &);
+    MappedIntArray(const MappedIntArray &) = delete;
+    MappedIntArray &operator=(const MappedIntArray &) = delete;
+    ~MappedIntArray();
+
+    size_t size() const { return this->count; }
+    IntView operator[](size_t) const;
+    Int get(size_t a_index) const { return (*this)[a_index].to_int(); }
+
+private:
+    void *map = nullptr;
+    size_t map_bytes = 0;
+    size_t count = 0;
+    size_t limb_count = 0;
+    const uint64_t *offsets = nullptr;
+    const uint8_t *signs = nullptr;
+    const limb_t *limbs = nullptr;
+};
+
+/**
+ * @brief Map an integer array file.
+ *
+ * @param a_path The path of the file
+ * @throw std::system_error if the file cannot be opened or mapped
+ * @throw domain_error if the file is not an integer array of a known version, or the host is big-endian
+ */
+MappedIntArray::MappedIntArray(const string &a_path)
+{
+    if constexpr (std::endian::native != std::endian::little)
+    {
+        throw domain_error("Integer array files can only be mapped on little-endian hosts");
+    }
+    int fd = open(a_path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        throw std::system_error(errno, std::generic_category(), "Cannot open " + a_path);
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0)
+    {
+        int error = errno;
+        close(fd);
+        throw std::system_error(error, std::generic_category(), "Cannot stat " + a_path);
+    }
+    this->map_bytes = info.st_size;
+    if (this->map_bytes > 0)
+    {
+        this->map = mmap(nullptr, this->map_bytes, PROT_READ, MAP_SHARED, fd, 0);
+    }
+    int error = errno;
+    close(fd);
+    if (this->map == MAP_FAILED || this->map == nullptr)
+    {
+        this->map = nullptr;
+        if (this->map_bytes > 0)
+        {
+            throw std::system_error(error, std::generic_category(), "Cannot map " + a_path);
+        }
+    }
+    const uint8_t *bytes = (const uint8_t *)this->map;
+    auto fail = [&](const string &a_what)
+    {
+        if (this->map)
+        {
+            munmap(this->map, this->map_bytes);
+        }
+        throw domain_error("Cannot read integer array " + a_path + ": " + a_what);
+    };
+    if (this->map_bytes < 24 || std::memcmp(bytes, INT_ARRAY_MAGIC, 8) != 0)
+    {
+        fail("bad magic number");
+    }
+    if (load_le64(bytes + 8) != SERIAL_VERSION)
+    {
+        fail("unknown version " + to_string(load_le64(bytes + 8)));
+    }
+    this->count = load_le64(bytes + 16);
+    size_t words = (this->map_bytes - 24) / 8;
+    if (this->count >= words || (this->count + 7) / 8 > words - this->count - 1)
+    {
+        fail("truncated offsets");
+    }
+    this->offsets = (const uint64_t *)(bytes + 24);
+    this->signs = (const uint8_t *)(this->offsets + this->count + 1);
+    this->limbs = (const limb_t *)(this->signs + (this->count + 7) / 8 * 8);
+    this->limb_count = words - (this->count + 1) - (this->count + 7) / 8;
 }
-bool Int::operator<=(const Int &a_that) const
+
+/**
+ * @brief Unmap the file.
+ */
+MappedIntArray::~MappedIntArray()
 {
-    return (Int(*this) < a_that || Int(*this) == a_that);
+    if (this->map)
+    {
+        munmap(this->map, this->map_bytes);
+    }
 }
 
-Int Int::operator-() const
+/**
+ * @brief View an element in place.
+ *
+ * @param a_index The index of the element
+ * @return A view of its sign and limbs inside the mapping
+ * @throw out_of_range if the index is past the end
+ * @throw domain_error if the offsets of the element point outside the file
+ */
+IntView MappedIntArray::operator[](size_t a_index) const
 {
-    Int result = Int(*this);
-    result.is_positive = !(result.is_positive);
-    return result;
-};
+    if (a_index >= this->count)
+    {
+        throw out_of_range("Integer array index " + to_string(a_index) + " is out of range");
+    }
+    uint64_t begin = this->offsets[a_index];
+    uint64_t end = this->offsets[a_index + 1];
+    if (begin > end || end > this->limb_count)
+    {
+        throw domain_error("Corrupt integer array: element " + to_string(a_index) + " is outside the file");
+    }
+    return {!(this->signs[a_index] & SERIAL_NEGATIVE), std::span<const limb_t>(this->limbs + begin, end - begin)};
+}
+#endif
@@ -18,12 +18,10 @@ int main()
             << ((int_a.to_str() == "990000009999990099999999") ? "matches" : "does not match")
             << " the original value.\n";
 
-    // Because of the algorithm to convert the internal boolean representation to strings,
-    //      which makes use of additions beyond int32_t, converting large numbers to decimal
-    //      strings is slow. I was able to find faster implementations, but could not
-    //      use them for this project, due to constraints.
+    // Converting to decimal strings splits the number by cached powers of ten, so large
+    //      numbers can be printed as well.
 
-    // Displaying the boolean representation takes much less time.
+    // The boolean representation can be displayed too.
     // Storing and manipulation of binary numbers are reasonably fast.
     Int int_b("9999999999999999999999999999999999999999999999999999999999999999999999999");
     cout << "The number 9999999999999999999999999999999999999999999999999999999999999999999999999 is stored as "
@@ -67,4 +65,4 @@ int main()
     cout << "Compare: " << int_e << ((int_e < int_f)? "<" : ">=") << int_f << "\n";
     cout << "Compare: " << int_h << ((int_h < int_g)? "<" : ">=") << int_g << "\n";
     cout << "Compare: " << int_i << ((int_i == int_j)? "==" : "!=") << int_j << "\n";
-}
\ No newline at end of file
+}
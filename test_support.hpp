@@ -0,0 +1,80 @@
+/**
+ * @file test_support.hpp
+ * @author Yiding Li
+ * @brief Allocation counting and operand making shared by tests.cpp and bench.cpp. Include it after
+ *      bigint.hpp, from one source file per program, since it replaces the global operator new and
+ *      operator delete.
+ * @version 0.1
+ * @date 2023-12-28
+ */
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <random>
+
+/**
+ * @brief Heap traffic since the program started, counted by the replacement operator new below, so that
+ *      tests can check which operations stay off the heap and the benchmark can report it. Atomic, as the
+ *      parallel tests allocate from the pool threads.
+ */
+std::atomic<size_t> g_allocs = 0;
+std::atomic<size_t> g_alloc_bytes = 0;
+
+/**
+ * @brief Allocate and count a block. The replacement operators below all come here, and release
+ *      through release_counted, so that the compiler does not pair std::free with a new expression.
+ */
+__attribute__((noinline)) void *allocate_counted(size_t a_size, size_t a_align)
+{
+    g_allocs.fetch_add(1, std::memory_order_relaxed);
+    g_alloc_bytes.fetch_add(a_size, std::memory_order_relaxed);
+    void *ptr = (a_align <= alignof(std::max_align_t))
+                    ? std::malloc(a_size ? a_size : 1)
+                    : std::aligned_alloc(a_align, (a_size + a_align - 1) / a_align * a_align);
+    if (!ptr)
+    {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+__attribute__((noinline)) void release_counted(void *a_ptr)
+{
+    std::free(a_ptr);
+}
+
+void *operator new(size_t a_size) { return allocate_counted(a_size, alignof(std::max_align_t)); }
+void *operator new[](size_t a_size) { return allocate_counted(a_size, alignof(std::max_align_t)); }
+void *operator new(size_t a_size, std::align_val_t a_align) { return allocate_counted(a_size, (size_t)a_align); }
+void *operator new[](size_t a_size, std::align_val_t a_align) { return allocate_counted(a_size, (size_t)a_align); }
+void operator delete(void *a_ptr) noexcept { release_counted(a_ptr); }
+void operator delete[](void *a_ptr) noexcept { release_counted(a_ptr); }
+void operator delete(void *a_ptr, size_t) noexcept { release_counted(a_ptr); }
+void operator delete[](void *a_ptr, size_t) noexcept { release_counted(a_ptr); }
+void operator delete(void *a_ptr, std::align_val_t) noexcept { release_counted(a_ptr); }
+void operator delete[](void *a_ptr, std::align_val_t) noexcept { release_counted(a_ptr); }
+void operator delete(void *a_ptr, size_t, std::align_val_t) noexcept { release_counted(a_ptr); }
+void operator delete[](void *a_ptr, size_t, std::align_val_t) noexcept { release_counted(a_ptr); }
+
+/**
+ * @brief Make an operand of exactly a_limbs limbs: random limbs, or all bits set, so that carries and
+ *      quotient corrections run the full length.
+ *
+ * @param a_rng The random number generator
+ * @param a_limbs The number of limbs, or 0 for zero
+ * @param a_ones Whether to set every bit instead
+ * @return The operand, not negative
+ */
+Int make_operand(std::mt19937_64 &a_rng, size_t a_limbs, bool a_ones = false)
+{
+    vector<limb_t> limbs(a_limbs);
+    for (limb_t &limb : limbs)
+    {
+        limb = a_ones ? ~(limb_t)0 : a_rng();
+    }
+    if (!limbs.empty())
+    {
+        limbs.back() |= (limb_t)1 << (LIMB_BITS - 1);
+    }
+    return Int::from_limbs(true, limbs);
+}
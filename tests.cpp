@@ -0,0 +1,1748 @@
+/**
+ * @file tests.cpp
+ * @author Yiding Li
+ * @brief Tests of Int against slower reference paths, with operand sizes on both sides of every algorithm
+ *      threshold. Prints each failed check and exits with status 1 if there was one.
+ * @version 0.1
+ * @date 2023-12-28
+ *
+ * Build with   g++ -std=c++20 -O2 tests.cpp -o tests
+ * Run as       ./tests
+ */
+#include "bigint.hpp"
+#include "test_support.hpp"
+#include <iomanip>
+#include <sstream>
+
+/**
+ * @brief The number of checks run and failed so far.
+ */
+size_t g_checks = 0;
+size_t g_failures = 0;
+
+/**
+ * @brief Record one check, printing a_what if it failed.
+ *
+ * @param a_ok Whether the check passed
+ * @param a_what A description of the check, with the operand sizes
+ */
+void check(bool a_ok, const string &a_what)
+{
+    g_checks++;
+    if (!a_ok)
+    {
+        g_failures++;
+        std::cerr << "FAILED: " << a_what << "\n";
+    }
+}
+
+/**
+ * @brief Make the sample values that round-trip and mixed-operation tests run over: zero, one, minus
+ *      one, 2^64, and for each length a random positive operand and a negative one with every bit set.
+ *
+ * @param a_rng The random number generator
+ * @param a_lengths The lengths, in limbs
+ * @return The values
+ */
+vector<Int> sample_values(std::mt19937_64 &a_rng, const vector<size_t> &a_lengths)
+{
+    vector<Int> values = {Int("0"), Int("1"), Int("-1"), Int("18446744073709551616")};
+    for (size_t len : a_lengths)
+    {
+        values.push_back(make_operand(a_rng, len));
+        values.push_back(-make_operand(a_rng, len, true));
+    }
+    return values;
+}
+
+/**
+ * @brief Check the limb arithmetic: carries and borrows across every limb, the bit vector conversions
+ *      against the limbs, and products and quotients against each other, with signs, over lengths from
+ *      one limb to a few dozen.
+ *
+ * @param a_rng The random number generator
+ */
+void test_limb_arithmetic(std::mt19937_64 &a_rng)
+{
+    const Int one("1");
+    for (size_t len : {1, 2, 3, 7, 20})
+    {
+        string at = " at " + to_string(len) + " limbs";
+        Int ones = make_operand(a_rng, len, true);
+        vector<limb_t> power_limbs(len + 1, 0);
+        power_limbs.back() = 1;
+        Int power = Int::from_limbs(true, power_limbs);
+        check(ones + one == power, "carry through all-ones" + at);
+        check(power - one == ones, "borrow through a power of two" + at);
+        check(Int(true, ones.to_bools()) == ones, "bit vector round trip" + at);
+
+        for (size_t len_2 : {1, 2, 5, 13})
+        {
+            string at_2 = " at " + to_string(len) + " and " + to_string(len_2) + " limbs";
+            Int a = make_operand(a_rng, len);
+            Int b = make_operand(a_rng, len_2);
+            check((a + b) - b == a, "a + b - b" + at_2);
+            check(a - b == -(b - a), "a - b against b - a" + at_2);
+            check(a * b == b * a, "a * b against b * a" + at_2);
+            check((a * b) / b == a, "a * b / b" + at_2);
+
+            Int quot = a / b;
+            Int rem = a - quot * b;
+            check(!(rem < Int("0")) && rem < b, "remainder of a / b in [0, b)" + at_2);
+            check(-a / b == -quot, "-a / b truncates toward zero" + at_2);
+            check(a / -b == -quot, "a / -b truncates toward zero" + at_2);
+
+            Int sum = a;
+            sum += b;
+            sum -= a;
+            check(sum == b, "a += b, -= a" + at_2);
+            Int prod = a;
+            prod *= b;
+            prod /= a;
+            check(prod == b, "a *= b, /= a" + at_2);
+        }
+    }
+}
+
+/**
+ * @brief Convert a magnitude to decimal the slow way, peeling off 19 digits at a time with a one-limb
+ *      division.
+ */
+string slow_digits(const Int &a_magnitude)
+{
+    const Int chunk_base("10000000000000000000");
+    Int rest = a_magnitude / chunk_base;
+    Int chunk = a_magnitude - rest * chunk_base;
+    string part = std::to_string(chunk.limbs.empty() ? 0 : chunk.limbs[0]);
+    if (rest == Int("0"))
+    {
+        return part;
+    }
+    return slow_digits(rest) + string(19 - part.size(), '0') + part;
+}
+
+/**
+ * @brief Convert an integer to decimal the slow way, with slow_digits.
+ */
+string slow_to_str(const Int &a_value)
+{
+    return a_value < Int("0") ? "-" + slow_digits(-a_value) : slow_digits(a_value);
+}
+
+/**
+ * @brief Convert to decimal with to_str, operator<< and write_decimal through small and large sinks, and
+ *      parse the digits back, for lengths on both sides of the schoolbook limit and long enough for
+ *      several levels of splits, and for powers of ten, whose remainders are all zero.
+ */
+void test_decimal_round_trip(std::mt19937_64 &a_rng)
+{
+    vector<Int> values = sample_values(a_rng, {1, 2, TO_STR_SCHOOLBOOK_LIMBS, TO_STR_SCHOOLBOOK_LIMBS + 1, 200});
+    vector<Int> powers = {Int("10000000000000000000")};
+    while (powers.size() < 8)
+    {
+        powers.push_back(powers.back() * powers.back());
+    }
+    for (const Int &power : powers)
+    {
+        values.push_back(power);
+        values.push_back(power - Int("1"));
+    }
+    for (const Int &value : values)
+    {
+        string what = std::to_string(value.limbs.size()) + " limbs";
+        string text = value.to_str();
+        check(text == slow_to_str(value), "to_str " + what);
+        check(Int(text) == value, "parse " + what);
+
+        std::ostringstream stream;
+        stream << value;
+        check(stream.str() == text, "operator<< " + what);
+        for (size_t capacity : vector<size_t>{1, 7, 4096})
+        {
+            string streamed;
+            DecimalSink sink([&streamed](const char *a_chars, size_t a_len) { streamed.append(a_chars, a_len); },
+                             capacity);
+            write_decimal(value, sink);
+            check(streamed == text, "write_decimal sink of " + std::to_string(capacity) + " " + what);
+        }
+    }
+    check(Int("-000123").to_str() == "-123" && Int("0").to_str() == "0", "parse leading zeros");
+
+    // Short values take a stack buffer and long ones the string or the sink; both honor the field width.
+    for (const Int &value : {Int("-42"), make_operand(a_rng, TO_STR_SCHOOLBOOK_LIMBS + 1)})
+    {
+        size_t width = value.to_str().size() + 3;
+        std::ostringstream stream;
+        stream << std::setw((int)width) << std::setfill('*') << value << value;
+        check(stream.str() == "***" + value.to_str() + value.to_str(), "operator<< with a field width");
+    }
+}
+
+/**
+ * @brief Check that malformed strings throw invalid_argument, and that strings of about
+ *      PARSE_SCHOOLBOOK_DIGITS digits, where parsing switches from chunks to divide and conquer, give the
+ *      same value as multiplying in one digit at a time.
+ */
+void test_parse(std::mt19937_64 &a_rng)
+{
+    for (const string &text : vector<string>{"", "-", "+", "+5", "--1", "-x", "12a4", " 12", "12 ", "1-2", "9\n"})
+    {
+        bool threw = false;
+        try
+        {
+            Int parsed(text);
+        }
+        catch (const invalid_argument &)
+        {
+            threw = true;
+        }
+        check(threw, "parsing \"" + text + "\" throws");
+    }
+
+    const Int zero("0");
+    const Int ten("10");
+    for (size_t len : vector<size_t>{PARSE_SCHOOLBOOK_DIGITS - 1, PARSE_SCHOOLBOOK_DIGITS,
+                                     PARSE_SCHOOLBOOK_DIGITS + 1, 2 * PARSE_SCHOOLBOOK_DIGITS + 1})
+    {
+        string digits(len, '0');
+        for (char &digit : digits)
+        {
+            digit = (char)('0' + a_rng() % 10);
+        }
+        digits[0] = '9';
+        Int expected("0");
+        Int power("1");
+        for (char digit : digits)
+        {
+            expected *= ten;
+            expected += Int(string(1, digit));
+            power *= ten;
+        }
+        string what = std::to_string(len) + " digits";
+        check(Int(digits) == expected, "parse " + what);
+        check(Int("-" + digits) == -expected, "parse negative " + what);
+        check(Int("000" + digits) == expected, "parse " + what + " after leading zeros");
+        check(Int(string(len, '9')) == power - Int("1"), "parse " + what + " of nines");
+    }
+    Int long_zero(string(PARSE_SCHOOLBOOK_DIGITS + 1, '0'));
+    Int negative_zero("-" + string(PARSE_SCHOOLBOOK_DIGITS + 1, '0'));
+    check(long_zero == zero && negative_zero == zero && negative_zero.is_positive, "parse long runs of zeros");
+}
+
+/**
+ * @brief Multiply with mul_thresholds set to a_karatsuba and a_toom3, restoring them afterwards.
+ */
+Int mul_with_thresholds(const Int &a_mnd, const Int &a_mer, size_t a_karatsuba, size_t a_toom3)
+{
+    MulThresholds saved = mul_thresholds;
+    mul_thresholds.karatsuba = a_karatsuba;
+    mul_thresholds.toom3 = a_toom3;
+    Int product = a_mnd * a_mer;
+    mul_thresholds = saved;
+    return product;
+}
+
+/**
+ * @brief Multiply with the default thresholds, and with Karatsuba or Toom-3 forced down to the smallest
+ *      operands, and compare with the schoolbook method, at operand lengths on both sides of the Karatsuba
+ *      and Toom-3 thresholds, balanced and unbalanced.
+ */
+void test_mul_tiers(std::mt19937_64 &a_rng)
+{
+    vector<size_t> lengths;
+    for (size_t threshold : {mul_thresholds.karatsuba, mul_thresholds.toom3})
+    {
+        lengths.insert(lengths.end(), {threshold - 1, threshold, threshold + 1});
+    }
+    for (size_t len_1 : lengths)
+    {
+        for (size_t len_2 : {len_1, len_1 / 2 + 1, len_1 + 7})
+        {
+            for (bool ones : {false, true})
+            {
+                Int a = make_operand(a_rng, len_1, ones);
+                Int b = make_operand(a_rng, len_2, ones);
+                Int expected = mul_with_thresholds(a, b, SIZE_MAX, SIZE_MAX);
+                string what = std::to_string(len_1) + "x" + std::to_string(len_2) + (ones ? " ones" : " random");
+                check(a * b == expected, "mul auto " + what);
+                check(mul_with_thresholds(a, b, 0, SIZE_MAX) == expected, "mul karatsuba " + what);
+                check(mul_with_thresholds(a, b, 0, 0) == expected, "mul toom3 " + what);
+                check(mul_with_thresholds(-a, b, 0, 0) == -expected, "mul toom3 negative " + what);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Multiply with number-theoretic transforms and compare with the schoolbook method, on both sides
+ *      of mul_thresholds.ntt and with the transforms forced on short and unbalanced operands.
+ */
+void test_mul_ntt(std::mt19937_64 &a_rng)
+{
+    size_t threshold = mul_thresholds.ntt;
+    vector<std::pair<size_t, size_t>> lengths = {
+        {threshold - 1, threshold - 1}, {threshold, threshold}, {threshold + 1, threshold + 1},
+        {2 * threshold + 3, threshold}, {1, 40}, {40, 40}, {300, 7}, {700, 650}};
+    for (auto [len_1, len_2] : lengths)
+    {
+        for (bool ones : {false, true})
+        {
+            Int a = make_operand(a_rng, len_1, ones);
+            Int b = make_operand(a_rng, len_2, ones);
+            Int expected = mul(a, b, MulAlgorithm::Schoolbook);
+            string what = std::to_string(len_1) + "x" + std::to_string(len_2) + (ones ? " ones" : " random");
+            check(a * b == expected, "mul auto " + what);
+            check(mul(a, b, MulAlgorithm::Ntt) == expected, "mul ntt " + what);
+        }
+    }
+}
+
+/**
+ * @brief Make an operand of exactly a_limbs limbs whose top limb is short: random lower limbs under a top
+ *      limb of at most 8 bits, or the power of two 2^(64 (a_limbs - 1)) itself. Divisors like these need
+ *      the longest normalization shift, unlike those of make_operand, whose top bit is always set.
+ *
+ * @param a_rng The random number generator
+ * @param a_limbs The number of limbs, at least 1
+ * @param a_power Whether to return the power of two instead
+ * @return The operand, positive
+ */
+Int make_short_top_operand(std::mt19937_64 &a_rng, size_t a_limbs, bool a_power = false)
+{
+    vector<limb_t> limbs(a_limbs);
+    for (limb_t &limb : limbs)
+    {
+        limb = a_power ? 0 : a_rng();
+    }
+    limbs.back() = a_power ? 1 : 1 + a_rng() % 255;
+    return Int::from_limbs(true, limbs);
+}
+
+/**
+ * @brief Make a divisor of a_limbs limbs of the given kind: "random", "short top" or "power" as above, or
+ *      "near power", just above a power of two, which under a dividend of all ones makes the quotient
+ *      estimates need the most corrections.
+ */
+Int make_divisor(std::mt19937_64 &a_rng, size_t a_limbs, const string &a_kind)
+{
+    if (a_kind == "near power")
+    {
+        vector<limb_t> limbs(a_limbs, 0);
+        limbs.front() = 1;
+        limbs.back() |= (limb_t)1 << (LIMB_BITS - 1);
+        return Int::from_limbs(true, limbs);
+    }
+    if (a_kind != "random")
+    {
+        return make_short_top_operand(a_rng, a_limbs, a_kind == "power");
+    }
+    return make_operand(a_rng, a_limbs);
+}
+
+/**
+ * @brief Check that q and r are the truncated quotient and remainder of a / b: a = q b + r, with r of
+ *      the sign of a and smaller than b in magnitude.
+ */
+bool is_trunc_divmod(const Int &a_dvd, const Int &a_dvs, const Int &a_q, const Int &a_r)
+{
+    const Int zero("0");
+    Int abs_r = a_r < zero ? -a_r : a_r;
+    Int abs_dvs = a_dvs < zero ? -a_dvs : a_dvs;
+    return a_q * a_dvs + a_r == a_dvd && abs_r < abs_dvs && (a_r == zero || (a_r < zero) == (a_dvd < zero));
+}
+
+/**
+ * @brief Divide with Burnikel-Ziegler division and compare with Algorithm D alone, with divisors and
+ *      quotients on both sides of div_thresholds.burnikel_ziegler and divisors whose top limb is full,
+ *      short or a power of two, then check the signs of both roundings.
+ */
+void test_div_tiers(std::mt19937_64 &a_rng)
+{
+    size_t threshold = div_thresholds.burnikel_ziegler;
+    for (size_t dvs_len : {threshold - 1, threshold, threshold + 1, 2 * threshold + 5})
+    {
+        for (size_t quot_len : {threshold - 1, threshold, threshold + 1, 3 * threshold})
+        {
+            for (const string &kind : vector<string>{"random", "near power", "short top", "power"})
+            {
+                Int b = make_divisor(a_rng, dvs_len, kind);
+                Int a = make_operand(a_rng, dvs_len + quot_len, kind == "near power");
+                string what = std::to_string(dvs_len + quot_len) + "/" + std::to_string(dvs_len) + " " + kind;
+
+                auto [q, r] = divmod(a, b);
+                check(is_trunc_divmod(a, b, q, r), "divmod " + what);
+                check(a / b == q && a % b == r, "operator/ and operator% " + what);
+                size_t saved = div_thresholds.burnikel_ziegler;
+                div_thresholds.burnikel_ziegler = SIZE_MAX;
+                auto [q_d, r_d] = divmod(a, b);
+                div_thresholds.burnikel_ziegler = saved;
+                check(q == q_d && r == r_d, "burnikel-ziegler against algorithm d " + what);
+            }
+        }
+    }
+
+    const Int zero("0");
+    for (size_t len : vector<size_t>{1, 2, 5, threshold + 3})
+    {
+        Int a = make_operand(a_rng, 2 * len + 1);
+        Int b = make_operand(a_rng, len);
+        for (int signs = 0; signs < 4; signs++)
+        {
+            Int dvd = (signs & 1) ? -a : a;
+            Int dvs = (signs & 2) ? -b : b;
+            string what = std::to_string(2 * len + 1) + "/" + std::to_string(len) + " signs " + std::to_string(signs);
+            auto [q, r] = divmod(dvd, dvs);
+            check(is_trunc_divmod(dvd, dvs, q, r), "divmod trunc " + what);
+            auto [q_f, r_f] = divmod(dvd, dvs, DivRounding::Floor);
+            Int abs_r_f = r_f < zero ? -r_f : r_f;
+            check(q_f * dvs + r_f == dvd && abs_r_f < b && (r_f == zero || (r_f < zero) == (dvs < zero)),
+                  "divmod floor " + what);
+        }
+    }
+
+    bool threw = false;
+    try
+    {
+        Int a = make_operand(a_rng, 3) / zero;
+    }
+    catch (const domain_error &)
+    {
+        threw = true;
+    }
+    check(threw, "division by zero throws");
+}
+
+/**
+ * @brief Raise an integer to a power modulo another the slow way, squaring and multiplying with operator*
+ *      and operator%, from the top bit of the exponent down.
+ */
+Int slow_powmod(const Int &a_base, const Int &a_exp, const Int &a_mod)
+{
+    const Int zero("0");
+    Int mod = a_mod < zero ? -a_mod : a_mod;
+    Int base = a_base % mod;
+    if (base < zero)
+    {
+        base += mod;
+    }
+    Int result = Int("1") % mod;
+    for (size_t i = a_exp.limbs.size(); i-- > 0;)
+    {
+        for (int bit = LIMB_BITS - 1; bit >= 0; bit--)
+        {
+            result *= result;
+            result %= mod;
+            if ((a_exp.limbs[i] >> bit) & 1)
+            {
+                result *= base;
+                result %= mod;
+            }
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Compare pow with repeated multiplication, and powmod, with Montgomery multiplication for odd
+ *      moduli and Barrett reduction for even ones, and powmod_ct with the slow square-and-multiply, for
+ *      negative bases and short and long exponents and moduli.
+ */
+void test_powmod(std::mt19937_64 &a_rng)
+{
+    for (size_t len : vector<size_t>{1, 3})
+    {
+        Int base = make_operand(a_rng, len);
+        Int expected("1");
+        for (uint64_t exp = 0; exp <= 40; exp++)
+        {
+            check(pow(base, exp) == expected && pow(-base, exp) == (exp % 2 ? -expected : expected),
+                  "pow " + std::to_string(len) + "-limb base ^ " + std::to_string(exp));
+            expected *= base;
+        }
+    }
+
+    for (size_t mod_len : vector<size_t>{1, 2, 8, 79, 80, 81})
+    {
+        for (bool odd : {true, false})
+        {
+            Int mod = make_operand(a_rng, mod_len);
+            mod.limbs[0] = odd ? (mod.limbs[0] | 1) : (mod.limbs[0] & ~(limb_t)1);
+            for (size_t exp_len : vector<size_t>{0, 1, 3})
+            {
+                Int base = make_operand(a_rng, mod_len + 1);
+                Int exp = make_operand(a_rng, exp_len);
+                string what = std::to_string(mod_len) + "-limb " + (odd ? "odd" : "even") + " modulus, " +
+                              std::to_string(exp_len) + "-limb exponent";
+                Int expected = slow_powmod(base, exp, mod);
+                check(powmod(base, exp, mod) == expected, "powmod " + what);
+                check(powmod(-base, exp, -mod) == slow_powmod(-base, exp, mod), "powmod negative " + what);
+                if (odd)
+                {
+                    check(powmod_ct(base, exp, mod) == expected, "powmod_ct " + what);
+                }
+            }
+        }
+    }
+    check(powmod(Int("7"), Int("5"), Int("1")) == Int("0"), "powmod modulo 1");
+    check(powmod(Int("0"), Int("0"), Int("10")) == Int("1"), "powmod 0 ^ 0");
+}
+
+/**
+ * @brief Check that a LimbVector keeps LIMB_VECTOR_INLINE limbs inside the object and moves to the heap
+ *      at one more, keeps its heap buffer when it shrinks while copies of the short value are inline
+ *      again, and that the word-sized Int operators do not allocate.
+ */
+void test_limb_vector(std::mt19937_64 &a_rng)
+{
+    LimbVector vec;
+    vector<limb_t> expected;
+    for (size_t i = 0; i < LIMB_VECTOR_INLINE; i++)
+    {
+        expected.push_back(a_rng());
+        vec.push_back(expected.back());
+    }
+    check(vec.is_inline() && vec.capacity() == LIMB_VECTOR_INLINE && vec.to_vector() == expected,
+          "limb vector is inline at " + std::to_string(LIMB_VECTOR_INLINE) + " limbs");
+    expected.push_back(a_rng());
+    vec.push_back(expected.back());
+    check(!vec.is_inline() && vec.capacity() > LIMB_VECTOR_INLINE && vec.to_vector() == expected,
+          "limb vector moves to the heap at " + std::to_string(LIMB_VECTOR_INLINE + 1) + " limbs");
+    const limb_t *buffer = vec.data();
+    size_t allocs = g_allocs;
+    vec.resize(2);
+    vec.push_back(7);
+    // Read the counter before check builds its message, which allocates.
+    bool no_alloc = g_allocs == allocs;
+    check(!vec.is_inline() && vec.data() == buffer && no_alloc && vec[0] == expected[0] && vec[1] == expected[1] &&
+              vec[2] == 7,
+          "limb vector keeps its heap buffer when it shrinks");
+    allocs = g_allocs;
+    LimbVector copy = vec;
+    no_alloc = g_allocs == allocs;
+    check(copy.is_inline() && copy == vec && no_alloc, "copy of a short limb vector is inline");
+    LimbVector full(expected);
+    check(!full.is_inline() && full.to_vector() == expected, "limb vector from five limbs is on the heap");
+
+    vector<limb_t> power_limbs(LIMB_VECTOR_INLINE + 1);
+    power_limbs.back() = 1;
+    // The difference reuses the heap buffer of the power of two, so copy it to get a fresh Int.
+    Int difference = Int::from_limbs(true, power_limbs) - Int("1");
+    Int inline_max = difference;
+    Int past = inline_max + Int("1");
+    check(inline_max.limbs.is_inline() && !past.limbs.is_inline(), "Int is inline up to four limbs");
+    past -= inline_max;
+    check(past == Int("1") && !past.limbs.is_inline() && Int(past).limbs.is_inline(),
+          "Int keeps its heap buffer when it shrinks, and its copy is inline");
+
+    // Word-sized operands, and the sums and products that still fit in the inline limbs.
+    Int a = make_operand(a_rng, 1);
+    Int b = Int::from_limbs(false, {a_rng() >> 3 | 1});
+    Int c = make_operand(a_rng, 2);
+    Int r = a;
+    bool flag = false;
+    auto word_ops = [&]()
+    {
+        Int sum = a + b;
+        Int diff = a - b;
+        Int product = a * b;
+        Int quotient = a / b;
+        Int remainder = a % b;
+        Int wide = c * a;
+        Int wide_quotient = c / b;
+        Int negated = -a;
+        Int copied = a;
+        r += b;
+        r -= c;
+        r *= b;
+        r /= a;
+        r %= b;
+        flag = (a < b) != (a != c);
+    };
+    // The first round warms the per-thread scratch buffers of division.
+    word_ops();
+    allocs = g_allocs;
+    word_ops();
+    no_alloc = g_allocs == allocs;
+    check(no_alloc, "word-sized operators do not allocate");
+    check(flag == ((a < b) != (a != c)), "word-sized comparison results");
+}
+
+/**
+ * @brief Check the compound operators with the operand as its own argument, the operators that reuse a
+ *      temporary operand and the unary minus of a temporary, against the same operations on copies.
+ */
+void test_aliasing(std::mt19937_64 &a_rng)
+{
+    const Int zero("0");
+    vector<Int> values = {zero, Int("1"), Int("-1"), Int("18446744073709551616")};
+    for (size_t len : {size_t(1), size_t(3), size_t(5), mul_thresholds.karatsuba + 3, mul_thresholds.toom3 + 3})
+    {
+        values.push_back(make_operand(a_rng, len));
+        values.push_back(-make_operand(a_rng, len, true));
+    }
+    for (const Int &x : values)
+    {
+        const Int copy = x;
+        string what = std::to_string(x.limbs.size()) + " limbs, " + (x.is_positive ? "positive" : "negative");
+        Int r = x;
+        r *= r;
+        check(r == x * copy, "x *= x of " + what);
+        r = x;
+        r += r;
+        check(r == x + copy, "x += x of " + what);
+        r = x;
+        r -= r;
+        check(r == zero && r.is_positive, "x -= x of " + what);
+        if (x != zero)
+        {
+            r = x;
+            r /= r;
+            check(r == Int("1"), "x /= x of " + what);
+            r = x;
+            r %= r;
+            check(r == zero && r.is_positive, "x %= x of " + what);
+        }
+
+        Int negated = zero - copy;
+        Int temporary = x;
+        check(-x == negated && x == copy, "unary minus of " + what + " leaves the operand");
+        check(-std::move(temporary) == negated, "unary minus of a temporary of " + what);
+        check(-Int(x) == negated && (-(x - copy)).is_positive, "unary minus of a computed " + what);
+
+        for (const Int &y : values)
+        {
+            const Int sum = x + y;
+            const Int diff = x - y;
+            string pair = what + " and " + std::to_string(y.limbs.size()) + " limbs";
+            check(Int(x) + y == sum && x + Int(y) == sum && Int(x) + Int(y) == sum, "rvalue + of " + pair);
+            check(Int(x) - y == diff && x - Int(y) == diff && Int(x) - Int(y) == diff, "rvalue - of " + pair);
+        }
+        Int zero_1 = Int(x) - copy;
+        Int zero_2 = x - Int(copy);
+        Int zero_3 = Int(x) + -copy;
+        check(zero_1 == zero && zero_2 == zero && zero_3 == zero && zero_1.is_positive && zero_2.is_positive &&
+                  zero_3.is_positive,
+              "rvalue x - x is positive zero for " + what);
+    }
+}
+
+/**
+ * @brief Evaluate lazy expressions, with the target among the operands of =, += and -= and without, and
+ *      compare with the same arithmetic on Int values, on both sides of mul_thresholds.karatsuba.
+ */
+void test_lazy(std::mt19937_64 &a_rng)
+{
+    size_t threshold = mul_thresholds.karatsuba;
+    for (size_t len : vector<size_t>{1, 3, threshold - 1, threshold + 1, 2 * threshold})
+    {
+        Int a = make_operand(a_rng, len);
+        Int b = -make_operand(a_rng, len + 1, true);
+        Int c = make_operand(a_rng, len / 2 + 1);
+        Int d = -make_operand(a_rng, len);
+        Int e = make_operand(a_rng, 2 * len);
+        string what = std::to_string(len) + " limbs";
+
+        Int built = lazy(a) * b + lazy(c) * d - e;
+        check(built == a * b + c * d - e, "lazy construction " + what);
+        Int assigned("5");
+        assigned = lazy(a) * b + lazy(c) * d - e;
+        check(assigned == a * b + c * d - e, "lazy assignment " + what);
+
+        Int y = a;
+        y = lazy(y) * y - lazy(y) * d;
+        check(y == a * a - a * d, "lazy assignment to an operand " + what);
+        Int z = c;
+        z += lazy(z) * d;
+        check(z == c + c * d, "lazy += of an operand " + what);
+        Int w = b;
+        w -= -(lazy(w) * e);
+        check(w == b + b * e, "lazy -= of an operand " + what);
+        Int acc = e;
+        acc += lazy(a) * b;
+        acc -= lazy(c) * d;
+        check(acc == e + a * b - c * d, "lazy multiply-accumulate " + what);
+    }
+}
+
+/**
+ * @brief A memory resource that forwards to operator new and counts the buffers it has out, so a test can
+ *      tell whether an Int still holds one of them.
+ */
+class CountingResource : public std::pmr::memory_resource
+{
+public:
+    size_t live = 0;
+    size_t total = 0;
+
+private:
+    void *do_allocate(size_t a_bytes, size_t a_align) override
+    {
+        live++;
+        total++;
+        return std::pmr::new_delete_resource()->allocate(a_bytes, a_align);
+    }
+    void do_deallocate(void *a_p, size_t a_bytes, size_t a_align) override
+    {
+        live--;
+        std::pmr::new_delete_resource()->deallocate(a_p, a_bytes, a_align);
+    }
+    bool do_is_equal(const std::pmr::memory_resource &a_that) const noexcept override { return this == &a_that; }
+};
+
+/**
+ * @brief Check IntArenaScope and the memory resource constructors: Ints made in a scope use its resource,
+ *      copies, moves and swaps with Ints from outside copy the limbs rather than take over a buffer from
+ *      another resource, and the values kept outside survive the end of the scope.
+ */
+void test_arena(std::mt19937_64 &a_rng)
+{
+    std::pmr::memory_resource *heap = std::pmr::new_delete_resource();
+    Int big_1 = make_operand(a_rng, 20);
+    Int big_2 = -make_operand(a_rng, 9);
+    Int small = make_operand(a_rng, 2);
+
+    CountingResource counting;
+    Int kept_copy("0");
+    Int kept_move("0");
+    Int kept_swap = big_2;
+    Int kept_small("0");
+    {
+        IntArenaScope scope(&counting);
+        check(scope.get_resource() == &counting && current_limb_resource() == &counting, "arena scope installed");
+        Int inner_1 = big_1;
+        Int inner_2 = big_1 * big_2;
+        Int inner_3 = big_2 - Int("1");
+        Int inner_4 = small;
+        check(inner_1.get_resource() == &counting && inner_2.get_resource() == &counting,
+              "Ints made in an arena scope use its resource");
+        check(counting.live >= 3, "arena scope resource holds the large Ints");
+
+        const limb_t *arena_buffer_2 = inner_2.limbs.data();
+        const limb_t *arena_buffer_3 = inner_3.limbs.data();
+        kept_copy = inner_1;
+        kept_move = std::move(inner_2);
+        std::swap(kept_swap, inner_3);
+        kept_small = std::move(inner_4);
+        check(kept_move.limbs.data() != arena_buffer_2 && kept_swap.limbs.data() != arena_buffer_3,
+              "move and swap across resources copy instead of taking the arena buffer");
+        check(kept_copy.get_resource() == heap && kept_move.get_resource() == heap &&
+                  kept_swap.get_resource() == heap && inner_3.get_resource() == &counting,
+              "assignment and swap keep each Int's resource");
+        check(inner_3 == big_2, "swap across resources gives the outside value to the arena Int");
+
+        Int stolen = std::move(inner_1);
+        check(stolen.get_resource() == &counting && inner_1 == Int("0"), "move construction takes the arena buffer");
+        {
+            IntArenaScope nested;
+            check(current_limb_resource() == nested.get_resource(), "nested arena scope installed");
+            Int in_nested = big_1 + big_1;
+            check(in_nested.get_resource() == nested.get_resource(), "Ints made in a nested scope use its arena");
+            kept_copy += in_nested - big_1 - big_1;
+        }
+        check(current_limb_resource() == &counting, "nested arena scope restores the outer resource");
+    }
+    check(current_limb_resource() == heap, "arena scope restores operator new");
+    check(counting.live == 0 && counting.total > 0, "no arena buffer outlives the scope");
+    check(kept_copy == big_1 && kept_move == big_1 * big_2 && kept_swap == big_2 - Int("1") && kept_small == small,
+          "values assigned out of an arena scope survive it");
+
+    {
+        IntArenaScope scope;
+        Int inner = big_1 * big_1;
+        kept_move = std::move(inner);
+        Int swapped = big_2 * big_2;
+        std::swap(kept_swap, swapped);
+    }
+    check(kept_move == big_1 * big_1 && kept_swap == big_2 * big_2, "values moved out of a monotonic arena survive it");
+
+    Int copy(big_1, &counting);
+    Int zero(&counting);
+    check(copy == big_1 && copy.get_resource() == &counting && counting.live == 1,
+          "copy constructor with a memory resource");
+    check(zero == Int("0") && zero.get_resource() == &counting && counting.live == 1,
+          "zero constructor with a memory resource");
+    zero = big_2;
+    Int moved(std::move(copy));
+    Int on_heap = big_1;
+    on_heap = std::move(moved);
+    check(zero == big_2 && on_heap == big_1 && counting.live == 2 && on_heap.get_resource() == heap,
+          "Ints with a memory resource copy into and out of it");
+    const limb_t *buffer = zero.limbs.data();
+    Int same(&counting);
+    same = std::move(zero);
+    check(same.limbs.data() == buffer && counting.live == 2, "move assignment on one resource takes the buffer");
+
+    // Once a first division has warmed the scratch arena and the per-thread buffers, q /= b and r %= b
+    // stay off the heap, with Algorithm D and with Burnikel-Ziegler division.
+    size_t threshold = div_thresholds.burnikel_ziegler;
+    for (size_t dvs_len : {threshold - 1, threshold, 2 * threshold})
+    {
+        Int a = make_operand(a_rng, 3 * dvs_len);
+        Int b = make_operand(a_rng, dvs_len);
+        Int q = a;
+        Int r = a;
+        q /= b;
+        r %= b;
+        q = a;
+        r = a;
+        size_t allocs = g_allocs;
+        q /= b;
+        r %= b;
+        bool no_alloc = g_allocs == allocs;
+        check(no_alloc && q == a / b && r == a % b,
+              "warm " + std::to_string(3 * dvs_len) + "/" + std::to_string(dvs_len) + " /= and %= do not allocate");
+    }
+}
+
+/**
+ * @brief Flip the lowest bit of limb a_index of a positive integer, whose top limb stays nonzero.
+ */
+Int flip_bit(const Int &a_value, size_t a_index)
+{
+    vector<limb_t> limbs(a_value.limbs.begin(), a_value.limbs.end());
+    limbs[a_index] ^= 1;
+    return Int::from_limbs(true, limbs);
+}
+
+/**
+ * @brief Run addition, subtraction and comparison on the kernels selected for this processor and on the
+ *      generic ones, through Int, the mpn spans and the lane kernels directly, with random operands, long
+ *      runs of all-ones limbs and operands that share all but one limb.
+ */
+void test_limb_kernels(std::mt19937_64 &a_rng)
+{
+    const LimbKernels selected = limb_kernels;
+    const Int one("1");
+    for (size_t len : vector<size_t>{1, 2, 3, 4, 5, 7, 8, 9, 16, 33, 100})
+    {
+        Int a = make_operand(a_rng, len);
+        Int ones = make_operand(a_rng, len, true);
+        vector<std::pair<Int, Int>> pairs = {{a, make_operand(a_rng, len)}, {ones, one}, {ones + one, one}, {a, a},
+                                             {a, flip_bit(a, 0)}, {a, flip_bit(a, len / 2)}, {ones, flip_bit(ones, 0)}};
+        for (const auto &[x, y] : pairs)
+        {
+            string what = std::to_string(len) + " limbs, " + x.to_str() + " and " + y.to_str();
+            limb_kernels = selected;
+            Int sum = x + y;
+            Int diff = x - y;
+            Int back = y - x;
+            bool less = x < y;
+            bool greater = x > y;
+            bool equal = x == y;
+            limb_kernels = GENERIC_LIMB_KERNELS;
+            check(x + y == sum && x - y == diff && y - x == back, string(selected.name) + " add and sub " + what);
+            check((x < y) == less && (x > y) == greater && (x == y) == equal,
+                  string(selected.name) + " compare " + what);
+
+            // The mpn kernels take operands of one length, so the shorter one is padded.
+            vector<limb_t> opr_1(x.limbs.begin(), x.limbs.end());
+            vector<limb_t> opr_2(y.limbs.begin(), y.limbs.end());
+            opr_2.resize(opr_1.size());
+            vector<limb_t> out_selected(opr_1.size());
+            vector<limb_t> out_generic(opr_1.size());
+            for (bool is_sub : {false, true})
+            {
+                auto run = [&](vector<limb_t> &a_out)
+                {
+                    return is_sub ? mpn::sub_n(a_out, opr_1, opr_2) : mpn::add_n(a_out, opr_1, opr_2);
+                };
+                limb_kernels = selected;
+                limb_t carry_selected = run(out_selected);
+                limb_kernels = GENERIC_LIMB_KERNELS;
+                limb_t carry_generic = run(out_generic);
+                check(out_selected == out_generic && carry_selected == carry_generic,
+                      string(selected.name) + (is_sub ? " mpn::sub_n " : " mpn::add_n ") + what);
+            }
+            limb_kernels = selected;
+            int cmp_selected = mpn::cmp_n(opr_1, opr_2);
+            limb_kernels = GENERIC_LIMB_KERNELS;
+            check(cmp_selected == mpn::cmp_n(opr_1, opr_2), string(selected.name) + " mpn::cmp_n " + what);
+        }
+    }
+    limb_kernels = selected;
+
+    // The lane kernels work on one limb of many integers at a time, with a carry or an order per lane.
+    for (size_t lanes : vector<size_t>{1, 3, 4, 5, 8, 17})
+    {
+        vector<limb_t> opr_1(lanes);
+        vector<limb_t> opr_2(lanes);
+        vector<limb_t> carry(lanes);
+        vector<int64_t> order(lanes);
+        for (size_t i = 0; i < lanes; i++)
+        {
+            opr_1[i] = (i % 3 == 0) ? ~(limb_t)0 : a_rng();
+            opr_2[i] = (i % 4 == 1) ? opr_1[i] : a_rng() >> (i % 2) * 63;
+            carry[i] = a_rng() & 1;
+            order[i] = (int64_t)(a_rng() % 3) - 1;
+        }
+        string what = std::to_string(lanes) + " lanes";
+        for (bool is_sub : {false, true})
+        {
+            vector<limb_t> out_selected(lanes);
+            vector<limb_t> out_generic(lanes);
+            vector<limb_t> carry_selected = carry;
+            vector<limb_t> carry_generic = carry;
+            (is_sub ? selected.sub_lanes : selected.add_lanes)(out_selected.data(), opr_1.data(), opr_2.data(),
+                                                              carry_selected.data(), lanes);
+            (is_sub ? GENERIC_LIMB_KERNELS.sub_lanes : GENERIC_LIMB_KERNELS.add_lanes)(
+                out_generic.data(), opr_1.data(), opr_2.data(), carry_generic.data(), lanes);
+            check(out_selected == out_generic && carry_selected == carry_generic,
+                  string(selected.name) + (is_sub ? " sub_lanes " : " add_lanes ") + what);
+        }
+        for (bool is_signed : {false, true})
+        {
+            vector<int64_t> order_selected = order;
+            vector<int64_t> order_generic = order;
+            selected.cmp_lanes(order_selected.data(), opr_1.data(), opr_2.data(), lanes, is_signed);
+            GENERIC_LIMB_KERNELS.cmp_lanes(order_generic.data(), opr_1.data(), opr_2.data(), lanes, is_signed);
+            check(order_selected == order_generic, string(selected.name) + " cmp_lanes " + what);
+        }
+    }
+}
+
+/**
+ * @brief Multiply, convert to decimal and parse on a thread pool, with the parallel thresholds lowered so
+ *      that the split paths run on short operands, and compare with the serial results.
+ */
+void test_parallel(std::mt19937_64 &a_rng)
+{
+    vector<std::pair<Int, Int>> operands;
+    for (size_t len : vector<size_t>{100, 300, 1200})
+    {
+        operands.emplace_back(make_operand(a_rng, len), make_operand(a_rng, len, true));
+    }
+    vector<Int> products;
+    vector<Int> ntt_products;
+    vector<string> texts;
+    for (const auto &[a, b] : operands)
+    {
+        products.push_back(a * b);
+        ntt_products.push_back(mul(a, b, MulAlgorithm::Ntt));
+        texts.push_back(products.back().to_str());
+    }
+
+    ThreadPool pool(3);
+    ParallelSettings saved = parallel_settings;
+    parallel_settings = ParallelSettings{&pool, 64, (size_t)1 << 8, 64, 1000};
+    for (size_t i = 0; i < operands.size(); i++)
+    {
+        const auto &[a, b] = operands[i];
+        string what = std::to_string(a.limbs.size()) + " limbs";
+        check(a * b == products[i], "parallel mul " + what);
+        check(mul(a, b, MulAlgorithm::Ntt) == ntt_products[i], "parallel ntt " + what);
+        check(products[i].to_str() == texts[i], "parallel to_str " + what);
+        check(Int(texts[i]) == products[i], "parallel parse " + what);
+    }
+    parallel_settings = saved;
+}
+
+/**
+ * @brief Multiply and divide large operands inside the tasks of a thread pool that is also installed as
+ *      the kernels' pool, so that batches nest and the threads waiting on them are in the middle of
+ *      Int operations, and compare with the serial results.
+ */
+void test_parallel_nested(std::mt19937_64 &a_rng)
+{
+    vector<std::pair<Int, Int>> operands;
+    for (size_t i = 0; i < 64; i++)
+    {
+        operands.emplace_back(make_operand(a_rng, 300 + a_rng() % 2400), make_operand(a_rng, 300 + a_rng() % 2400));
+    }
+    vector<Int> products;
+    vector<Int> quotients;
+    vector<Int> remainders;
+    for (const auto &[a, b] : operands)
+    {
+        products.push_back(a * b);
+        quotients.push_back((products.back() + a) / b);
+        remainders.push_back((products.back() + a) % b);
+    }
+
+    ThreadPool pool(6);
+    ParallelSettings saved = parallel_settings;
+    parallel_settings.pool = &pool;
+    parallel_settings.mul = 64;
+    vector<Int> nested_products(operands.size(), Int("0"));
+    vector<Int> nested_quotients(operands.size(), Int("0"));
+    vector<Int> nested_remainders(operands.size(), Int("0"));
+    pool.run(operands.size(), [&](size_t a_i) {
+        const auto &[a, b] = operands[a_i];
+        nested_products[a_i] = a * b;
+        Int dividend = nested_products[a_i] + a;
+        nested_quotients[a_i] = dividend / b;
+        nested_remainders[a_i] = dividend % b;
+    });
+    parallel_settings = saved;
+
+    size_t mismatches = 0;
+    for (size_t i = 0; i < operands.size(); i++)
+    {
+        mismatches += nested_products[i] != products[i] || nested_quotients[i] != quotients[i] ||
+                      nested_remainders[i] != remainders[i];
+    }
+    check(mismatches == 0, "nested pool mul and divmod, " + std::to_string(mismatches) + " mismatches");
+}
+
+
+/**
+ * @brief Reduce an integer to the two's complement range of a_width limbs, as IntBatch arithmetic wraps.
+ */
+Int wrap_to_width(const Int &a_value, size_t a_width)
+{
+    Int modulus = pow(Int("2"), LIMB_BITS * a_width);
+    Int result = divmod(a_value, modulus, DivRounding::Floor).second;
+    return (result >= modulus / Int("2")) ? result - modulus : result;
+}
+
+/**
+ * @brief Check IntBatch arithmetic against Int arithmetic wrapped to the batch width, and compare, sum,
+ *      product and the range checks of set, for widths of 1 to 5 limbs and sizes that are not multiples of
+ *      BATCH_BLOCK, on the generic lane kernels and on those selected for this processor.
+ */
+void test_int_batch(std::mt19937_64 &a_rng)
+{
+    const LimbKernels selected = limb_kernels;
+    const Int one("1");
+    const Int two("2");
+    for (const LimbKernels &kernels : {GENERIC_LIMB_KERNELS, selected})
+    {
+        limb_kernels = kernels;
+        for (size_t width = 1; width <= 5; width++)
+        {
+            Int max = pow(two, LIMB_BITS * width - 1) - one;
+            Int min = -max - one;
+            for (size_t size : vector<size_t>{1, BATCH_BLOCK - 1, BATCH_BLOCK + 3})
+            {
+                vector<Int> values_1;
+                vector<Int> values_2;
+                for (size_t i = 0; i < size; i++)
+                {
+                    for (vector<Int> *values : {&values_1, &values_2})
+                    {
+                        Int value = make_operand(a_rng, width) / pow(two, 1 + i % 7);
+                        value = (a_rng() & 1) ? -value : value;
+                        // Put the extremes and equal pairs among the random values.
+                        switch (a_rng() % 8)
+                        {
+                        case 0:
+                            value = max;
+                            break;
+                        case 1:
+                            value = min;
+                            break;
+                        case 2:
+                            value = -one;
+                            break;
+                        case 3:
+                            value = values == &values_2 ? values_1[i] : value;
+                            break;
+                        }
+                        values->push_back(value);
+                    }
+                }
+                Int scalar = make_operand(a_rng, width) / two;
+                string what = string(kernels.name) + " kernels, " + std::to_string(size) + " elements of " +
+                              std::to_string(width) + " limbs";
+
+                IntBatch batch_1(values_1, width);
+                IntBatch batch_2(values_2, width);
+                check(batch_1.to_ints() == values_1, "batch round trip " + what);
+                vector<Int> sums = (batch_1 + batch_2).to_ints();
+                vector<Int> diffs = (batch_1 - batch_2).to_ints();
+                vector<Int> products = (batch_1 * batch_2).to_ints();
+                vector<Int> scalar_sums = (batch_1 + scalar).to_ints();
+                vector<Int> scalar_diffs = (batch_1 - scalar).to_ints();
+                vector<Int> scalar_products = (batch_1 * -scalar).to_ints();
+                IntBatch updated = batch_1;
+                updated += batch_2;
+                updated *= batch_2;
+                updated -= scalar;
+                vector<int8_t> order = compare(batch_1, batch_2);
+                bool ok = true;
+                bool ok_scalar = true;
+                bool ok_compare = true;
+                Int total("0");
+                Int all("1");
+                for (size_t i = 0; i < size; i++)
+                {
+                    const Int &x = values_1[i];
+                    const Int &y = values_2[i];
+                    ok = ok && sums[i] == wrap_to_width(x + y, width) && diffs[i] == wrap_to_width(x - y, width) &&
+                         products[i] == wrap_to_width(x * y, width) &&
+                         updated.get(i) == wrap_to_width((x + y) * y - scalar, width);
+                    ok_scalar = ok_scalar && scalar_sums[i] == wrap_to_width(x + scalar, width) &&
+                                scalar_diffs[i] == wrap_to_width(x - scalar, width) &&
+                                scalar_products[i] == wrap_to_width(x * -scalar, width);
+                    ok_compare = ok_compare && order[i] == (x < y ? -1 : x > y ? 1 : 0);
+                    total += x;
+                    all *= x;
+                }
+                check(ok, "batch operators " + what);
+                check(ok_scalar, "batch operators with an Int " + what);
+                check(ok_compare, "batch compare " + what);
+                check(sum(batch_1) == total, "batch sum " + what);
+                check(product(batch_1) == all, "batch product " + what);
+            }
+
+            IntBatch batch(3, width);
+            string what = std::to_string(width) + " limbs";
+            batch.set(0, min);
+            batch.set(1, max);
+            check(batch.get(0) == min && batch.get(1) == max, "batch set at the limits of " + what);
+            for (const Int &value : {max + one, min - one, pow(two, LIMB_BITS * width)})
+            {
+                bool threw = false;
+                try
+                {
+                    batch.set(2, value);
+                }
+                catch (const out_of_range &)
+                {
+                    threw = true;
+                }
+                check(threw, "batch set rejects " + value.to_str() + " for " + what);
+            }
+            bool threw = false;
+            try
+            {
+                batch.set(3, Int("0"));
+            }
+            catch (const out_of_range &)
+            {
+                threw = true;
+            }
+            check(threw, "batch set rejects an index past the end for " + what);
+        }
+    }
+    limb_kernels = selected;
+}
+
+/**
+ * @brief Serialize values back to back into one buffer and through a stream, read them back, check that
+ *      truncated data is rejected, and write them to an integer array file and map it.
+ */
+void test_serialize_round_trip(std::mt19937_64 &a_rng)
+{
+    vector<Int> values = sample_values(a_rng, {1, 4, 5, 100});
+
+    vector<uint8_t> buffer;
+    std::stringstream stream;
+    for (const Int &value : values)
+    {
+        vector<uint8_t> bytes = serialize(value);
+        check(bytes.size() == serialized_size(value), "serialized_size of " + value.to_str());
+        buffer.insert(buffer.end(), bytes.begin(), bytes.end());
+        serialize(value, stream);
+    }
+    size_t pos = 0;
+    for (const Int &value : values)
+    {
+        size_t consumed = 0;
+        Int read = deserialize(buffer.data() + pos, buffer.size() - pos, &consumed);
+        check(read == value && consumed == serialized_size(value), "deserialize buffer " + value.to_str());
+        pos += consumed;
+        check(deserialize(stream) == value, "deserialize stream " + value.to_str());
+    }
+    check(pos == buffer.size(), "deserialize consumes the whole buffer");
+
+    vector<uint8_t> bytes = serialize(values.back());
+    for (size_t len : vector<size_t>{0, SERIAL_HEADER_BYTES - 1, bytes.size() - 1})
+    {
+        bool threw = false;
+        try
+        {
+            deserialize(bytes.data(), len);
+        }
+        catch (const domain_error &)
+        {
+            threw = true;
+        }
+        check(threw, "deserialize rejects " + std::to_string(len) + " of " + std::to_string(bytes.size()) + " bytes");
+    }
+
+    const string path = "tests_int_array.bin";
+    write_int_array(path, values);
+    {
+        MappedIntArray mapped(path);
+        check(mapped.size() == values.size(), "mapped array size");
+        for (size_t i = 0; i < values.size() && i < mapped.size(); i++)
+        {
+            check(mapped.get(i) == values[i], "mapped array element " + std::to_string(i));
+        }
+    }
+    std::remove(path.c_str());
+}
+
+/**
+ * @brief Write values with to_chars in every radix into buffers of exactly digits_needed characters, read
+ *      them back with from_chars, and check the errors for a buffer one character short and for input
+ *      without digits.
+ */
+void test_chars_round_trip(std::mt19937_64 &a_rng)
+{
+    vector<Int> values = sample_values(a_rng, {1, 3, TO_STR_SCHOOLBOOK_LIMBS + 1, 300});
+    values.push_back(Int("-35"));
+    for (const Int &value : values)
+    {
+        for (int base = 2; base <= 36; base++)
+        {
+            string what = std::to_string(value.limbs.size()) + " limbs base " + std::to_string(base);
+            string text(value.digits_needed(base), '\0');
+            std::to_chars_result written = to_chars(text.data(), text.data() + text.size(), value, base);
+            check(written.ec == std::errc() && written.ptr == text.data() + text.size(), "to_chars " + what);
+
+            Int parsed("1");
+            text += '!';
+            std::from_chars_result read = from_chars(text.data(), text.data() + text.size(), parsed, base);
+            check(read.ec == std::errc() && read.ptr == text.data() + text.size() - 1 && parsed == value,
+                  "from_chars " + what);
+
+            written = to_chars(text.data(), text.data() + text.size() - 2, value, base);
+            check(written.ec == std::errc::value_too_large, "to_chars short buffer " + what);
+        }
+    }
+
+    Int unchanged("42");
+    string text = "-z";
+    std::from_chars_result read = from_chars(text.data(), text.data() + text.size(), unchanged, 10);
+    check(read.ec == std::errc::invalid_argument && read.ptr == text.data() && unchanged == Int("42"),
+          "from_chars without digits");
+    read = from_chars(text.data(), text.data() + text.size(), unchanged, 36);
+    check(read.ec == std::errc() && unchanged == Int("-35"), "from_chars base 36");
+
+    // Once a first conversion has warmed the scratch arena and the cached powers of ten, decimal
+    // to_chars and digits_needed stay off the heap, up to lengths whose splits use Burnikel-Ziegler.
+    for (size_t len : vector<size_t>{31, 100, 1000})
+    {
+        Int value = -make_operand(a_rng, len);
+        string buffer(value.digits_needed(10), '\0');
+        to_chars(buffer.data(), buffer.data() + buffer.size(), value);
+        size_t allocs = g_allocs;
+        size_t digits = value.digits_needed(10);
+        size_t digits_allocs = g_allocs - allocs;
+        std::to_chars_result written = to_chars(buffer.data(), buffer.data() + buffer.size(), value);
+        size_t to_chars_allocs = g_allocs - allocs - digits_allocs;
+        check(written.ec == std::errc() && written.ptr == buffer.data() + buffer.size() && digits == buffer.size(),
+              "to_chars " + std::to_string(len) + " limbs");
+        check(digits_allocs == 0 && to_chars_allocs == 0,
+              "warm digits_needed and to_chars do not allocate, " + std::to_string(len) + " limbs, " +
+                  std::to_string(digits_allocs) + " and " + std::to_string(to_chars_allocs) + " allocations");
+    }
+}
+
+#if defined(__cpp_lib_format)
+/**
+ * @brief Format zero, negative and multi-limb values with std::format in every presentation type, compare
+ *      with to_chars and with known digits, check fill, alignment, sign, prefix and zero padding against
+ *      the output std::format gives for built-in integers, and check that a bad format spec throws
+ *      format_error.
+ */
+void test_format(std::mt19937_64 &a_rng)
+{
+    auto chars = [](const Int &a_value, int a_base)
+    {
+        string text(a_value.digits_needed(a_base), '\0');
+        to_chars(text.data(), text.data() + text.size(), a_value, a_base);
+        return text;
+    };
+    vector<Int> values{Int("0"), Int("-255"), -make_operand(a_rng, 3),
+                       make_operand(a_rng, TO_STR_SCHOOLBOOK_LIMBS + 1)};
+    for (const Int &value : values)
+    {
+        string what = std::to_string(value.limbs.size()) + " limbs";
+        check(std::format("{}", value) == value.to_str() && std::format("{:d}", value) == value.to_str(),
+              "format {} " + what);
+        check(std::format("{:x}", value) == chars(value, 16), "format {:x} " + what);
+        check(std::format("{:b}", value) == chars(value, 2), "format {:b} " + what);
+        check(std::format("{:o}", value) == chars(value, 8), "format {:o} " + what);
+
+        string hex = chars(value, 16);
+        size_t width = hex.size() + 5;
+        check(std::format("{:*>" + std::to_string(width) + "x}", value) == "*****" + hex,
+              "format with a fill and a width " + what);
+    }
+    check(std::format("{} {:x} {:b} {:o}", Int("0"), Int("0"), Int("0"), Int("0")) == "0 0 0 0", "format zero");
+    check(std::format("{:x} {:b} {:o}", Int("-255"), Int("-5"), Int("-8")) == "-ff -101 -10", "format negative");
+    check(std::format("[{:x}]", Int("18446744073709551616")) == "[10000000000000000]", "format multi-limb");
+
+    // The standard format spec, with the results that std::format gives for the same built-in integers.
+    vector<std::pair<string, string>> specs = {
+        {"{:8}", "    -255"},     {"{:<8}", "-255    "},  {"{:^9}", "  -255   "},   {"{:*>8}", "****-255"},
+        {"{:0>8}", "0000-255"},   {"{:08}", "-0000255"},   {"{:+}", "-255"},        {"{:#x}", "-0xff"},
+        {"{:#X}", "-0XFF"},       {"{:X}", "-FF"},         {"{:#010x}", "-0x00000ff"}, {"{:#b}", "-0b11111111"},
+        {"{:#B}", "-0B11111111"}, {"{:#o}", "-0377"},      {"{:<#8x}", "-0xff   "},  {"{:2}", "-255"}};
+    for (const auto &[spec, expected] : specs)
+    {
+        Int value("-255");
+        check(std::vformat(spec, std::make_format_args(value)) == expected, "format spec " + spec);
+    }
+    check(std::format("{:+} {: } {:-} {:+}", Int("5"), Int("5"), Int("5"), Int("0")) == "+5  5 5 +0",
+          "format sign options");
+    check(std::format("{:#o} {:#x} {:#08b}", Int("0"), Int("0"), Int("5")) == "0 0x0 0b000101", "format prefixes");
+    check(std::format("{:é^7}", Int("42")) == "éé42ééé", "format with a UTF-8 fill");
+
+    for (const string &spec : vector<string>{"{:q}", "{:xd}", "{:.3}", "{:#0>+x}"})
+    {
+        bool threw = false;
+        try
+        {
+            Int value("5");
+            string text = std::vformat(spec, std::make_format_args(value));
+        }
+        catch (const std::format_error &)
+        {
+            threw = true;
+        }
+        check(threw, "format spec " + spec + " throws format_error");
+    }
+}
+#endif
+
+#if defined(BIGINT_INSTRUMENT)
+/**
+ * @brief Check the instrumentation counters: one known operation at a time, the calls, operand size
+ *      bucket and top-level tier it records, and that instrument_reset starts every counter from zero.
+ */
+void test_instrument(std::mt19937_64 &a_rng)
+{
+    auto is_zero = [](const InstrumentSnapshot &a_snapshot)
+    {
+        for (const InstrumentStats &stats : a_snapshot.ops)
+        {
+            bool empty = stats.calls == 0 && stats.nanoseconds == 0 && stats.bytes == 0;
+            for (uint64_t count : stats.sizes)
+            {
+                empty = empty && count == 0;
+            }
+            for (uint64_t count : stats.tiers)
+            {
+                empty = empty && count == 0;
+            }
+            if (!empty)
+            {
+                return false;
+            }
+        }
+        return true;
+    };
+    auto bucket = [](size_t a_limbs) { return std::min<size_t>(std::bit_width(a_limbs), INSTRUMENT_SIZE_BUCKETS - 1); };
+
+    check(!is_zero(instrument_snapshot()), "instrument counted the earlier tests");
+    instrument_reset();
+    check(is_zero(instrument_snapshot()), "instrument_reset zeroes the counters");
+
+    vector<std::pair<size_t, InstrumentTier>> mul_cases = {
+        {2, InstrumentTier::Basecase},
+        {mul_thresholds.karatsuba + 5, InstrumentTier::Karatsuba},
+        {mul_thresholds.toom3 + 5, InstrumentTier::Toom3},
+        {mul_thresholds.ntt + 5, InstrumentTier::Ntt},
+    };
+    for (auto [len, tier] : mul_cases)
+    {
+        Int a = make_operand(a_rng, len);
+        Int b = make_operand(a_rng, len);
+        instrument_reset();
+        Int r = a * b;
+        InstrumentSnapshot snapshot = instrument_snapshot();
+        const InstrumentStats &mul = snapshot[InstrumentOp::Mul];
+        check(mul.calls == 1 && mul.tiers[(size_t)tier] == 1 && mul.sizes[bucket(len)] == 1,
+              "instrument one mul of " + std::to_string(len) + " limbs at " + INSTRUMENT_TIER_NAMES[(size_t)tier]);
+        check(snapshot[InstrumentOp::Div].calls == 0 && snapshot[InstrumentOp::Add].calls == 0,
+              "instrument counts nothing else for a mul of " + std::to_string(len) + " limbs");
+    }
+
+    size_t bz_len = div_thresholds.burnikel_ziegler + 5;
+    vector<std::tuple<size_t, size_t, InstrumentTier>> div_cases = {
+        {5, 2, InstrumentTier::Basecase},
+        {2 * bz_len, bz_len, InstrumentTier::DivideAndConquer},
+    };
+    for (auto [dvd_len, dvs_len, tier] : div_cases)
+    {
+        Int dvd = make_operand(a_rng, dvd_len);
+        Int dvs = make_operand(a_rng, dvs_len);
+        instrument_reset();
+        Int q = dvd / dvs;
+        InstrumentSnapshot snapshot = instrument_snapshot();
+        const InstrumentStats &div = snapshot[InstrumentOp::Div];
+        // Burnikel-Ziegler divides the pieces on limb arrays, so the division counts once.
+        check(div.calls == 1 && div.tiers[(size_t)tier] == 1 && div.sizes[bucket(dvd_len)] == 1,
+              "instrument a div of " + std::to_string(dvd_len) + " limbs at " + INSTRUMENT_TIER_NAMES[(size_t)tier]);
+    }
+
+    vector<std::pair<size_t, InstrumentTier>> to_str_cases = {
+        {3, InstrumentTier::Basecase},
+        {4 * TO_STR_SCHOOLBOOK_LIMBS, InstrumentTier::DivideAndConquer},
+    };
+    for (auto [len, tier] : to_str_cases)
+    {
+        Int a = make_operand(a_rng, len);
+        instrument_reset();
+        string text = a.to_str();
+        InstrumentSnapshot snapshot = instrument_snapshot();
+        const InstrumentStats &to_str = snapshot[InstrumentOp::ToStr];
+        check(to_str.calls == 1 && to_str.tiers[(size_t)tier] == 1 && to_str.sizes[bucket(len)] == 1,
+              "instrument one to_str of " + std::to_string(len) + " limbs at " + INSTRUMENT_TIER_NAMES[(size_t)tier]);
+        instrument_reset();
+        Int parsed(text);
+        snapshot = instrument_snapshot();
+        check(snapshot[InstrumentOp::Parse].calls == 1 && snapshot[InstrumentOp::ToStr].calls == 0,
+              "instrument one parse of " + std::to_string(len) + " limbs");
+    }
+
+    Int a = make_operand(a_rng, 3);
+    Int b = make_operand(a_rng, 2);
+    instrument_reset();
+    a += b;
+    a -= b;
+    a -= b;
+    InstrumentSnapshot snapshot = instrument_snapshot();
+    check(snapshot[InstrumentOp::Add].calls == 1 && snapshot[InstrumentOp::Sub].calls == 2 &&
+              snapshot[InstrumentOp::Add].sizes[bucket(3)] == 1,
+          "instrument counts additions and subtractions");
+    instrument_reset();
+    check(is_zero(instrument_snapshot()), "instrument_reset zeroes the counters again");
+}
+
+#endif
+
+/**
+ * @brief Check that zero is positive however it comes about, including in an Int whose value was moved
+ *      out, and that compare and the comparison operators order values of every sign and length as the
+ *      sign of their difference does.
+ */
+void test_normal_form(std::mt19937_64 &a_rng)
+{
+    auto is_zero = [](const Int &a_value) { return a_value.limbs.empty() && a_value.is_positive; };
+    Int a = -make_operand(a_rng, 3);
+    for (const Int &source : {Int("-5"), a})
+    {
+        string what = std::to_string(source.limbs.size()) + "-limb negative value";
+        Int moved = source;
+        Int taken(std::move(moved));
+        check(taken == source && is_zero(moved), "move construction leaves zero from a " + what);
+        moved = source;
+        Int assigned("7");
+        assigned = std::move(moved);
+        check(assigned == source && is_zero(moved), "move assignment leaves zero from a " + what);
+        assigned = std::move(assigned);
+        check(assigned == source, "move assignment to itself keeps a " + what);
+    }
+
+    Int updated = a;
+    updated -= a;
+    check(is_zero(a - a) && is_zero(updated), "zero from subtraction");
+    check(is_zero(-Int("0")) && is_zero(-a + a) && is_zero(-(a - a)), "zero from negation");
+    check(is_zero(a * Int("0")) && is_zero(Int("0") * a), "zero from multiplication");
+    check(is_zero(Int("-3") / a) && is_zero(a % -a) && is_zero(Int("-6") % Int("3")), "zero from division");
+    check(is_zero(Int("-0")) && is_zero(Int("-000")), "zero from parsing");
+
+    vector<Int> values = sample_values(a_rng, {1, 2, 5});
+    values.push_back(values.back() + Int("1"));
+    values.push_back(-values.back());
+    values.push_back(values[values.size() - 4] - Int("1"));
+    for (const Int &x : values)
+    {
+        for (const Int &y : values)
+        {
+            Int diff = x - y;
+            int expected = diff.limbs.empty() ? 0 : (diff.is_positive ? 1 : -1);
+            string what = x.to_str() + " and " + y.to_str();
+            strong_ordering order = x.compare(y);
+            check((order < 0) == (expected < 0) && (order == 0) == (expected == 0), "compare " + what);
+            check((x < y) == (expected < 0) && (x <= y) == (expected <= 0) && (x > y) == (expected > 0) &&
+                      (x >= y) == (expected >= 0) && (x == y) == (expected == 0) && (x != y) == (expected != 0),
+                  "comparison operators " + what);
+        }
+    }
+}
+
+/**
+ * @brief Check the two's complement bitwise operators and the shifts against arithmetic identities, for
+ *      every combination of signs and operands of different lengths.
+ */
+void test_bitwise(std::mt19937_64 &a_rng)
+{
+    for (size_t len_1 : vector<size_t>{1, 2, 9})
+    {
+        for (size_t len_2 : vector<size_t>{1, 5})
+        {
+            for (int signs = 0; signs < 4; signs++)
+            {
+                Int a = make_operand(a_rng, len_1, signs == 3);
+                Int b = make_operand(a_rng, len_2);
+                a = (signs & 1) ? -a : a;
+                b = (signs & 2) ? -b : b;
+                string what = std::to_string(len_1) + " and " + std::to_string(len_2) + " limbs, signs " +
+                              std::to_string(signs);
+                check((a & b) + (a | b) == a + b, "and plus or " + what);
+                check((a ^ b) == (a | b) - (a & b), "xor " + what);
+                check(~a == -a - Int("1"), "not " + what);
+                for (size_t shift : vector<size_t>{0, 1, 63, 64, 65, 200})
+                {
+                    Int power = Int("1") << shift;
+                    check((a << shift) == a * power, "shift left " + std::to_string(shift) + " " + what);
+                    check((a >> shift) == divmod(a, power, DivRounding::Floor).first,
+                          "shift right " + std::to_string(shift) + " " + what);
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Square with every algorithm and compare with the schoolbook product of two distinct copies, on
+ *      both sides of the squaring thresholds and of mul_thresholds.ntt.
+ */
+void test_sqr_tiers(std::mt19937_64 &a_rng)
+{
+    vector<size_t> lengths;
+    for (size_t threshold : {mul_thresholds.sqr_karatsuba, mul_thresholds.sqr_toom3, mul_thresholds.ntt})
+    {
+        lengths.insert(lengths.end(), {threshold - 1, threshold, threshold + 1});
+    }
+    for (size_t len : lengths)
+    {
+        for (bool ones : {false, true})
+        {
+            Int a = make_operand(a_rng, len, ones);
+            Int copy = a;
+            Int expected = mul(a, copy, MulAlgorithm::Schoolbook);
+            string what = std::to_string(len) + (ones ? " ones" : " random");
+            check(square(a) == expected, "square " + what);
+            check(a * a == expected, "a * a " + what);
+            check(square(-a) == expected, "square negative " + what);
+            for (MulAlgorithm algorithm : {MulAlgorithm::Schoolbook, MulAlgorithm::Karatsuba, MulAlgorithm::Toom3,
+                                           MulAlgorithm::Ntt})
+            {
+                check(mul(a, a, algorithm) == expected, "square forced " + std::to_string((int)algorithm) + " " + what);
+            }
+        }
+    }
+}
+
+
+/**
+ * @brief Check the operators that take one built-in integer against the same operators on an Int made
+ *      from it, with the built-in integer on either side, and the range checks of fits_in.
+ */
+template <BuiltinInteger T>
+void check_builtin_ops(const Int &a_value, T a_builtin, const string &a_what)
+{
+    Int wide(a_builtin);
+    check(a_value + a_builtin == a_value + wide && a_builtin + a_value == wide + a_value, "+ " + a_what);
+    check(a_value - a_builtin == a_value - wide && a_builtin - a_value == wide - a_value, "- " + a_what);
+    check(a_value * a_builtin == a_value * wide && a_builtin * a_value == wide * a_value, "* " + a_what);
+    check((a_value == a_builtin) == (a_value == wide) && (a_value < a_builtin) == (a_value < wide),
+          "comparison " + a_what);
+    Int updated = a_value;
+    updated += a_builtin;
+    updated *= a_builtin;
+    updated -= a_builtin;
+    check(updated == (a_value + wide) * wide - wide, "compound " + a_what);
+    if (a_builtin != 0)
+    {
+        check(a_value / a_builtin == a_value / wide && a_value % a_builtin == a_value % wide, "/ and % " + a_what);
+        updated = a_value;
+        updated /= a_builtin;
+        check(updated == a_value / wide, "/= " + a_what);
+        updated = a_value;
+        updated %= a_builtin;
+        check(updated == a_value % wide, "%= " + a_what);
+    }
+    check(wide.fits_in<T>() && (wide + Int(1)).fits_in<T>() == (a_builtin != std::numeric_limits<T>::max()),
+          "fits_in " + a_what);
+}
+
+/**
+ * @brief Run check_builtin_ops on short and long values of both signs, with built-in integers of every
+ *      width at and near their limits.
+ */
+void test_builtin_ops(std::mt19937_64 &a_rng)
+{
+    vector<Int> values = sample_values(a_rng, {1, 2, 3, 40});
+    for (const Int &value : values)
+    {
+        string what = "with " + value.to_str();
+        check_builtin_ops(value, (int)-7, what + " and int");
+        check_builtin_ops(value, (short)0, what + " and short 0");
+        check_builtin_ops(value, std::numeric_limits<unsigned>::max(), what + " and unsigned max");
+        check_builtin_ops(value, std::numeric_limits<int64_t>::min(), what + " and int64_t min");
+        check_builtin_ops(value, std::numeric_limits<uint64_t>::max(), what + " and uint64_t max");
+        check_builtin_ops(value, std::numeric_limits<__int128>::min() + 5, what + " and __int128");
+        check_builtin_ops(value, std::numeric_limits<unsigned __int128>::max(), what + " and unsigned __int128");
+    }
+    check(Int(std::numeric_limits<int64_t>::min()).to_int64() == std::numeric_limits<int64_t>::min(), "to_int64");
+    check(!(Int(std::numeric_limits<int64_t>::max()) + 1).fits_in<int64_t>(), "fits_in past int64_t max");
+}
+
+/**
+ * @brief Compare Divider with divmod for divisors on both sides of div_thresholds.barrett, with a full or
+ *      short top limb, dividends shorter and much longer than the divisor and both signs, then compare
+ *      Reducer with operator% for odd moduli, reduced with Montgomery multiplication below the threshold,
+ *      and even ones.
+ */
+void test_divider_reducer(std::mt19937_64 &a_rng)
+{
+    size_t threshold = div_thresholds.barrett;
+    for (size_t dvs_len : vector<size_t>{1, 2, threshold - 1, threshold, threshold + 1, 2 * threshold + 5})
+    {
+        for (const string &kind : vector<string>{"random", "short top", "power"})
+        {
+            for (bool negative : {false, true})
+            {
+                Int b = (kind == "random") ? make_operand(a_rng, dvs_len)
+                                           : make_short_top_operand(a_rng, dvs_len, kind == "power");
+                b = negative ? -b : b;
+                Divider divider(b);
+                for (size_t dvd_len : vector<size_t>{dvs_len / 2, dvs_len, dvs_len + 1, 3 * dvs_len + 2})
+                {
+                    for (bool ones : {false, true})
+                    {
+                        Int a = make_operand(a_rng, dvd_len, ones);
+                        a = ones ? -a : a;
+                        string what = std::to_string(dvd_len) + "/" + std::to_string(dvs_len) + " " + kind +
+                                      (negative ? " negative" : "") + (ones ? " ones" : " random");
+                        check(divider.divmod(a) == divmod(a, b), "divider trunc " + what);
+                        check(divider.divmod(a, DivRounding::Floor) == divmod(a, b, DivRounding::Floor),
+                              "divider floor " + what);
+                        check(divider.quotient(a) == a / b && divider.remainder(a) == a % b,
+                              "divider quotient and remainder " + what);
+                    }
+                }
+            }
+        }
+    }
+
+    for (size_t mod_len : vector<size_t>{1, 2, threshold - 1, threshold + 1})
+    {
+        for (bool odd : {true, false})
+        {
+            Int mod = make_operand(a_rng, mod_len);
+            mod = odd ? (mod | Int(1)) : (mod & Int(-2));
+            Reducer reducer(-mod);
+            string what = std::to_string(mod_len) + "-limb " + (odd ? "odd" : "even") + " modulus";
+            Int a = -make_operand(a_rng, 2 * mod_len + 1);
+            Int b = make_operand(a_rng, mod_len);
+            Int a_mod = divmod(a, mod, DivRounding::Floor).second;
+            Int b_mod = b % mod;
+            check(reducer.mod(a) == a_mod, "reducer mod " + what);
+            check(reducer.mulmod(a_mod, b_mod) == a_mod * b_mod % mod, "reducer mulmod " + what);
+
+            Int x = reducer.to_domain(a);
+            Int y = reducer.to_domain(b);
+            check(reducer.from_domain(reducer.mul(x, y)) == a_mod * b_mod % mod, "reducer domain mul " + what);
+            check(reducer.from_domain(reducer.add(x, y)) == (a_mod + b_mod) % mod, "reducer domain add " + what);
+            check(reducer.from_domain(reducer.sub(x, y)) == divmod(a_mod - b_mod, mod, DivRounding::Floor).second,
+                  "reducer domain sub " + what);
+        }
+    }
+}
+
+/**
+ * @brief Return the greatest common divisor the slow way, with Euclid's algorithm on operator%.
+ */
+Int slow_gcd(Int a_opr_1, Int a_opr_2)
+{
+    a_opr_1 = abs(a_opr_1);
+    a_opr_2 = abs(a_opr_2);
+    while (a_opr_2 != 0)
+    {
+        a_opr_1 %= a_opr_2;
+        std::swap(a_opr_1, a_opr_2);
+    }
+    return a_opr_1;
+}
+
+/**
+ * @brief Compare gcd with Euclid's algorithm and with Lehmer steps alone, on operands with a common factor
+ *      on both sides of gcd_thresholds.half_gcd, and check xgcd's identity a s + b t = g, lcm, and modinv.
+ */
+void test_gcd(std::mt19937_64 &a_rng)
+{
+    size_t threshold = gcd_thresholds.half_gcd;
+    vector<std::pair<size_t, size_t>> lengths = {
+        {0, 3}, {1, 1}, {2, 1}, {2, 2}, {5, 40}, {threshold - 1, threshold - 1}, {threshold, threshold},
+        {threshold + 1, threshold + 1}, {2 * threshold, threshold + 3}, {700, 690}};
+    for (auto [len_1, len_2] : lengths)
+    {
+        for (size_t common_len : vector<size_t>{0, 1, 30})
+        {
+            Int common = common_len == 0 ? Int(1) : make_operand(a_rng, common_len);
+            Int a = make_operand(a_rng, len_1) * common;
+            Int b = -make_operand(a_rng, len_2) * common;
+            string what = std::to_string(len_1) + " and " + std::to_string(len_2) + " limbs, common factor of " +
+                          std::to_string(common_len);
+
+            Int g = gcd(a, b);
+            check(g == slow_gcd(a, b), "gcd against euclid " + what);
+            check(a == 0 || g % common == 0, "gcd holds the common factor " + what);
+            size_t saved = gcd_thresholds.half_gcd;
+            gcd_thresholds.half_gcd = SIZE_MAX;
+            check(gcd(a, b) == g, "half-gcd against lehmer " + what);
+            gcd_thresholds.half_gcd = saved;
+
+            auto [g_x, s, t] = xgcd(a, b);
+            check(g_x == g && a * s + b * t == g, "xgcd identity " + what);
+            check(a == 0 || (abs(s) <= abs(b) && abs(t) <= abs(a)), "xgcd cofactor bounds " + what);
+            check(g == 0 || lcm(a, b) * g == abs(a * b), "lcm " + what);
+
+            if (g == 1 && abs(b) > 1)
+            {
+                Int inverse = modinv(a, b);
+                check(inverse >= 0 && inverse < abs(b) && a * inverse % abs(b) == 1,
+                      "modinv " + what);
+            }
+            else if (g > 1)
+            {
+                bool threw = false;
+                try
+                {
+                    modinv(a, b);
+                }
+                catch (const domain_error &)
+                {
+                    threw = true;
+                }
+                check(threw, "modinv without an inverse throws " + what);
+            }
+        }
+    }
+    check(gcd(Int(0), Int(0)) == 0 && lcm(Int(0), Int(5)) == 0, "gcd and lcm of zero");
+}
+
+int main()
+{
+    std::mt19937_64 rng(20231228);
+    test_limb_arithmetic(rng);
+    test_decimal_round_trip(rng);
+    test_parse(rng);
+    test_mul_tiers(rng);
+    test_mul_ntt(rng);
+    test_div_tiers(rng);
+    test_powmod(rng);
+    test_limb_vector(rng);
+    test_aliasing(rng);
+    test_lazy(rng);
+    test_arena(rng);
+    test_limb_kernels(rng);
+    test_parallel(rng);
+    test_parallel_nested(rng);
+    test_int_batch(rng);
+    test_serialize_round_trip(rng);
+    test_chars_round_trip(rng);
+#if defined(__cpp_lib_format)
+    test_format(rng);
+#endif
+    test_normal_form(rng);
+    test_bitwise(rng);
+    test_sqr_tiers(rng);
+    test_builtin_ops(rng);
+    test_divider_reducer(rng);
+    test_gcd(rng);
+#if defined(BIGINT_INSTRUMENT)
+    test_instrument(rng);
+#endif
+
+    cout << g_checks - g_failures << " of " << g_checks << " checks passed\n";
+    return g_failures == 0 ? 0 : 1;
+}